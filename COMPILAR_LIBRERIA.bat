@@ -0,0 +1,29 @@
+@echo off
+REM Generar con SWIG y compilar la libreria de Python (_parking.pyd)
+REM parking_wrap.cxx y parking.py no se guardan en el repositorio: se
+REM regeneran aqui desde parking.i cada vez, asi nunca quedan desfasados
+
+cd /d "%~dp0"
+
+echo [1/2] Generando parking_wrap.cxx y parking.py con SWIG...
+swig -c++ -python parking.i
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Fallo SWIG ^(esta en el PATH?^)
+    exit /b 1
+)
+
+FOR /F "tokens=*" %%i IN ('python -c "import sys; print(sys.prefix)"') DO SET PYTHON_PREFIX=%%i
+FOR /F "tokens=*" %%i IN ('python -c "import sys; print(sys.version_info.major)"') DO SET PYTHON_MAJOR=%%i
+FOR /F "tokens=*" %%i IN ('python -c "import sys; print(sys.version_info.minor)"') DO SET PYTHON_MINOR=%%i
+
+echo [2/2] Compilando _parking.pyd...
+cl /LD /EHsc /std:c++17 ^
+   /I"%PYTHON_PREFIX%\include" ^
+   parking_lib.cpp plate_codec.cpp parking_wrap.cxx ^
+   /link /LIBPATH:"%PYTHON_PREFIX%\libs" python%PYTHON_MAJOR%%PYTHON_MINOR%.lib ^
+   /OUT:_parking.pyd
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Fallo al compilar _parking.pyd
+    exit /b 1
+)
+echo      ✓ _parking.pyd
@@ -1,46 +1,54 @@
-@echo off
-REM Recompilar cliente y servidor con timestamps
-
-echo.
-echo ================================================
-echo   RECOMPILANDO CON TIMESTAMPS
-echo ================================================
-echo.
-
-cd /d "%~dp0"
-
-echo [1/2] Compilando servidor_multicliente.cpp...
-cl /EHsc servidor_multicliente.cpp /Fe:servidor_multicliente.exe /link ws2_32.lib
-if %ERRORLEVEL% NEQ 0 (
-    echo ERROR: Fallo al compilar servidor
-    pause
-    exit /b 1
-)
-echo      ✓ servidor_multicliente.exe
-
-echo.
-echo [2/2] Compilando cliente.cpp...
-cl cliente.cpp /Fe:cliente.exe /link ws2_32.lib
-if %ERRORLEVEL% NEQ 0 (
-    echo ERROR: Fallo al compilar cliente
-    pause
-    exit /b 1
-)
-echo      ✓ cliente.exe
-
-echo.
-echo ================================================
-echo   ✓ COMPILACION COMPLETA
-echo ================================================
-echo.
-echo AHORA el cliente envia:
-echo   - Numero de plaza (1-40)
-echo   - Placa del vehiculo (AAA000)
-echo   - Timestamp (YYYY-MM-DD HH:MM:SS)
-echo.
-echo Ejecuta en orden:
-echo   1. servidor_multicliente.exe
-echo   2. python main.py
-echo   3. cliente.exe
-echo.
-pause
+@echo off
+REM Recompilar cliente y servidor con timestamps
+
+echo.
+echo ================================================
+echo   RECOMPILANDO CON TIMESTAMPS
+echo ================================================
+echo.
+
+cd /d "%~dp0"
+
+echo [1/3] Generando y compilando la libreria de Python...
+call COMPILAR_LIBRERIA.bat
+if %ERRORLEVEL% NEQ 0 (
+    pause
+    exit /b 1
+)
+
+echo.
+echo [2/3] Compilando servidor_multicliente.cpp...
+cl /EHsc /std:c++17 servidor_multicliente.cpp parking_protocol.cpp parking_lib.cpp plate_codec.cpp framing.cpp async_log.cpp broadcaster.cpp binary_protocol.cpp trace_recorder.cpp state_actor.cpp worker_pool.cpp wal.cpp /Fe:servidor_multicliente.exe /link ws2_32.lib
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Fallo al compilar servidor
+    pause
+    exit /b 1
+)
+echo      ✓ servidor_multicliente.exe
+
+echo.
+echo [3/3] Compilando cliente.cpp...
+cl /EHsc /std:c++17 cliente.cpp load_generator.cpp latency_histogram.cpp workload_model.cpp trace_replay.cpp binary_protocol.cpp plate_codec.cpp /Fe:cliente.exe /link ws2_32.lib
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Fallo al compilar cliente
+    pause
+    exit /b 1
+)
+echo      ✓ cliente.exe
+
+echo.
+echo ================================================
+echo   ✓ COMPILACION COMPLETA
+echo ================================================
+echo.
+echo AHORA el cliente envia:
+echo   - Numero de plaza (1-40)
+echo   - Placa del vehiculo (AAA000)
+echo   - Timestamp (YYYY-MM-DD HH:MM:SS)
+echo.
+echo Ejecuta en orden:
+echo   1. servidor_multicliente.exe
+echo   2. python main.py
+echo   3. cliente.exe
+echo.
+pause
@@ -0,0 +1,270 @@
+#include "async_log.h"
+#include "mpsc_queue.h"
+#include "parking_protocol.h"
+#include "plate_codec.h"
+#include "wal.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+
+using namespace std;
+
+enum LogEventType : uint8_t {
+    LOG_ENTRY,
+    LOG_EXIT,
+    LOG_CONNECTED,
+    LOG_DISCONNECTED,
+    LOG_WARNING
+};
+
+// Registro compacto: se copia a la cola tal cual, sin formato
+struct LogEvent {
+    LogEventType type;
+    int32_t spot;
+    int64_t client;
+    uint64_t sequence;     // Secuencia del evento (entradas y salidas)
+    char plate[8];
+    char timestamp[20];    // "YYYY-MM-DD HH:MM:SS"
+    const char* reason;    // Cadena estática
+};
+
+static MpscQueue<LogEvent>* queue = nullptr;
+static atomic<bool> running(false);
+static atomic<unsigned long long> dropped(0);
+static thread writerThread;
+
+// El hilo de fondo duerme aquí cuando la cola está vacía
+static mutex idleLock;
+static condition_variable idleWake;
+static atomic<bool> idle(false);
+
+// Estado espejo de las plazas, reconstruido a partir de los eventos.
+// Solo lo toca el hilo de fondo, así la tabla no necesita los locks de las
+// zonas. Si se descartan eventos se vuelve a tomar del estado real
+// (resyncMirror); los eventos hasta mirrorSequence ya están incluidos
+static vector<string> mirror;
+static unsigned long long mirrorSequence = 0;
+static int statusInterval = 0;
+
+static void copyField(char* dest, size_t size, const char* src) {
+    if (src == nullptr) {
+        dest[0] = '\0';
+        return;
+    }
+    strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+}
+
+static void enqueue(const LogEvent& ev) {
+    if (!running.load(memory_order_relaxed)) return;
+    if (!queue->push(ev)) {
+        dropped.fetch_add(1, memory_order_relaxed);
+    }
+
+    // Despertar al hilo de fondo si se durmió. Quien encola mira "idle"
+    // después de su push y el hilo mira la cola después de marcar "idle":
+    // al menos uno de los dos ve al otro
+    atomic_thread_fence(memory_order_seq_cst);
+    if (idle.load(memory_order_relaxed)) {
+        lock_guard<mutex> guard(idleLock);
+        idleWake.notify_one();
+    }
+}
+
+void logEntry(int spotIndex, const char* plate, const char* timestamp, unsigned long long sequence) {
+    LogEvent ev;
+    ev.type = LOG_ENTRY;
+    ev.spot = spotIndex;
+    ev.client = 0;
+    ev.sequence = sequence;
+    copyField(ev.plate, sizeof(ev.plate), plate);
+    copyField(ev.timestamp, sizeof(ev.timestamp), timestamp);
+    ev.reason = nullptr;
+    enqueue(ev);
+}
+
+void logExit(int spotIndex, const char* plate, const char* timestamp, unsigned long long sequence) {
+    LogEvent ev;
+    ev.type = LOG_EXIT;
+    ev.spot = spotIndex;
+    ev.client = 0;
+    ev.sequence = sequence;
+    copyField(ev.plate, sizeof(ev.plate), plate);
+    copyField(ev.timestamp, sizeof(ev.timestamp), timestamp);
+    ev.reason = nullptr;
+    enqueue(ev);
+}
+
+static void logClient(LogEventType type, long long client, const char* reason) {
+    LogEvent ev;
+    ev.type = type;
+    ev.spot = -1;
+    ev.client = client;
+    ev.sequence = 0;
+    ev.plate[0] = '\0';
+    ev.timestamp[0] = '\0';
+    ev.reason = reason;
+    enqueue(ev);
+}
+
+void logClientConnected(long long client) {
+    logClient(LOG_CONNECTED, client, nullptr);
+}
+
+void logClientDisconnected(long long client) {
+    logClient(LOG_DISCONNECTED, client, nullptr);
+}
+
+void logWarning(long long client, const char* reason) {
+    logClient(LOG_WARNING, client, reason);
+}
+
+unsigned long long droppedLogEvents() {
+    return dropped.load(memory_order_relaxed);
+}
+
+// ============================================================================
+// HILO DE FONDO: da formato a los eventos y escribe por bloques
+// ============================================================================
+static void formatEvent(const LogEvent& ev, string& out) {
+    switch (ev.type) {
+    case LOG_ENTRY:
+    case LOG_EXIT:
+        out += (ev.type == LOG_ENTRY) ? "[+] ENTRADA: Plaza " : "[-] SALIDA:  Plaza ";
+        out += to_string(ev.spot + 1);
+        out += " | ";
+        out += ev.plate;
+        if (ev.timestamp[0]) {
+            out += " | ";
+            out += ev.timestamp;
+        }
+        out += '\n';
+        if (ev.spot >= 0 && ev.sequence > mirrorSequence) {
+            if ((size_t)ev.spot >= mirror.size()) mirror.resize((size_t)ev.spot + 1);
+            mirror[(size_t)ev.spot] = (ev.type == LOG_ENTRY) ? ev.plate : "";
+        }
+        break;
+    case LOG_CONNECTED:
+        out += "[+] Nuevo cliente conectado (Socket: " + to_string(ev.client) + ")\n";
+        break;
+    case LOG_DISCONNECTED:
+        out += "[-] Cliente " + to_string(ev.client) + " desconectado\n";
+        break;
+    case LOG_WARNING:
+        out += "⚠ Cliente " + to_string(ev.client) + ": " + ev.reason + "\n";
+        break;
+    }
+}
+
+// Toma el espejo del estado real (todas las zonas bloqueadas un momento).
+// Se llama sin ningún lock del log: quien encola puede tener una zona tomada
+static void resyncMirror() {
+    vector<WalRecord> records;
+    mirrorSequence = collectParkedVehicles(records);
+    mirror.assign((size_t)records[0].spot, string());
+
+    char plate[PLATE_RECORD_SIZE];
+    for (size_t i = 1; i < records.size(); i++) {
+        decodePlate(records[i].plateCode, plate);
+        mirror[(size_t)records[i].spot] = plate;
+    }
+}
+
+static void formatStatus(string& out) {
+    out += "\n---[ ESTADO DEL PARKING ]---\n";
+    for (size_t i = 0; i < mirror.size(); i++) {
+        out += " Plaza " + to_string(i + 1) + ": ";
+        out += mirror[i].empty() ? "[ VACIO ]" : "[ " + mirror[i] + " ]";
+        out += '\n';
+    }
+    out += "----------------------------------\n\n";
+}
+
+static void writerLoop() {
+    string out;
+    LogEvent ev;
+    bool changed = false;
+    unsigned long long reportedDrops = 0;
+    auto lastStatus = chrono::steady_clock::now();
+
+    while (true) {
+        bool stopping = !running.load(memory_order_acquire);
+
+        // Vaciar todo lo pendiente y escribirlo de una sola vez
+        out.clear();
+        while (queue->pop(ev)) {
+            formatEvent(ev, out);
+            changed = changed || ev.type == LOG_ENTRY || ev.type == LOG_EXIT;
+        }
+
+        // Un evento descartado ya no llega al espejo: se vuelve a tomar
+        // del estado. Lo que siga en la cola y sea anterior a la toma solo
+        // se imprime (formatEvent compara con mirrorSequence)
+        unsigned long long drops = dropped.load(memory_order_relaxed);
+        if (drops != reportedDrops) {
+            out += "⚠ Log saturado: " + to_string(drops - reportedDrops) + " eventos descartados\n";
+            reportedDrops = drops;
+            resyncMirror();
+            changed = true;
+        }
+
+        auto now = chrono::steady_clock::now();
+        auto nextStatus = lastStatus + chrono::milliseconds(statusInterval);
+        bool statusPending = changed && statusInterval > 0;
+        if (statusPending && now >= nextStatus) {
+            formatStatus(out);
+            changed = false;
+            statusPending = false;
+            lastStatus = now;
+        }
+
+        if (!out.empty()) {
+            cout.write(out.data(), (streamsize)out.size());
+            cout.flush();
+        }
+
+        if (stopping) break;
+
+        // Dormir hasta el próximo evento, o hasta que toque la tabla
+        unique_lock<mutex> guard(idleLock);
+        idle.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (queue->empty() && dropped.load(memory_order_relaxed) == reportedDrops
+            && running.load(memory_order_acquire)) {
+            if (statusPending) {
+                idleWake.wait_until(guard, nextStatus);
+            } else {
+                idleWake.wait(guard);
+            }
+        }
+        idle.store(false, memory_order_relaxed);
+    }
+}
+
+void startAsyncLog(int statusIntervalMs) {
+    if (running.load()) return;
+    if (queue == nullptr) {
+        queue = new MpscQueue<LogEvent>(LOG_QUEUE_CAPACITY);
+    }
+    // El espejo parte del estado actual: incluye lo recuperado del WAL
+    resyncMirror();
+    statusInterval = statusIntervalMs;
+    running.store(true, memory_order_release);
+    writerThread = thread(writerLoop);
+}
+
+void stopAsyncLog() {
+    if (!running.exchange(false)) return;
+    {
+        lock_guard<mutex> guard(idleLock);
+        idleWake.notify_one();
+    }
+    writerThread.join();
+}
@@ -0,0 +1,51 @@
+// ============================================================================
+// ARCHIVO: async_log.h
+// PROPÓSITO: Registro asíncrono de eventos del servidor
+// DESCRIPCIÓN: Escribir en consola mientras se tiene una zona bloqueada serializa
+//              a todos los clientes detrás de la terminal. Los hilos del
+//              servidor solo encolan registros binarios pequeños en una
+//              cola sin locks (ver mpsc_queue.h); un hilo de fondo les da
+//              formato y los escribe (duerme mientras la cola está vacía).
+//              La tabla completa de plazas se imprime cada cierto
+//              intervalo, no en cada evento.
+// ============================================================================
+
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+// Capacidad de la cola de eventos (si se llena, los eventos se descartan
+// y se cuentan; el servidor nunca espera al log). Tras un descarte la tabla
+// se vuelve a tomar del estado del parqueadero
+#define LOG_QUEUE_CAPACITY 65536
+
+// ============================================================================
+// FUNCIÓN: startAsyncLog
+// PROPÓSITO: Arranca el hilo de fondo. La tabla parte del estado actual,
+//            así que va después de initParkingState y de recoverWal
+// PARÁMETROS:
+//   - statusIntervalMs: Cada cuánto imprimir la tabla si hubo cambios
+//                       (0 = nunca)
+// ============================================================================
+void startAsyncLog(int statusIntervalMs);
+
+// Vacía la cola y detiene el hilo de fondo
+void stopAsyncLog();
+
+// ============================================================================
+// FUNCIONES DEL CAMINO CRÍTICO: no bloquean ni reservan memoria
+// ============================================================================
+
+// sequence es la del evento (recordEvent); se llaman con la zona de la
+// plaza tomada, así los eventos de una plaza llegan en orden
+void logEntry(int spotIndex, const char* plate, const char* timestamp, unsigned long long sequence);
+void logExit(int spotIndex, const char* plate, const char* timestamp, unsigned long long sequence);
+void logClientConnected(long long client);
+void logClientDisconnected(long long client);
+
+// reason debe ser una cadena estática (se guarda solo el puntero)
+void logWarning(long long client, const char* reason);
+
+// Eventos descartados porque la cola estaba llena
+unsigned long long droppedLogEvents();
+
+#endif
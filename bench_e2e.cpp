@@ -0,0 +1,635 @@
+// ============================================================================
+// ARCHIVO: bench_e2e.cpp
+// PROPÓSITO: Benchmark de extremo a extremo del servidor: throughput,
+//            latencia de las solicitudes y latencia de las difusiones
+// DESCRIPCIÓN: Por cada motor pedido (--motores hilos,epoll,uring,pool) arranca
+//              servidor_multicliente en un puerto local, conecta
+//              --suscriptores clientes que solo escuchan las difusiones y
+//              lanza --escritores conexiones de carga (load_generator.h,
+//              las "puertas" del parqueadero). Al terminar detiene el
+//              servidor y pasa al siguiente motor, así que los resultados
+//              de los motores se pueden comparar directamente. Con
+//              --estados zonas,actor se repite cada motor con cada modo de
+//              estado del servidor (locks por zona o un solo hilo escritor,
+//              ver state_actor.h).
+//
+// LATENCIA DE DIFUSIÓN: Los escritores anotan la hora de envío de cada
+//   evento por plaza y tipo (entrada/salida). Cada suscriptor, al recibir
+//   la difusión de esa plaza, mide el tiempo desde ese envío. Si una misma
+//   plaza tiene dos eventos del mismo tipo en vuelo se mide desde el más
+//   reciente (raro con la estancia del modelo).
+//
+// USO: bench_e2e [--servidor RUTA] [--motores hilos,epoll,uring,pool] [--estados zonas,actor] [--puerto N]
+//                [--escritores K] [--suscriptores S] [--tasa EV_POR_SEG]
+//                [--duracion SEG] [--profundidad N] [--plazas N] [--binario]
+//                [--semilla N] [--args-servidor "OPCIONES"] [--json ARCHIVO]
+//      --json: escribe los resultados en JSON ("-" = salida estándar, sin
+//              el informe de texto)
+// Solo Linux/POSIX: arranca el servidor con fork/exec.
+// ============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include <stdlib.h>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "binary_protocol.h"
+#include "latency_histogram.h"
+#include "load_generator.h"
+#include "net_compat.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Tiempo máximo para que el servidor acepte conexiones
+static const int STARTUP_TIMEOUT_MS = 5000;
+
+// Espera tras la carga para recibir las últimas difusiones
+static const int BROADCAST_DRAIN_MS = 300;
+
+struct BenchConfig
+{
+	string serverPath = "./servidor_multicliente";
+	vector<string> engines = { "hilos", "epoll" };
+	vector<string> states = { "zonas" };
+	int port = 9100;
+	int subscribers = 4;
+	string serverArgs;
+	string jsonPath;
+	LoadConfig load;
+};
+
+// ============================================================================
+// ESTRUCTURA: Subscriber
+// PROPÓSITO: Un cliente binario que solo escucha las difusiones
+// ============================================================================
+struct Subscriber
+{
+	SOCKET fd = INVALID_SOCKET;
+	string inbound;
+	LatencyHistogram latency;
+	uint64_t received = 0;    // Difusiones de eventos medidos
+};
+
+// Resultado de un motor con un modo de estado
+struct EngineResult
+{
+	string engine;
+	string state;
+	bool started = false;
+	LoadResult load;
+	LatencyHistogram fanout;
+	vector<uint64_t> received;
+	vector<LatencyHistogram> perSubscriber;
+};
+
+static long long nowNs()
+{
+	return (long long)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// SERVIDOR: proceso hijo con la salida estándar descartada
+// ============================================================================
+static pid_t startServer(const BenchConfig& config, const string& engine, const string& state)
+{
+	vector<string> args = { config.serverPath, "--motor", engine, "--estado", state, "--puerto", to_string(config.port),
+		"--plazas", to_string(config.load.spots), "--intervalo-estado", "0" };
+	istringstream extra(config.serverArgs);
+	string word;
+	while (extra >> word)
+	{
+		args.push_back(word);
+	}
+
+	pid_t pid = fork();
+	if (pid != 0)
+	{
+		return pid;
+	}
+
+	// HIJO: el servidor escribe una línea por evento
+	int devNull = open("/dev/null", O_WRONLY);
+	if (devNull >= 0)
+	{
+		dup2(devNull, STDOUT_FILENO);
+		close(devNull);
+	}
+	vector<char*> argv;
+	for (string& arg : args)
+	{
+		argv.push_back(&arg[0]);
+	}
+	argv.push_back(nullptr);
+	execv(argv[0], argv.data());
+	cerr << "No se pudo ejecutar " << config.serverPath << "\n";
+	_exit(127);
+}
+
+static bool waitForServer(const BenchConfig& config, pid_t pid)
+{
+	for (int waited = 0; waited < STARTUP_TIMEOUT_MS; waited += 50)
+	{
+		int status;
+		if (waitpid(pid, &status, WNOHANG) == pid)
+		{
+			return false;
+		}
+		SOCKET probe = connectSocket(config.load.host.c_str(), config.port);
+		if (probe != INVALID_SOCKET)
+		{
+			closesocket(probe);
+			return true;
+		}
+		this_thread::sleep_for(milliseconds(50));
+	}
+	return false;
+}
+
+static void stopServer(pid_t pid)
+{
+	kill(pid, SIGTERM);
+	for (int waited = 0; waited < 2000; waited += 20)
+	{
+		int status;
+		if (waitpid(pid, &status, WNOHANG) == pid)
+		{
+			return;
+		}
+		this_thread::sleep_for(milliseconds(20));
+	}
+	kill(pid, SIGKILL);
+	waitpid(pid, nullptr, 0);
+}
+
+// Conecta y negocia el protocolo binario
+static SOCKET connectSubscriber(const BenchConfig& config)
+{
+	SOCKET fd = connectSocket(config.load.host.c_str(), config.port);
+	if (fd == INVALID_SOCKET)
+	{
+		return fd;
+	}
+	BinaryMessage hello = {};
+	hello.op = BIN_OP_HELLO;
+	hello.aux = BINARY_PROTOCOL_VERSION;
+	char bytes[BINARY_MESSAGE_SIZE];
+	encodeBinaryMessage(hello, bytes);
+	if (send(fd, bytes, BINARY_MESSAGE_SIZE, SEND_FLAGS) == BINARY_MESSAGE_SIZE)
+	{
+		int received = 0;
+		while (received < BINARY_MESSAGE_SIZE)
+		{
+			int n = recvWait(fd, bytes + received, BINARY_MESSAGE_SIZE - received);
+			if (n <= 0)
+			{
+				break;
+			}
+			received += n;
+		}
+		BinaryMessage reply;
+		decodeBinaryMessage(bytes, reply);
+		if (received == BINARY_MESSAGE_SIZE && reply.result == RESULT_HELLO)
+		{
+			return fd;
+		}
+	}
+	closesocket(fd);
+	return INVALID_SOCKET;
+}
+
+// ============================================================================
+// FUNCIÓN: listenLoop
+// PROPÓSITO: Hilo de los suscriptores: recibe las difusiones y mide cada
+//            una desde el envío anotado para su plaza
+// ============================================================================
+static void listenLoop(vector<Subscriber>& subscribers, const atomic<long long>* sendTimes, int spots,
+	const atomic<bool>& stop)
+{
+	vector<PollEntry> entries(subscribers.size());
+	char buffer[16384];
+	while (!stop.load())
+	{
+		for (size_t i = 0; i < subscribers.size(); ++i)
+		{
+			entries[i].fd = subscribers[i].fd;
+			entries[i].events = POLLIN;
+			entries[i].revents = 0;
+		}
+		if (pollSockets(entries.data(), (unsigned long)entries.size(), 20) <= 0)
+		{
+			continue;
+		}
+		for (size_t i = 0; i < subscribers.size(); ++i)
+		{
+			if (entries[i].revents == 0)
+			{
+				continue;
+			}
+			Subscriber& sub = subscribers[i];
+			int n = (int)recv(sub.fd, buffer, sizeof(buffer), 0);
+			if (n <= 0)
+			{
+				continue;
+			}
+			long long arrived = nowNs();
+			sub.inbound.append(buffer, (size_t)n);
+
+			size_t offset = 0;
+			for (; offset + BINARY_MESSAGE_SIZE <= sub.inbound.size(); offset += BINARY_MESSAGE_SIZE)
+			{
+				BinaryMessage message;
+				decodeBinaryMessage(sub.inbound.data() + offset, message);
+				if ((message.op != BIN_OP_ENTERED && message.op != BIN_OP_LEFT) || message.spot > (uint32_t)spots)
+				{
+					continue;
+				}
+				// 0 = evento no medido (entradas iniciales del modelo)
+				long long sent = sendTimes[message.spot * 2 + (message.op == BIN_OP_ENTERED ? 0 : 1)].load(memory_order_relaxed);
+				if (sent > 0 && arrived >= sent)
+				{
+					sub.latency.record((uint64_t)(arrived - sent));
+					sub.received++;
+				}
+			}
+			sub.inbound.erase(0, offset);
+		}
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: runEngine
+// PROPÓSITO: Una medición completa con un motor y un modo de estado
+// ============================================================================
+static EngineResult runEngine(const BenchConfig& config, const string& engine, const string& state)
+{
+	EngineResult result;
+	result.engine = engine;
+	result.state = state;
+
+	pid_t pid = startServer(config, engine, state);
+	if (pid < 0 || !waitForServer(config, pid))
+	{
+		cerr << "El servidor no arranco con --motor " << engine << " --estado " << state << "\n";
+		if (pid > 0)
+		{
+			stopServer(pid);
+		}
+		return result;
+	}
+
+	vector<Subscriber> subscribers((size_t)config.subscribers);
+	for (Subscriber& sub : subscribers)
+	{
+		sub.fd = connectSubscriber(config);
+		if (sub.fd == INVALID_SOCKET)
+		{
+			cerr << "No se pudo conectar un suscriptor\n";
+			for (Subscriber& open : subscribers)
+			{
+				if (open.fd != INVALID_SOCKET) closesocket(open.fd);
+			}
+			stopServer(pid);
+			return result;
+		}
+	}
+
+	// Hora del último envío de cada plaza: [plaza * 2] entradas, [+1] salidas
+	int spots = config.load.spots;
+	unique_ptr<atomic<long long>[]> sendTimes(new atomic<long long>[(size_t)(spots + 1) * 2]);
+	for (int i = 0; i < (spots + 1) * 2; ++i)
+	{
+		sendTimes[i].store(0);
+	}
+
+	LoadConfig load = config.load;
+	load.port = config.port;
+	atomic<long long>* times = sendTimes.get();
+	load.onSend = [times](const WorkloadEvent& event)
+	{
+		times[event.spot * 2 + (event.entry ? 0 : 1)].store(nowNs(), memory_order_relaxed);
+	};
+
+	atomic<bool> stop(false);
+	thread listener;
+	if (!subscribers.empty())
+	{
+		listener = thread(listenLoop, ref(subscribers), times, spots, cref(stop));
+	}
+
+	result.started = runLoad(load, result.load);
+
+	this_thread::sleep_for(milliseconds(BROADCAST_DRAIN_MS));
+	stop.store(true);
+	if (listener.joinable())
+	{
+		listener.join();
+	}
+	for (Subscriber& sub : subscribers)
+	{
+		closesocket(sub.fd);
+		result.fanout.merge(sub.latency);
+		result.received.push_back(sub.received);
+		result.perSubscriber.push_back(sub.latency);
+	}
+	stopServer(pid);
+	return result;
+}
+
+// ============================================================================
+// INFORMES
+// ============================================================================
+static double toMicros(uint64_t ns)
+{
+	return ns / 1000.0;
+}
+
+static void writeLatencyJson(ostream& out, const LatencyHistogram& latency)
+{
+	out << "{\"count\": " << latency.count()
+		<< ", \"p50\": " << toMicros(latency.percentile(50))
+		<< ", \"p90\": " << toMicros(latency.percentile(90))
+		<< ", \"p99\": " << toMicros(latency.percentile(99))
+		<< ", \"p999\": " << toMicros(latency.percentile(99.9))
+		<< ", \"max\": " << toMicros(latency.max()) << "}";
+}
+
+static string jsonString(const string& text)
+{
+	string out = "\"";
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+		}
+		out += c;
+	}
+	return out + "\"";
+}
+
+// Difusiones que debía recibir cada suscriptor: un evento por respuesta OK
+static uint64_t expectedBroadcasts(const LoadResult& load)
+{
+	return load.replies - load.errors;
+}
+
+static void writeJson(ostream& out, const BenchConfig& config, const vector<EngineResult>& results)
+{
+	const LoadConfig& load = config.load;
+	out << fixed << setprecision(1);
+	out << "{\n  \"benchmark\": \"bench_e2e\",\n  \"config\": {"
+		<< "\"writers\": " << load.connections
+		<< ", \"subscribers\": " << config.subscribers
+		<< ", \"rate\": " << load.rate
+		<< ", \"duration_s\": " << load.durationSeconds
+		<< ", \"depth\": " << load.depth
+		<< ", \"spots\": " << load.spots
+		<< ", \"protocol\": " << jsonString(load.binary ? "binary" : "text")
+		<< ", \"seed\": " << load.seed
+		<< ", \"server_args\": " << jsonString(config.serverArgs) << "},\n  \"results\": [";
+
+	for (size_t r = 0; r < results.size(); ++r)
+	{
+		const EngineResult& result = results[r];
+		out << (r ? ",\n" : "\n") << "    {\"engine\": " << jsonString(result.engine)
+			<< ", \"state\": " << jsonString(result.state)
+			<< ", \"ok\": " << (result.started ? "true" : "false");
+		if (result.started)
+		{
+			const LoadResult& l = result.load;
+			out << ", \"events_per_sec\": " << (l.measuredSeconds > 0 ? l.replies / l.measuredSeconds : 0.0)
+				<< ", \"sent\": " << l.sent << ", \"replies\": " << l.replies << ", \"errors\": " << l.errors
+				<< ", \"unanswered\": " << l.unanswered << ", \"failed_connections\": " << l.failedConnections
+				<< ",\n     \"request_latency_us\": ";
+			writeLatencyJson(out, l.latency);
+			out << ",\n     \"fanout_latency_us\": ";
+			writeLatencyJson(out, result.fanout);
+			out << ",\n     \"subscribers\": [";
+			uint64_t expected = expectedBroadcasts(l);
+			for (size_t s = 0; s < result.perSubscriber.size(); ++s)
+			{
+				uint64_t received = result.received[s];
+				out << (s ? ", " : "") << "{\"received\": " << received
+					<< ", \"missed\": " << (received < expected ? expected - received : 0)
+					<< ", \"latency_us\": ";
+				writeLatencyJson(out, result.perSubscriber[s]);
+				out << "}";
+			}
+			out << "]";
+		}
+		out << "}";
+	}
+	out << "\n  ]\n}\n";
+}
+
+static void printReport(const BenchConfig& config, const EngineResult& result)
+{
+	cout << "\n================================================\n";
+	cout << "  MOTOR: " << result.engine << " | ESTADO: " << result.state << "\n";
+	cout << "================================================\n";
+	if (!result.started)
+	{
+		cout << "  No se pudo medir\n";
+		return;
+	}
+	const LoadResult& l = result.load;
+	cout << "  Escritores: " << config.load.connections << " | Suscriptores: " << config.subscribers
+		<< " | Protocolo: " << (config.load.binary ? "binario" : "texto") << "\n";
+	cout << "  Enviados: " << l.sent << " | Respuestas: " << l.replies << " (" << l.errors
+		<< " errores) | Sin respuesta: " << l.unanswered << "\n";
+	cout << "  Throughput sostenido: " << fixed << setprecision(1)
+		<< (l.measuredSeconds > 0 ? l.replies / l.measuredSeconds : 0.0) << " eventos/s\n\n";
+	cout << "  Latencia de las solicitudes (desde el envio previsto):\n";
+	printLatencyReport(l.latency);
+	if (config.subscribers > 0)
+	{
+		cout << "\n  Latencia de difusion (envio -> suscriptor):\n";
+		printLatencyReport(result.fanout);
+		uint64_t expected = expectedBroadcasts(l);
+		cout << "\n  Por suscriptor (recibidas / esperadas, p50 / p99 / max en us):\n";
+		for (size_t s = 0; s < result.perSubscriber.size(); ++s)
+		{
+			const LatencyHistogram& h = result.perSubscriber[s];
+			cout << "    #" << (s + 1) << ": " << result.received[s] << " / " << expected << "  "
+				<< setprecision(1) << toMicros(h.percentile(50)) << " / " << toMicros(h.percentile(99))
+				<< " / " << toMicros(h.max()) << "\n";
+		}
+	}
+}
+
+// Lista separada por comas en la que cada elemento es uno de allowed
+static bool parseChoices(const char* text, const vector<string>& allowed, vector<string>& values)
+{
+	values.clear();
+	stringstream list(text);
+	string value;
+	while (getline(list, value, ','))
+	{
+		bool known = false;
+		for (const string& choice : allowed)
+		{
+			known = known || value == choice;
+		}
+		if (!known)
+		{
+			return false;
+		}
+		values.push_back(value);
+	}
+	return !values.empty();
+}
+
+static void printUsage(const char* program)
+{
+	cerr << "Uso: " << program << " [--servidor RUTA] [--motores hilos,epoll,uring,pool] [--estados zonas,actor] [--puerto N]"
+		<< " [--escritores K] [--suscriptores S] [--tasa EV_POR_SEG] [--duracion SEG]"
+		<< " [--profundidad N] [--plazas N] [--binario] [--semilla N]"
+		<< " [--args-servidor \"OPCIONES\"] [--json ARCHIVO]\n";
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfig config;
+	config.load.connections = 4;
+	config.load.rate = 5000;
+	config.load.durationSeconds = 5;
+	config.load.depth = 4;
+	config.load.spots = 1000;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		bool valid = true;
+
+		if (arg == "--servidor" && hasValue)
+		{
+			config.serverPath = argv[++i];
+		}
+		else if (arg == "--motores" && hasValue)
+		{
+			valid = parseChoices(argv[++i], { "hilos", "epoll", "uring", "pool" }, config.engines);
+		}
+		else if (arg == "--estados" && hasValue)
+		{
+			valid = parseChoices(argv[++i], { "zonas", "actor" }, config.states);
+		}
+		else if (arg == "--puerto" && hasValue)
+		{
+			config.port = atoi(argv[++i]);
+		}
+		else if (arg == "--escritores" && hasValue)
+		{
+			config.load.connections = atoi(argv[++i]);
+		}
+		else if (arg == "--suscriptores" && hasValue)
+		{
+			config.subscribers = atoi(argv[++i]);
+		}
+		else if (arg == "--tasa" && hasValue)
+		{
+			config.load.rate = atof(argv[++i]);
+		}
+		else if (arg == "--duracion" && hasValue)
+		{
+			config.load.durationSeconds = atof(argv[++i]);
+		}
+		else if (arg == "--profundidad" && hasValue)
+		{
+			config.load.depth = atoi(argv[++i]);
+		}
+		else if (arg == "--plazas" && hasValue)
+		{
+			config.load.spots = atoi(argv[++i]);
+		}
+		else if (arg == "--binario")
+		{
+			config.load.binary = true;
+		}
+		else if (arg == "--semilla" && hasValue)
+		{
+			config.load.seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--args-servidor" && hasValue)
+		{
+			config.serverArgs = argv[++i];
+		}
+		else if (arg == "--json" && hasValue)
+		{
+			config.jsonPath = argv[++i];
+		}
+		else
+		{
+			valid = false;
+		}
+
+		if (!valid)
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	if (config.subscribers < 0 || config.port < 1 || config.load.spots < 1)
+	{
+		cerr << "Parametros invalidos\n";
+		return 1;
+	}
+
+	// Un suscriptor que se cierra no debe terminar el proceso
+	signal(SIGPIPE, SIG_IGN);
+
+	bool quiet = (config.jsonPath == "-");
+	vector<EngineResult> results;
+	bool allStarted = true;
+	for (const string& engine : config.engines)
+	{
+		for (const string& state : config.states)
+		{
+			if (!quiet)
+			{
+				cout << "Midiendo motor " << engine << " (estado " << state << ")..." << endl;
+			}
+			results.push_back(runEngine(config, engine, state));
+			allStarted = allStarted && results.back().started;
+			if (!quiet)
+			{
+				printReport(config, results.back());
+			}
+		}
+	}
+
+	if (quiet)
+	{
+		writeJson(cout, config, results);
+	}
+	else if (!config.jsonPath.empty())
+	{
+		ofstream out(config.jsonPath.c_str());
+		if (!out)
+		{
+			cerr << "No se pudo escribir " << config.jsonPath << "\n";
+			return 1;
+		}
+		writeJson(out, config, results);
+		cout << "\nResultados JSON en " << config.jsonPath << "\n";
+	}
+	if (!quiet)
+	{
+		cout << "\n";
+	}
+	return allStarted ? 0 : 1;
+}
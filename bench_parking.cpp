@@ -0,0 +1,792 @@
+// ============================================================================
+// ARCHIVO: bench_parking.cpp
+// PROPÓSITO: Microbenchmarks de ParkingManager (ns por operación) para tener
+//            un antes/después de cada cambio en sus estructuras de datos
+// DESCRIPCIÓN: Mide addVehicle, removeVehicle, findPlate, getOccupiedCount,
+//              isSpotOccupied y getPlate con varias capacidades, niveles de
+//              ocupación y números de hilos. Como Google Benchmark, cada
+//              medición repite la operación hasta durar al menos
+//              --tiempo-min ms. En Linux cuenta además los fallos de caché
+//              por operación (perf_event_open), si el sistema lo permite.
+//              Con --comparar mide el diseño anterior de las plazas
+//              (arreglo de registros VehicleInfo de 41 bytes) contra el
+//              actual (columnas separadas + mapa de bits + índice hash).
+// USO: bench_parking [--plazas N,N...] [--ocupacion P,P...] [--hilos N,N...]
+//                    [--tiempo-min MS] [--filtro TEXTO] [--csv]
+//      bench_parking --comparar [--plazas N] [--ocupacion PORCENTAJE] [--repeticiones R]
+// ============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <string.h>    // Para strcmp, strncpy
+#include <stdio.h>     // Para snprintf
+#include <stdlib.h>    // Para atoi
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "parking_lib.h"
+#include "plate_codec.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// ============================================================================
+// DISEÑO ANTERIOR: arreglo de registros, recorridos lineales
+// ============================================================================
+struct VehicleInfo {
+	char plate[10];
+	char timestamp[30];
+	bool occupied;
+};
+
+struct AosParking {
+	vector<VehicleInfo> spots;
+
+	explicit AosParking(int capacity) : spots((size_t)capacity)
+	{
+		for (VehicleInfo& spot : spots)
+		{
+			spot.occupied = false;
+			spot.plate[0] = '\0';
+			spot.timestamp[0] = '\0';
+		}
+	}
+
+	void add(int spotIndex, const char* plate, const char* timestamp)
+	{
+		strncpy(spots[spotIndex].plate, plate, 9);
+		spots[spotIndex].plate[9] = '\0';
+		strncpy(spots[spotIndex].timestamp, timestamp, 29);
+		spots[spotIndex].timestamp[29] = '\0';
+		spots[spotIndex].occupied = true;
+	}
+
+	int findPlate(const char* plate) const
+	{
+		for (size_t i = 0; i < spots.size(); ++i)
+		{
+			if (spots[i].occupied && strcmp(spots[i].plate, plate) == 0)
+			{
+				return (int)i;
+			}
+		}
+		return -1;
+	}
+
+	int occupiedCount() const
+	{
+		int count = 0;
+		for (const VehicleInfo& spot : spots)
+		{
+			count += spot.occupied;
+		}
+		return count;
+	}
+
+	int firstFree() const
+	{
+		for (size_t i = 0; i < spots.size(); ++i)
+		{
+			if (!spots[i].occupied)
+			{
+				return (int)i;
+			}
+		}
+		return -1;
+	}
+};
+
+// Evita que el compilador descarte los resultados medidos
+static volatile long long sink = 0;
+
+// ============================================================================
+// FUNCIÓN: measure
+// PROPÓSITO: Ejecuta fn "reps" veces y retorna nanosegundos por ejecución
+// ============================================================================
+template <typename Fn>
+static double measure(int reps, Fn fn)
+{
+	auto start = steady_clock::now();
+	long long acc = 0;
+	for (int r = 0; r < reps; ++r)
+	{
+		acc += fn(r);
+	}
+	auto elapsed = steady_clock::now() - start;
+	sink = sink + acc;
+	return (double)duration_cast<nanoseconds>(elapsed).count() / reps;
+}
+
+static void printRow(const char* name, double before, double after)
+{
+	cout << "  " << left << setw(28) << name << right << fixed << setprecision(1)
+		<< setw(14) << before << setw(14) << after
+		<< setw(10) << setprecision(1) << (after > 0 ? before / after : 0) << "x\n";
+}
+
+// ============================================================================
+// FUNCIÓN: runComparison
+// PROPÓSITO: Modo --comparar: diseño anterior (registros) contra el actual
+//            (columnas) con las mismas plazas y vehículos
+// ============================================================================
+static int runComparison(int numSpots, int occupancyPercent, int reps)
+{
+	// LLENAR AMBOS DISEÑOS CON LOS MISMOS VEHÍCULOS
+	AosParking before(numSpots);
+	ParkingManager after(numSpots);
+	vector<string> plates;
+
+	// Se llena desde la entrada, como un parqueadero real: la primera plaza
+	// libre queda después de todas las ocupadas
+	int occupied = (int)((long long)numSpots * occupancyPercent / 100);
+	for (int i = 0; i < occupied; ++i)
+	{
+		char plate[8];
+		int n = (int)plates.size();
+		snprintf(plate, sizeof(plate), "%c%c%c%03d",
+			'A' + n / 26000 % 26, 'A' + n / 1000 % 26, 'A' + n % 26, n % 1000);
+		before.add(i, plate, "2024-11-25 14:30:45");
+		after.addVehicle(i, plate, "2024-11-25 14:30:45");
+		plates.push_back(plate);
+	}
+
+	cout << "\n================================================\n";
+	cout << "  BENCHMARK DE DISEÑO DE PLAZAS\n";
+	cout << "================================================\n";
+	cout << "  Plazas: " << numSpots << " | Ocupadas: " << after.getOccupiedCount()
+		<< " | Repeticiones: " << reps << "\n\n";
+
+	size_t bytesBefore = sizeof(VehicleInfo);
+	double bytesAfter = sizeof(unsigned int) + sizeof(long long) + 1.0 / 8;
+	cout << "  Bytes por plaza (sin indice): " << bytesBefore << " -> " << bytesAfter << "\n\n";
+
+	cout << "  " << left << setw(28) << "Operacion (ns/op)" << right
+		<< setw(14) << "Registros" << setw(14) << "Columnas" << setw(11) << "Mejora" << "\n";
+
+	printRow("getOccupiedCount",
+		measure(reps, [&](int) { return before.occupiedCount(); }),
+		measure(reps, [&](int) { return after.getOccupiedCount(); }));
+
+	printRow("countOccupied (recorrido)",
+		measure(reps, [&](int) { return before.occupiedCount(); }),
+		measure(reps, [&](int) { return after.countOccupied(0, numSpots); }));
+
+	printRow("findFirstFree",
+		measure(reps, [&](int) { return before.firstFree(); }),
+		measure(reps, [&](int) { return after.findFirstFree(); }));
+
+	// Como el visualizador: estado y placa de cada plaza
+	printRow("recorrer tablero",
+		measure(reps, [&](int)
+		{
+			long long acc = 0;
+			for (int i = 0; i < numSpots; ++i)
+			{
+				if (before.spots[i].occupied)
+				{
+					acc += before.spots[i].plate[0];
+				}
+			}
+			return acc;
+		}),
+		measure(reps, [&](int)
+		{
+			long long acc = 0;
+			for (int i = 0; i < numSpots; ++i)
+			{
+				if (after.isSpotOccupied(i))
+				{
+					acc += after.getPlate(i)[0];
+				}
+			}
+			return acc;
+		}));
+
+	if (!plates.empty())
+	{
+		int lookups = reps * 10;
+		printRow("findPlate",
+			measure(lookups, [&](int r) { return before.findPlate(plates[(size_t)r * 7919 % plates.size()].c_str()); }),
+			measure(lookups, [&](int r) { return after.findPlate(plates[(size_t)r * 7919 % plates.size()].c_str()); }));
+	}
+
+	cout << "\n";
+	return 0;
+}
+
+// ============================================================================
+// MICROBENCHMARKS
+// ============================================================================
+
+enum BenchOp {
+	OP_ADD,
+	OP_REMOVE,
+	OP_FIND,
+	OP_COUNT,
+	OP_OCCUPIED,
+	OP_PLATE
+};
+
+static const char* const OP_NAMES[] = {
+	"addVehicle", "removeVehicle", "findPlate", "getOccupiedCount", "isSpotOccupied", "getPlate"
+};
+
+static const char* const BENCH_TIMESTAMP = "2024-11-25 14:30:45";
+
+// Entradas (o salidas) medidas entre dos restauraciones sin medir
+static const size_t MAX_BATCH = 256;
+
+// Límite de iteraciones por hilo en una medición
+static const long long MAX_ITERATIONS = 1000000000LL;
+
+// Salto de isSpotOccupied entre consultas: primo y grande, para que cada
+// consulta caiga en otra línea de caché
+static const long long SPOT_STEP = 7919;
+
+// ============================================================================
+// CLASE: CacheMissCounter
+// PROPÓSITO: Fallos de caché del hilo que la crea (perf_event_open, solo
+//            Linux). available() es false si el sistema no lo permite
+// ============================================================================
+class CacheMissCounter
+{
+private:
+	int fd;
+
+public:
+	CacheMissCounter() : fd(-1)
+	{
+#ifdef __linux__
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+
+	~CacheMissCounter()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+#endif
+	}
+
+	CacheMissCounter(const CacheMissCounter&) = delete;
+	CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+	bool available() const { return fd >= 0; }
+
+	void start()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	void stop()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		}
+#endif
+	}
+
+	long long value() const
+	{
+		long long count = 0;
+#ifdef __linux__
+		if (fd >= 0 && read(fd, &count, sizeof(count)) != (ssize_t)sizeof(count))
+		{
+			count = 0;
+		}
+#endif
+		return count;
+	}
+};
+
+// ============================================================================
+// ESTRUCTURA: Fixture
+// PROPÓSITO: Un parqueadero lleno hasta la ocupación pedida. Cada plaza
+//            tiene una placa fija: spots[j] siempre se ocupa con plate(j), y
+//            las plazas spots[0..occupied) son las ocupadas. Las plazas van
+//            en orden aleatorio para que las ocupadas queden repartidas
+// ============================================================================
+struct Fixture
+{
+	int capacity;
+	int occupied;
+	ParkingManager parking;
+	vector<int> spots;
+	vector<char> plates;    // PLATE_RECORD_SIZE bytes por plaza
+
+	Fixture(int capacity, int occupancyPercent)
+		: capacity(capacity), occupied((int)((long long)capacity * occupancyPercent / 100)),
+		  parking(capacity), spots((size_t)capacity), plates((size_t)capacity * PLATE_RECORD_SIZE)
+	{
+		for (int j = 0; j < capacity; ++j)
+		{
+			spots[(size_t)j] = j;
+			// 7919 es coprimo con las 26^3 * 1000 placas: todas distintas
+			decodePlate((unsigned int)((unsigned long long)j * 7919 % 17576000ULL), &plates[(size_t)j * PLATE_RECORD_SIZE]);
+		}
+		mt19937 random(1);
+		shuffle(spots.begin(), spots.end(), random);
+		for (int j = 0; j < occupied; ++j)
+		{
+			parking.addVehicle(spots[(size_t)j], plate(j), BENCH_TIMESTAMP);
+		}
+	}
+
+	const char* plate(int j) const { return &plates[(size_t)j * PLATE_RECORD_SIZE]; }
+};
+
+// ============================================================================
+// ESTRUCTURA: ThreadSlice
+// PROPÓSITO: Las plazas de un hilo (j % hilos == t), para que varios hilos
+//            entren y saquen vehículos sin pisarse
+// ============================================================================
+struct ThreadSlice
+{
+	vector<int> parked;    // Índices j ocupados
+	vector<int> free;      // Índices j libres
+	size_t parkedCursor = 0;
+	size_t freeCursor = 0;
+	long long spotCursor = 0;
+};
+
+// Resultado de un hilo en una medición
+struct ThreadResult
+{
+	double timedNs = 0;
+	long long misses = 0;
+	bool counted = false;
+};
+
+// ============================================================================
+// FUNCIÓN: runOp
+// PROPÓSITO: Ejecuta la operación "iterations" veces en un hilo. Con varios
+//            hilos cada operación toma el mutex, como en el servidor.
+//            addVehicle/removeVehicle se miden por lotes y después se
+//            deshacen sin medir, para que la ocupación no cambie
+// ============================================================================
+static void runOp(BenchOp op, Fixture& fixture, ThreadSlice& slice, long long iterations,
+	mutex* guard, ThreadResult& result)
+{
+	CacheMissCounter counter;
+	ParkingManager& parking = fixture.parking;
+	long long acc = 0;
+	long long spotStep = SPOT_STEP % fixture.capacity;
+	steady_clock::time_point start;
+
+	if (op == OP_ADD || op == OP_REMOVE)
+	{
+		vector<int>& pool = (op == OP_ADD) ? slice.free : slice.parked;
+		size_t& cursor = (op == OP_ADD) ? slice.freeCursor : slice.parkedCursor;
+		size_t batchLimit = min(pool.size(), MAX_BATCH);
+		vector<int> batch;
+		batch.reserve(batchLimit);
+
+		long long done = 0;
+		while (done < iterations)
+		{
+			batch.clear();
+			while (batch.size() < batchLimit && done + (long long)batch.size() < iterations)
+			{
+				batch.push_back(pool[cursor]);
+				if (++cursor == pool.size())
+				{
+					cursor = 0;
+				}
+			}
+
+			counter.start();
+			start = steady_clock::now();
+			for (int j : batch)
+			{
+				if (guard) guard->lock();
+				if (op == OP_ADD)
+				{
+					acc += parking.addVehicle(fixture.spots[(size_t)j], fixture.plate(j), BENCH_TIMESTAMP);
+				}
+				else
+				{
+					acc += parking.removeVehicle(fixture.plate(j));
+				}
+				if (guard) guard->unlock();
+			}
+			result.timedNs += (double)duration_cast<nanoseconds>(steady_clock::now() - start).count();
+			counter.stop();
+
+			// DESHACER (sin medir)
+			for (int j : batch)
+			{
+				if (guard) guard->lock();
+				if (op == OP_ADD)
+				{
+					parking.removeVehicle(fixture.plate(j));
+				}
+				else
+				{
+					parking.addVehicle(fixture.spots[(size_t)j], fixture.plate(j), BENCH_TIMESTAMP);
+				}
+				if (guard) guard->unlock();
+			}
+			done += (long long)batch.size();
+		}
+	}
+	else
+	{
+		counter.start();
+		start = steady_clock::now();
+		for (long long i = 0; i < iterations; ++i)
+		{
+			if (guard) guard->lock();
+			switch (op)
+			{
+			case OP_FIND:
+				acc += parking.findPlate(fixture.plate(slice.parked[slice.parkedCursor]));
+				if (++slice.parkedCursor == slice.parked.size()) slice.parkedCursor = 0;
+				break;
+			case OP_COUNT:
+				acc += parking.getOccupiedCount();
+				break;
+			case OP_OCCUPIED:
+				acc += parking.isSpotOccupied((int)slice.spotCursor);
+				slice.spotCursor += spotStep;
+				if (slice.spotCursor >= fixture.capacity) slice.spotCursor -= fixture.capacity;
+				break;
+			case OP_PLATE:
+				acc += parking.getPlate(fixture.spots[(size_t)slice.parked[slice.parkedCursor]])[0];
+				if (++slice.parkedCursor == slice.parked.size()) slice.parkedCursor = 0;
+				break;
+			default:
+				break;
+			}
+			if (guard) guard->unlock();
+		}
+		result.timedNs = (double)duration_cast<nanoseconds>(steady_clock::now() - start).count();
+		counter.stop();
+	}
+
+	result.counted = counter.available();
+	result.misses = counter.value();
+	sink = sink + acc;
+}
+
+// Resultado de una medición completa
+struct BenchResult
+{
+	double nsPerOp;
+	double mopsPerSecond;
+	double missesPerOp;    // < 0 si no hay contadores
+	long long iterations;
+};
+
+// ============================================================================
+// FUNCIÓN: runBenchmark
+// PROPÓSITO: Repite la medición con más iteraciones hasta que dure al menos
+//            minTimeNs (como Google Benchmark). Todos los hilos arrancan a
+//            la vez y hacen las mismas iteraciones
+// ============================================================================
+static BenchResult runBenchmark(BenchOp op, Fixture& fixture, vector<ThreadSlice>& slices, double minTimeNs)
+{
+	int threadCount = (int)slices.size();
+	mutex guard;
+	vector<ThreadResult> results;
+	long long iterations = 1;
+
+	while (true)
+	{
+		results.assign((size_t)threadCount, ThreadResult());
+		if (threadCount == 1)
+		{
+			runOp(op, fixture, slices[0], iterations, nullptr, results[0]);
+		}
+		else
+		{
+			atomic<int> ready(0);
+			vector<thread> threads;
+			for (int t = 0; t < threadCount; ++t)
+			{
+				threads.emplace_back([&, t]()
+				{
+					ready.fetch_add(1);
+					while (ready.load() < threadCount)
+					{
+						this_thread::yield();
+					}
+					runOp(op, fixture, slices[(size_t)t], iterations, &guard, results[(size_t)t]);
+				});
+			}
+			for (thread& worker : threads)
+			{
+				worker.join();
+			}
+		}
+
+		double slowest = 0;
+		for (const ThreadResult& r : results)
+		{
+			slowest = max(slowest, r.timedNs);
+		}
+		if (slowest >= minTimeNs || iterations >= MAX_ITERATIONS)
+		{
+			break;
+		}
+		double factor = slowest > 0 ? 1.4 * minTimeNs / slowest : 10.0;
+		factor = min(max(factor, 1.5), 10.0);
+		iterations = min((long long)(iterations * factor) + 1, MAX_ITERATIONS);
+	}
+
+	double totalNs = 0;
+	long long misses = 0;
+	bool counted = true;
+	for (const ThreadResult& r : results)
+	{
+		totalNs += r.timedNs;
+		misses += r.misses;
+		counted = counted && r.counted;
+	}
+
+	BenchResult bench;
+	bench.iterations = iterations;
+	bench.nsPerOp = totalNs / threadCount / iterations;
+	bench.mopsPerSecond = bench.nsPerOp > 0 ? threadCount * 1000.0 / bench.nsPerOp : 0;
+	bench.missesPerOp = counted ? (double)misses / ((double)iterations * threadCount) : -1;
+	return bench;
+}
+
+// "40,1000,100000" -> {40, 1000, 100000}
+static bool parseList(const char* text, vector<int>& values)
+{
+	values.clear();
+	while (*text != '\0')
+	{
+		char* end;
+		long value = strtol(text, &end, 10);
+		if (end == text || (*end != ',' && *end != '\0'))
+		{
+			return false;
+		}
+		values.push_back((int)value);
+		text = (*end == ',') ? end + 1 : end;
+	}
+	return !values.empty();
+}
+
+static void printUsage(const char* program)
+{
+	cerr << "Uso: " << program << " [--plazas N,N...] [--ocupacion P,P...] [--hilos N,N...]"
+		<< " [--tiempo-min MS] [--filtro TEXTO] [--csv]\n"
+		<< "     " << program << " --comparar [--plazas N] [--ocupacion PORCENTAJE] [--repeticiones R]\n";
+}
+
+int main(int argc, char* argv[])
+{
+	vector<int> capacities = { 40, 1000, 100000, 1000000 };
+	vector<int> occupancies = { 10, 50, 90 };
+	int cores = (int)thread::hardware_concurrency();
+	vector<int> threadCounts = { 1 };
+	if (cores > 1)
+	{
+		threadCounts.push_back(min(cores, 4));
+	}
+	double minTimeMs = 50;
+	string filter;
+	bool csv = false;
+	bool compare = false;
+	int reps = 200;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		bool valid = true;
+
+		if (arg == "--plazas" && hasValue)
+		{
+			valid = parseList(argv[++i], capacities);
+		}
+		else if (arg == "--ocupacion" && hasValue)
+		{
+			valid = parseList(argv[++i], occupancies);
+		}
+		else if (arg == "--hilos" && hasValue)
+		{
+			valid = parseList(argv[++i], threadCounts);
+		}
+		else if (arg == "--tiempo-min" && hasValue)
+		{
+			minTimeMs = atof(argv[++i]);
+		}
+		else if (arg == "--filtro" && hasValue)
+		{
+			filter = argv[++i];
+		}
+		else if (arg == "--csv")
+		{
+			csv = true;
+		}
+		else if (arg == "--comparar")
+		{
+			compare = true;
+		}
+		else if (arg == "--repeticiones" && hasValue)
+		{
+			reps = atoi(argv[++i]);
+		}
+		else
+		{
+			valid = false;
+		}
+
+		if (!valid)
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	bool invalid = reps < 1 || minTimeMs <= 0;
+	for (int value : capacities) invalid = invalid || value < 1;
+	for (int value : occupancies) invalid = invalid || value < 0 || value > 100;
+	for (int value : threadCounts) invalid = invalid || value < 1;
+	if (invalid)
+	{
+		cerr << "Parametros invalidos\n";
+		return 1;
+	}
+
+	if (compare)
+	{
+		return runComparison(capacities[0], occupancies[0], reps);
+	}
+
+	bool countersAvailable = CacheMissCounter().available();
+	if (csv)
+	{
+		cout << "benchmark,operacion,plazas,ocupacion,hilos,ns_op,mops,fallos_cache_op,iteraciones\n";
+	}
+	else
+	{
+		cout << "\n================================================\n";
+		cout << "  MICROBENCHMARKS DE ParkingManager\n";
+		cout << "================================================\n";
+		cout << "  Tiempo minimo por medicion: " << minTimeMs << " ms"
+			<< " | Fallos de cache: " << (countersAvailable ? "si" : "no disponibles") << "\n";
+		cout << "  Con varios hilos cada operacion toma un mutex compartido (como el servidor)\n\n";
+		cout << left << setw(50) << "Benchmark" << right << setw(12) << "ns/op" << setw(12) << "Mops/s"
+			<< setw(14) << "Fallos/op" << setw(14) << "Iteraciones" << "\n";
+		cout << string(102, '-') << "\n";
+	}
+
+	for (int capacity : capacities)
+	{
+		for (int occupancy : occupancies)
+		{
+			Fixture fixture(capacity, occupancy);
+
+			for (int threadCount : threadCounts)
+			{
+				vector<ThreadSlice> slices((size_t)threadCount);
+				for (int j = 0; j < capacity; ++j)
+				{
+					ThreadSlice& slice = slices[(size_t)(j % threadCount)];
+					(j < fixture.occupied ? slice.parked : slice.free).push_back(j);
+				}
+				for (int t = 0; t < threadCount; ++t)
+				{
+					slices[(size_t)t].spotCursor = (long long)capacity * t / threadCount;
+				}
+				bool anyFree = true;
+				bool anyParked = true;
+				for (const ThreadSlice& slice : slices)
+				{
+					anyFree = anyFree && !slice.free.empty();
+					anyParked = anyParked && !slice.parked.empty();
+				}
+
+				for (int op = OP_ADD; op <= OP_PLATE; ++op)
+				{
+					char name[96];
+					snprintf(name, sizeof(name), "%s/plazas:%d/ocupacion:%d/hilos:%d",
+						OP_NAMES[op], capacity, occupancy, threadCount);
+					if (!filter.empty() && string(name).find(filter) == string::npos)
+					{
+						continue;
+					}
+					// Cada hilo necesita al menos una plaza libre (entradas)
+					// u ocupada (salidas y búsquedas)
+					bool needsFree = (op == OP_ADD);
+					bool needsParked = (op == OP_REMOVE || op == OP_FIND || op == OP_PLATE);
+					if ((needsFree && !anyFree) || (needsParked && !anyParked))
+					{
+						if (!csv)
+						{
+							cout << left << setw(50) << name << right << setw(12) << "-"
+								<< "  (sin plazas " << (needsFree ? "libres" : "ocupadas") << ")\n";
+						}
+						continue;
+					}
+
+					BenchResult result = runBenchmark((BenchOp)op, fixture, slices, minTimeMs * 1e6);
+					if (csv)
+					{
+						cout << name << "," << OP_NAMES[op] << "," << capacity << "," << occupancy << ","
+							<< threadCount << "," << fixed << setprecision(2) << result.nsPerOp << ","
+							<< result.mopsPerSecond << ",";
+						if (result.missesPerOp >= 0)
+						{
+							cout << setprecision(3) << result.missesPerOp;
+						}
+						cout << "," << result.iterations << "\n";
+						continue;
+					}
+					cout << left << setw(50) << name << right << fixed << setprecision(2)
+						<< setw(12) << result.nsPerOp << setw(12) << result.mopsPerSecond;
+					if (result.missesPerOp >= 0)
+					{
+						cout << setw(14) << setprecision(3) << result.missesPerOp;
+					}
+					else
+					{
+						cout << setw(14) << "-";
+					}
+					cout << setw(14) << result.iterations << "\n";
+				}
+			}
+		}
+	}
+
+	if (!csv)
+	{
+		cout << "\n";
+	}
+	return 0;
+}
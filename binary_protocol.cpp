@@ -0,0 +1,54 @@
+#include "binary_protocol.h"
+
+static void putLE(char* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = (char)(value >> (8 * i));
+    }
+}
+
+static uint64_t getLE(const char* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= (uint64_t)(unsigned char)in[i] << (8 * i);
+    }
+    return value;
+}
+
+void encodeBinaryMessage(const BinaryMessage& message, char* out) {
+    out[0] = (char)message.op;
+    out[1] = (char)message.result;
+    out[2] = 0;
+    out[3] = 0;
+    putLE(out + 4, message.spot, 4);
+    putLE(out + 8, message.plate, 4);
+    putLE(out + 12, message.aux, 4);
+    putLE(out + 16, (uint64_t)message.timestamp, 8);
+}
+
+void decodeBinaryMessage(const char* in, BinaryMessage& message) {
+    message.op = (uint8_t)in[0];
+    message.result = (uint8_t)in[1];
+    message.spot = (uint32_t)getLE(in + 4, 4);
+    message.plate = (uint32_t)getLE(in + 8, 4);
+    message.aux = (uint32_t)getLE(in + 12, 4);
+    message.timestamp = (int64_t)getLE(in + 16, 8);
+}
+
+const char* resultText(int result) {
+    switch (result) {
+        case RESULT_PARKED:  return "OK: Vehiculo estacionado";
+        case RESULT_LEFT:    return "OK: Vehiculo salio. Plaza liberada";
+        case RESULT_RESIZED: return "OK: Capacidad ampliada";
+        case RESULT_STATUS:  return "OK: Estado";
+        case RESULT_HELLO:   return "OK: Protocolo binario";
+        case ERROR_FORMAT:   return "ERROR: Formato invalido. Use PUESTO:PLACA:TIMESTAMP";
+        case ERROR_PLATE:    return "ERROR: Placa invalida. Formato: AAA000";
+        case ERROR_SPOT:     return "ERROR: Puesto invalido. Fuera de la capacidad del parqueadero";
+        case ERROR_OCCUPIED: return "ERROR: Plaza ya ocupada";
+        case ERROR_CAPACITY: return "ERROR: Capacidad invalida";
+        case ERROR_SHRINK:   return "ERROR: La capacidad solo puede aumentar";
+        case ERROR_VERSION:  return "ERROR: Version de protocolo no soportada";
+        case ERROR_STORAGE:  return "ERROR: No se pudo guardar el cambio en disco";
+        default:             return "ERROR: Desconocido";
+    }
+}
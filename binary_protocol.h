@@ -0,0 +1,86 @@
+// ============================================================================
+// ARCHIVO: binary_protocol.h
+// PROPÓSITO: Protocolo binario de tamaño fijo, alternativo al de texto
+// DESCRIPCIÓN: Cada mensaje mide BINARY_MESSAGE_SIZE bytes y se lee sin
+//              strchr/atoi: plaza, placa (código de plate_codec.h) y hora
+//              en segundos desde 1970 ya vienen como enteros. Lo comparten
+//              el servidor y cliente.cpp.
+//
+// NEGOCIACIÓN: El cliente abre la conexión con un mensaje BIN_OP_HELLO
+//   (versión en "aux"). Su primer byte, '{', no puede empezar un mensaje
+//   de texto (dígito o letra) ni un prefijo de longitud (< 0x04), así que
+//   StreamFramer pasa a FRAME_BINARY. El servidor responde BIN_OP_HELLO |
+//   BIN_OP_REPLY con su versión y RESULT_HELLO, o ERROR_VERSION si no la
+//   soporta.
+//
+// FORMATO (little-endian, 24 bytes):
+//   byte  0     op         BinaryOp (respuesta: op | BIN_OP_REPLY)
+//   byte  1     result     ParkingResult (solo respuestas)
+//   bytes 2-3   reservado  0
+//   bytes 4-7   spot       Plaza 1..N. CAPACIDAD: N. Estado: plazas
+//   bytes 8-11  plate      Código de placa. Estado: ocupadas
+//   bytes 12-15 aux        HELLO: versión. Estado: reservas de memoria
+//   bytes 16-23 timestamp  Segundos desde 1970 (0 = sin hora)
+// ============================================================================
+
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <stdint.h>
+
+#define BINARY_PROTOCOL_VERSION 1
+#define BINARY_MESSAGE_SIZE 24
+
+enum BinaryOp {
+    BIN_OP_PARK = 0x01,        // Entrada, o salida si la placa ya está dentro
+    BIN_OP_CAPACITY = 0x02,    // Ampliar a "spot" plazas
+    BIN_OP_STATUS = 0x03,      // Plazas, ocupadas y reservas de memoria
+    BIN_OP_ENTERED = 0x11,     // Difusión: plaza ocupada por "plate"
+    BIN_OP_LEFT = 0x12,        // Difusión: plaza liberada
+    BIN_OP_RESIZED = 0x13,     // Difusión: el parqueadero tiene "spot" plazas
+    BIN_OP_HELLO = 0x7B        // '{': primer mensaje de la conexión
+};
+
+// Bit que marca la respuesta a una solicitud
+#define BIN_OP_REPLY 0x80
+
+// ============================================================================
+// ENUM: ParkingResult
+// PROPÓSITO: Resultado de una solicitud. resultText() da la respuesta
+//            equivalente del protocolo de texto
+// ============================================================================
+enum ParkingResult {
+    RESULT_NONE = 0,
+    RESULT_PARKED,             // "OK: Vehiculo estacionado"
+    RESULT_LEFT,               // "OK: Vehiculo salio. Plaza liberada"
+    RESULT_RESIZED,            // "OK: Capacidad ampliada"
+    RESULT_STATUS,             // "OK: Plazas N | Ocupadas N | ..."
+    RESULT_HELLO,              // Versión aceptada
+    ERROR_FORMAT = 0x40,
+    ERROR_PLATE,
+    ERROR_SPOT,
+    ERROR_OCCUPIED,
+    ERROR_CAPACITY,
+    ERROR_SHRINK,
+    ERROR_VERSION,
+    ERROR_STORAGE              // El WAL falló: el cambio no se guardó (wal.h)
+};
+
+struct BinaryMessage {
+    uint8_t op;
+    uint8_t result;
+    uint32_t spot;
+    uint32_t plate;
+    uint32_t aux;
+    int64_t timestamp;
+};
+
+// Serializan campo a campo (no dependen del padding ni del endianness)
+void encodeBinaryMessage(const BinaryMessage& message, char* out);
+void decodeBinaryMessage(const char* in, BinaryMessage& message);
+
+// Texto del protocolo de texto para cada resultado. Devuelve siempre el
+// mismo puntero para un mismo resultado ("ERROR: Desconocido" si no existe)
+const char* resultText(int result);
+
+#endif
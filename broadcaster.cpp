@@ -0,0 +1,502 @@
+#include "broadcaster.h"
+#include "async_log.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <stdio.h>
+#include <string.h>
+
+using namespace std;
+
+// Cada cuánto se reintenta escribir a un cliente cuyo socket estaba lleno
+#define BLOCKED_RETRY_MS 2
+
+static SlowConsumerPolicy slowPolicy = SLOW_COALESCE;
+static size_t maxBatches = DEFAULT_OUTBOUND_BATCHES;
+static int tickInterval = 0;
+static atomic<unsigned long long> lastConnectionId(0);
+
+bool parseSlowConsumerPolicy(const string& name, SlowConsumerPolicy& policy) {
+    if (name == "descartar") {
+        policy = SLOW_DROP;
+    } else if (name == "coalescer") {
+        policy = SLOW_COALESCE;
+    } else if (name == "desconectar") {
+        policy = SLOW_DISCONNECT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* slowConsumerPolicyName(SlowConsumerPolicy policy) {
+    switch (policy) {
+        case SLOW_DROP: return "descartar";
+        case SLOW_COALESCE: return "coalescer";
+        default: return "desconectar";
+    }
+}
+
+void configureBroadcast(SlowConsumerPolicy policy, size_t maxQueuedBatches, int tickMs) {
+    slowPolicy = policy;
+    maxBatches = (maxQueuedBatches == 0) ? 1 : maxQueuedBatches;
+    tickInterval = (tickMs < 0) ? 0 : tickMs;
+}
+
+int broadcastTickMs() {
+    return tickInterval;
+}
+
+unsigned long long newConnectionId() {
+    return lastConnectionId.fetch_add(1, memory_order_relaxed) + 1;
+}
+
+// "<tag>:<secuencia>:<texto>" para los suscriptores (ver buildSubscription)
+static void encodeSequenced(FrameMode mode, const char* tag, unsigned long long sequence, const char* text,
+                            size_t length, string& out) {
+    char buffer[MAX_DELTA_FRAME + 32];
+    int prefix = snprintf(buffer, sizeof(buffer), "%s:%llu:", tag, sequence);
+    memcpy(buffer + prefix, text, length);
+    StreamFramer::encode(mode, buffer, (size_t)prefix + length, out);
+}
+
+// Añade a out updates[0..count) con el encuadre mode:
+//   - delta = false: un mensaje por actualización
+//   - delta = true:  tramas "DELTA:a|b|..." cortadas en MAX_DELTA_FRAME bytes
+// Con sequenced, cada mensaje lleva "EV:<secuencia>:". En un DELTA de
+// varias tramas todas llevan la secuencia más alta, pero solo la última
+// es "EV": las anteriores son "EVP" (parcial) y el cliente no avanza su
+// secuencia con ellas. Si se corta a mitad, reanuda desde la anterior
+static void encodeFrames(FrameMode mode, const ParkingUpdate* updates, size_t count, bool delta,
+                         bool sequenced, string& out) {
+    // Los clientes binarios reciben un mensaje fijo por actualización
+    if (mode == FRAME_BINARY) {
+        for (size_t i = 0; i < count; ++i) {
+            encodeBinaryUpdate(updates[i], out);
+        }
+        return;
+    }
+
+    if (!delta) {
+        for (size_t i = 0; i < count; ++i) {
+            if (sequenced) {
+                encodeSequenced(mode, "EV", updates[i].sequence, updates[i].text, updates[i].length, out);
+            } else {
+                StreamFramer::encode(mode, updates[i].text, updates[i].length, out);
+            }
+        }
+        return;
+    }
+
+    unsigned long long sequence = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sequence = max(sequence, updates[i].sequence);
+    }
+
+    string frame;
+    for (size_t i = 0; i < count; ++i) {
+        frame.append(frame.empty() ? "DELTA:" : "|");
+        frame.append(updates[i].text, updates[i].length);
+
+        bool last = (i + 1 == count);
+        if (!last && frame.size() + 1 + updates[i + 1].length <= MAX_DELTA_FRAME) continue;
+        if (sequenced) {
+            encodeSequenced(mode, last ? "EV" : "EVP", sequence, frame.data(), frame.size(), out);
+        } else {
+            StreamFramer::encode(mode, frame.data(), frame.size(), out);
+        }
+        frame.clear();
+    }
+}
+
+static PayloadPtr buildPayload(const ParkingUpdate* updates, size_t count, bool delta) {
+    shared_ptr<BroadcastPayload> payload = make_shared<BroadcastPayload>();
+    payload->updates.assign(updates, updates + count);
+    encodeFrames(FRAME_LINE, updates, count, delta, false, payload->lineFrames);
+    encodeFrames(FRAME_LENGTH, updates, count, delta, false, payload->lengthFrames);
+    encodeFrames(FRAME_LINE, updates, count, delta, true, payload->sequencedLineFrames);
+    encodeFrames(FRAME_LENGTH, updates, count, delta, true, payload->sequencedLengthFrames);
+    encodeFrames(FRAME_BINARY, updates, count, delta, false, payload->binaryFrames);
+    if (!delta) payload->origin = updates[0].origin;
+    return payload;
+}
+
+void makeOrderedPayloads(const vector<ParkingUpdate>& updates, vector<PayloadPtr>& out) {
+    size_t first = 0;
+    for (size_t i = 1; i <= updates.size(); ++i) {
+        if (i < updates.size() && updates[i].origin == updates[first].origin) continue;
+        out.push_back(buildPayload(&updates[first], i - first, false));
+        first = i;
+    }
+}
+
+PayloadPtr collectDeltaPayload() {
+    static vector<ParkingUpdate> updates;
+    if (!collectDelta(updates)) return nullptr;
+    return buildPayload(updates.data(), updates.size(), true);
+}
+
+// ============================================================================
+// OutboundQueue
+// ============================================================================
+OutboundQueue::OutboundQueue()
+    : offset(0), queuedBatches(0), queuedBytes(0), frameMode(FRAME_RAW), sequenced(false), droppedBatches(0) {}
+
+const string& OutboundQueue::bytesOf(const Item& item) const {
+    return item.payload ? item.payload->framesFor(item.mode, item.sequenced) : item.own;
+}
+
+void OutboundQueue::mergeUpdates(const PayloadPtr& payload) {
+    for (const ParkingUpdate& update : payload->updates) {
+        coalesced[update.spot] = update;
+    }
+}
+
+// Pasa al mapa de estado todos los lotes que aún no se empezaron a enviar
+void OutboundQueue::coalesceQueued() {
+    deque<Item> kept;
+    for (size_t i = 0; i < items.size(); ++i) {
+        Item& item = items[i];
+        bool started = (i == 0 && offset > 0);
+        if (item.payload && !started) {
+            mergeUpdates(item.payload);
+            queuedBatches--;
+            queuedBytes -= bytesOf(item).size();
+        } else {
+            kept.push_back(move(item));
+        }
+    }
+    items.swap(kept);
+}
+
+bool OutboundQueue::pushUpdates(const PayloadPtr& payload) {
+    // Mientras haya estado coalescido pendiente, lo nuevo se suma a él para
+    // no enviar un evento antes que otro anterior de la misma plaza
+    if (!coalesced.empty()) {
+        mergeUpdates(payload);
+        return true;
+    }
+
+    const string& bytes = payload->framesFor(frameMode, sequenced);
+    bool full = queuedBatches >= maxBatches || pendingBytes() + bytes.size() > MAX_PENDING_OUTPUT;
+    if (!full) {
+        items.push_back(Item{payload, frameMode, sequenced, string()});
+        queuedBatches++;
+        queuedBytes += bytes.size();
+        return true;
+    }
+
+    // Un suscriptor cuenta con recibir todas las secuencias: en lugar de
+    // perder lotes sin que lo sepa, recibe el último estado de cada plaza
+    SlowConsumerPolicy policy = (slowPolicy == SLOW_DROP && sequenced) ? SLOW_COALESCE : slowPolicy;
+    switch (policy) {
+        case SLOW_DROP:
+            droppedBatches++;
+            return true;
+        case SLOW_COALESCE:
+            coalesceQueued();
+            mergeUpdates(payload);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool OutboundQueue::pushOwn(const char* data, size_t length, bool bounded) {
+    if (bounded && pendingBytes() + length > MAX_PENDING_OUTPUT) return false;
+
+    // Respuestas consecutivas comparten un mismo tramo
+    if (items.empty() || items.back().payload) {
+        items.push_back(Item{nullptr, frameMode, sequenced, string()});
+    }
+    items.back().own.append(data, length);
+    queuedBytes += length;
+    return true;
+}
+
+bool OutboundQueue::peek(const char*& data, size_t& length) {
+    if (items.empty()) {
+        if (coalesced.empty()) return false;
+
+        // Enviar el último estado de cada plaza, en orden de secuencia
+        // (una ampliación llega antes que las plazas nuevas). Un suscriptor
+        // lo recibe como DELTA: su secuencia cubre los eventos que se
+        // saltan, así que no lo toma por un hueco
+        Item item{nullptr, frameMode, sequenced, string()};
+        FrameMode mode = (frameMode == FRAME_RAW) ? FRAME_LINE : frameMode;
+        vector<ParkingUpdate> updates;
+        updates.reserve(coalesced.size());
+        for (const auto& entry : coalesced) updates.push_back(entry.second);
+        stable_sort(updates.begin(), updates.end(),
+                    [](const ParkingUpdate& a, const ParkingUpdate& b) { return a.sequence < b.sequence; });
+        encodeFrames(mode, updates.data(), updates.size(), tickInterval > 0 || sequenced, sequenced, item.own);
+        coalesced.clear();
+        queuedBytes += item.own.size();
+        items.push_back(move(item));
+    }
+
+    const string& bytes = bytesOf(items.front());
+    data = bytes.data() + offset;
+    length = bytes.size() - offset;
+    return true;
+}
+
+void OutboundQueue::consume(size_t n) {
+    offset += n;
+    size_t size = bytesOf(items.front()).size();
+    if (offset < size) return;
+
+    queuedBytes -= size;
+    if (items.front().payload) queuedBatches--;
+    items.pop_front();
+    offset = 0;
+}
+
+// ============================================================================
+// Escritura sin bloqueo
+// ============================================================================
+FlushResult flushQueue(SOCKET socket, OutboundQueue& queue) {
+    const char* data;
+    size_t length;
+    while (queue.peek(data, length)) {
+        int sent = (int)send(socket, data, (int)length, SEND_NOWAIT_FLAGS);
+        if (sent > 0) {
+            queue.consume((size_t)sent);
+            continue;
+        }
+        if (sent == SOCKET_ERROR && socketWouldBlock()) return FLUSH_BLOCKED;
+        return FLUSH_ERROR;
+    }
+    return FLUSH_DONE;
+}
+
+FlushResult sendOrQueue(SOCKET socket, OutboundQueue& queue, const char* data, size_t length,
+                        bool bounded) {
+    if (queue.empty()) {
+        while (length > 0) {
+            int sent = (int)send(socket, data, (int)length, SEND_NOWAIT_FLAGS);
+            if (sent > 0) {
+                data += sent;
+                length -= (size_t)sent;
+                continue;
+            }
+            if (sent == SOCKET_ERROR && socketWouldBlock()) break;
+            return FLUSH_ERROR;
+        }
+        if (length == 0) return FLUSH_DONE;
+    }
+    return queue.pushOwn(data, length, bounded) ? FLUSH_BLOCKED : FLUSH_ERROR;
+}
+
+// ============================================================================
+// Motor hilos: suscriptores y hilo de difusión
+// ============================================================================
+struct Subscriber {
+    SOCKET socket;
+    unsigned long long id;   // newConnectionId
+    mutex lock;              // Protege queue y closing, y serializa los send
+    OutboundQueue queue;
+    bool closing;
+};
+
+// Orden de los locks: subscribersMutex y luego Subscriber::lock
+static mutex subscribersMutex;
+static condition_variable wakeWriter;
+static vector<SubscriberPtr> subscribers;
+static bool pendingWork = false;
+static bool broadcasterRunning = false;
+static thread broadcasterThread;
+
+// Se llama con subscriber.lock tomado. shutdown hace que el recv() de
+// handleClient retorne 0; el socket lo cierra ese hilo
+static void disconnect(Subscriber& subscriber, const char* reason) {
+    if (subscriber.closing) return;
+    subscriber.closing = true;
+    logWarning(subscriber.socket, reason);
+    shutdownSocket(subscriber.socket);
+}
+
+static void wake() {
+    lock_guard<mutex> guard(subscribersMutex);
+    pendingWork = true;
+    wakeWriter.notify_one();
+}
+
+// Encola el payload para todos excepto su origen (con subscribersMutex tomado)
+static void enqueueAll(const PayloadPtr& payload) {
+    for (const SubscriberPtr& subscriber : subscribers) {
+        if (subscriber->id == payload->origin) continue;
+
+        lock_guard<mutex> lock(subscriber->lock);
+        if (subscriber->closing) continue;
+        if (!subscriber->queue.pushUpdates(payload)) {
+            disconnect(*subscriber, "no consume sus mensajes, se desconecta");
+        }
+    }
+    pendingWork = true;
+}
+
+static void writerLoop() {
+    typedef chrono::steady_clock Clock;
+    vector<SubscriberPtr> snapshot;
+    bool anyBlocked = false;
+    Clock::time_point nextTick = Clock::now() + chrono::milliseconds(tickInterval);
+
+    unique_lock<mutex> guard(subscribersMutex);
+    while (true) {
+        auto ready = [] { return pendingWork || !broadcasterRunning; };
+        if (tickInterval > 0) {
+            Clock::time_point deadline = nextTick;
+            if (anyBlocked) deadline = min(deadline, Clock::now() + chrono::milliseconds(BLOCKED_RETRY_MS));
+            wakeWriter.wait_until(guard, deadline, ready);
+        } else if (anyBlocked) {
+            wakeWriter.wait_for(guard, chrono::milliseconds(BLOCKED_RETRY_MS), ready);
+        } else {
+            wakeWriter.wait(guard, ready);
+        }
+        if (!broadcasterRunning) break;
+
+        // TICK: una sola trama con el estado final de lo que cambió
+        if (tickInterval > 0 && Clock::now() >= nextTick) {
+            guard.unlock();
+            PayloadPtr delta = collectDeltaPayload();    // Toma todas las zonas
+            guard.lock();
+            if (delta) enqueueAll(delta);
+
+            nextTick += chrono::milliseconds(tickInterval);
+            if (nextTick < Clock::now()) nextTick = Clock::now() + chrono::milliseconds(tickInterval);
+        }
+
+        pendingWork = false;
+        snapshot.assign(subscribers.begin(), subscribers.end());
+        guard.unlock();
+
+        // Los send no bloquean: un cliente lento solo deja datos en su cola
+        anyBlocked = false;
+        for (const SubscriberPtr& subscriber : snapshot) {
+            lock_guard<mutex> lock(subscriber->lock);
+            if (subscriber->closing || subscriber->queue.empty()) continue;
+
+            FlushResult result = flushQueue(subscriber->socket, subscriber->queue);
+            if (result == FLUSH_BLOCKED) {
+                anyBlocked = true;
+            } else if (result == FLUSH_ERROR) {
+                disconnect(*subscriber, "desconectado durante broadcast");
+            }
+        }
+        snapshot.clear();
+
+        guard.lock();
+    }
+}
+
+// Publicador de los motores hilos y pool (ver setEventPublisher): los
+// payloads se encolan en orden, con subscribersMutex tomado una sola vez
+static void publishToSubscribers(vector<ParkingUpdate>& updates, void*) {
+    // Codificar fuera de subscribersMutex
+    static vector<PayloadPtr> payloads;    // Solo desde publishEvents
+    makeOrderedPayloads(updates, payloads);
+
+    lock_guard<mutex> guard(subscribersMutex);
+    for (const PayloadPtr& payload : payloads) {
+        enqueueAll(payload);
+    }
+    wakeWriter.notify_one();
+    payloads.clear();
+}
+
+void startBroadcaster() {
+    {
+        lock_guard<mutex> guard(subscribersMutex);
+        if (broadcasterRunning) return;
+        broadcasterRunning = true;
+        broadcasterThread = thread(writerLoop);
+    }
+    // En modo ticks los cambios salen en el siguiente tick
+    if (tickInterval == 0) setEventPublisher(publishToSubscribers, nullptr);
+}
+
+void stopBroadcaster() {
+    {
+        lock_guard<mutex> guard(subscribersMutex);
+        if (!broadcasterRunning) return;
+        broadcasterRunning = false;
+        wakeWriter.notify_one();
+    }
+    setEventPublisher(nullptr, nullptr);
+    broadcasterThread.join();
+}
+
+SubscriberPtr addSubscriber(SOCKET socket) {
+    SubscriberPtr subscriber = make_shared<Subscriber>();
+    subscriber->socket = socket;
+    subscriber->id = newConnectionId();
+    subscriber->closing = false;
+    enableNonBlockingSend(socket);
+
+    lock_guard<mutex> guard(subscribersMutex);
+    subscribers.push_back(subscriber);
+    return subscriber;
+}
+
+unsigned long long subscriberId(const SubscriberPtr& subscriber) {
+    return subscriber->id;
+}
+
+void removeSubscriber(const SubscriberPtr& subscriber) {
+    {
+        lock_guard<mutex> guard(subscribersMutex);
+        auto it = find(subscribers.begin(), subscribers.end(), subscriber);
+        if (it != subscribers.end()) {
+            *it = subscribers.back();
+            subscribers.pop_back();
+        }
+    }
+
+    // El hilo de difusión puede tener aún una copia: closing le impide
+    // escribir en el socket una vez que el dueño lo cierre
+    lock_guard<mutex> lock(subscriber->lock);
+    subscriber->closing = true;
+}
+
+void setSubscriberMode(const SubscriberPtr& subscriber, FrameMode mode) {
+    lock_guard<mutex> lock(subscriber->lock);
+    subscriber->queue.setMode(mode);
+}
+
+void sendToSubscriber(const SubscriberPtr& subscriber, const char* data, size_t length) {
+    FlushResult result;
+    {
+        lock_guard<mutex> lock(subscriber->lock);
+        if (subscriber->closing) return;
+
+        result = sendOrQueue(subscriber->socket, subscriber->queue, data, length);
+        if (result == FLUSH_ERROR) {
+            disconnect(*subscriber, "no consume sus mensajes, se desconecta");
+        }
+    }
+    if (result == FLUSH_BLOCKED) wake();
+}
+
+void subscribeClient(const SubscriberPtr& subscriber, long long resumeFrom, FrameMode mode) {
+    FlushResult result;
+    {
+        // Con subscriber.lock tomado ninguna difusión se cuela entre el
+        // snapshot y las marcas de secuencia: lo que llegue después ya
+        // se encola con "EV:" y el cliente descarta lo que ya cubre
+        lock_guard<mutex> lock(subscriber->lock);
+        if (subscriber->closing) return;
+
+        string reply;
+        buildSubscription(resumeFrom, mode, reply);    // Un snapshot toma todas las zonas
+        subscriber->queue.setSequenced(true);
+        result = sendOrQueue(subscriber->socket, subscriber->queue, reply.data(), reply.size(), false);
+        if (result == FLUSH_ERROR) {
+            disconnect(*subscriber, "desconectado durante el snapshot");
+        }
+    }
+    if (result == FLUSH_BLOCKED) wake();
+}
@@ -0,0 +1,213 @@
+// ============================================================================
+// ARCHIVO: broadcaster.h
+// PROPÓSITO: Difusión de las actualizaciones a los clientes conectados
+// DESCRIPCIÓN: Cada lote de actualizaciones se codifica UNA vez en un
+//              BroadcastPayload inmutable que comparten todos los clientes
+//              (shared_ptr, con contador de referencias). Cada cliente tiene
+//              su propia cola de salida acotada (OutboundQueue) y los
+//              sockets se escriben sin bloquear, así que un cliente lento
+//              (p. ej. el visualizador detenido en un diálogo) no retrasa
+//              a los demás ni a accept().
+//
+// POLÍTICA PARA CLIENTES LENTOS (cuando su cola se llena):
+//   - SLOW_DROP ("descartar"):        se descartan los lotes nuevos (a un
+//                                     suscriptor, que no debe perder
+//                                     secuencias, se le coalesce)
+//   - SLOW_COALESCE ("coalescer"):    lo pendiente se reduce al último
+//                                     estado de cada plaza (un suscriptor
+//                                     lo recibe como un DELTA numerado)
+//   - SLOW_DISCONNECT ("desconectar"): se desconecta al cliente
+// Las respuestas a las solicitudes del propio cliente nunca se descartan:
+// si no las lee y superan MAX_PENDING_OUTPUT, se le desconecta.
+//
+// MODO TICKS (tickMs > 0): en lugar de un mensaje por evento, cada tick se
+// difunde una trama "DELTA:1:ABC123:2024-11-25 14:30:45|7:SALIDA|..." con
+// el estado final de cada plaza que cambió en ese intervalo (ver
+// collectDelta). Una plaza que cambió varias veces aparece una sola vez.
+//
+// USO:
+//   - Motores epoll y uring: una OutboundQueue por conexión (la usa solo
+//                  el hilo de su bucle, ver loop_inbox.h)
+//   - Motor hilos: las funciones *Subscriber* y un hilo de difusión que
+//                  escribe en todos los sockets
+// ============================================================================
+
+#ifndef BROADCASTER_H
+#define BROADCASTER_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "framing.h"
+#include "net_compat.h"
+#include "parking_protocol.h"
+
+// Máximo de bytes pendientes de envío por cliente
+#define MAX_PENDING_OUTPUT (1024 * 1024)
+
+// Lotes de difusión que puede acumular un cliente por defecto
+#define DEFAULT_OUTBOUND_BATCHES 256
+
+// Tamaño máximo de una trama DELTA (un tick con más cambios usa varias)
+#define MAX_DELTA_FRAME 4096
+
+enum SlowConsumerPolicy {
+    SLOW_DROP,
+    SLOW_COALESCE,
+    SLOW_DISCONNECT
+};
+
+// "descartar", "coalescer" o "desconectar"; false si el nombre no existe
+bool parseSlowConsumerPolicy(const std::string& name, SlowConsumerPolicy& policy);
+const char* slowConsumerPolicyName(SlowConsumerPolicy policy);
+
+// Política, tamaño de cola y tick comunes a todos los clientes (antes de
+// arrancar). tickMs = 0: cada lote se difunde en el acto
+void configureBroadcast(SlowConsumerPolicy policy, size_t maxQueuedBatches, int tickMs);
+int broadcastTickMs();
+
+// ============================================================================
+// ESTRUCTURA: BroadcastPayload
+// PROPÓSITO: Un lote de actualizaciones ya codificado en los dos encuadres
+//            delimitados (los clientes RAW reciben líneas), con y sin
+//            número de secuencia, y como mensajes binarios
+// ============================================================================
+struct BroadcastPayload {
+    std::string lineFrames;
+    std::string lengthFrames;
+    std::string sequencedLineFrames;       // Con "EV:<secuencia>:" (suscriptores)
+    std::string sequencedLengthFrames;
+    std::string binaryFrames;              // Un mensaje de 24 bytes por actualización
+    std::vector<ParkingUpdate> updates;    // Para coalescer por plaza
+    unsigned long long origin = 0;         // Conexión que no lo recibe (0 = ninguna)
+
+    const std::string& framesFor(FrameMode mode, bool sequenced) const
+    {
+        if (mode == FRAME_BINARY)
+        {
+            return binaryFrames;
+        }
+        if (sequenced)
+        {
+            return (mode == FRAME_LENGTH) ? sequencedLengthFrames : sequencedLineFrames;
+        }
+        return (mode == FRAME_LENGTH) ? lengthFrames : lineFrames;
+    }
+};
+
+typedef std::shared_ptr<const BroadcastPayload> PayloadPtr;
+
+// Identificador para ParkingBatch::origin. A diferencia del socket, nunca
+// se reutiliza: una difusión que llega tarde no se salta a otro cliente
+unsigned long long newConnectionId();
+
+// Codifica los eventos ya en orden de secuencia (ver publishEvents): un
+// payload por tramo de eventos consecutivos con el mismo origen
+void makeOrderedPayloads(const std::vector<ParkingUpdate>& updates, std::vector<PayloadPtr>& out);
+
+// Tramas DELTA con los cambios del último tick; nullptr si no hubo cambios
+PayloadPtr collectDeltaPayload();
+
+// ============================================================================
+// CLASE: OutboundQueue
+// PROPÓSITO: Bytes pendientes de enviar a un cliente. No es thread-safe:
+//            la protege quien la usa
+// ============================================================================
+class OutboundQueue {
+private:
+    struct Item {
+        PayloadPtr payload;    // Lote compartido, o nullptr si es propio
+        FrameMode mode;        // Encuadre elegido al encolar
+        bool sequenced;        // Con número de secuencia (suscriptor)
+        std::string own;       // Respuestas del propio cliente
+    };
+
+    std::deque<Item> items;
+    size_t offset;             // Bytes ya enviados de items.front()
+    size_t queuedBatches;      // Lotes de difusión en items
+    size_t queuedBytes;
+    FrameMode frameMode;
+    bool sequenced;            // El cliente envió SUSCRIBIR
+
+    // Último estado de cada plaza mientras se coalesce (-1 = CAPACIDAD)
+    std::map<int, ParkingUpdate> coalesced;
+
+    unsigned long long droppedBatches;
+
+    const std::string& bytesOf(const Item& item) const;
+    void coalesceQueued();
+    void mergeUpdates(const PayloadPtr& payload);
+
+public:
+    OutboundQueue();
+
+    // Encuadre del cliente (se detecta con sus primeros bytes)
+    void setMode(FrameMode mode) { frameMode = mode; }
+
+    // Desde SUSCRIBIR las difusiones llevan "EV:<secuencia>:"
+    void setSequenced(bool value) { sequenced = value; }
+
+    bool empty() const { return items.empty() && coalesced.empty(); }
+    size_t pendingBytes() const { return queuedBytes - offset; }
+    unsigned long long dropped() const { return droppedBatches; }
+
+    // Encola un lote de difusión aplicando la política si la cola está
+    // llena. RETORNA: false si hay que desconectar al cliente
+    bool pushUpdates(const PayloadPtr& payload);
+
+    // Encola una respuesta propia. RETORNA: false si se supera
+    // MAX_PENDING_OUTPUT (hay que desconectar al cliente). Con bounded =
+    // false no hay límite (un snapshot puede ser más grande)
+    bool pushOwn(const char* data, size_t length, bool bounded = true);
+
+    // Siguiente tramo a enviar; false si no queda nada
+    bool peek(const char*& data, size_t& length);
+
+    // Marca n bytes del tramo actual como enviados
+    void consume(size_t n);
+};
+
+// ============================================================================
+// FUNCIÓN: flushQueue / sendOrQueue
+// PROPÓSITO: Escriben sin bloquear (SEND_NOWAIT_FLAGS) todo lo posible.
+//            sendOrQueue envía directamente si la cola está vacía y solo
+//            encola lo que el socket no aceptó
+// ============================================================================
+enum FlushResult {
+    FLUSH_DONE,       // Cola vacía
+    FLUSH_BLOCKED,    // Queda algo: esperar a que el socket admita más
+    FLUSH_ERROR       // Conexión rota o cliente a desconectar
+};
+
+FlushResult flushQueue(SOCKET socket, OutboundQueue& queue);
+FlushResult sendOrQueue(SOCKET socket, OutboundQueue& queue, const char* data, size_t length,
+                        bool bounded = true);
+
+// ============================================================================
+// MOTOR HILOS: suscriptores y hilo de difusión
+// NOTA: removeSubscriber() debe llamarse ANTES de closesocket(), así el hilo
+//       de difusión nunca escribe en un descriptor reutilizado
+// ============================================================================
+struct Subscriber;
+typedef std::shared_ptr<Subscriber> SubscriberPtr;
+
+// Sin ticks, startBroadcaster registra la publicación a los suscriptores
+// (ver setEventPublisher) y stopBroadcaster la retira
+void startBroadcaster();
+void stopBroadcaster();
+
+SubscriberPtr addSubscriber(SOCKET socket);
+unsigned long long subscriberId(const SubscriberPtr& subscriber);
+void removeSubscriber(const SubscriberPtr& subscriber);
+void setSubscriberMode(const SubscriberPtr& subscriber, FrameMode mode);
+
+// Respuestas del propio cliente (se intenta enviar en el acto)
+void sendToSubscriber(const SubscriberPtr& subscriber, const char* data, size_t length);
+
+// Responde a SUSCRIBIR (ver buildSubscription) y, a partir de ahí, envía
+// al cliente las difusiones con número de secuencia
+void subscribeClient(const SubscriberPtr& subscriber, long long resumeFrom, FrameMode mode);
+
+#endif
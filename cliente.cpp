@@ -1,256 +1,472 @@
-// ============================================================================
-// ARCHIVO: cliente.cpp
-// PROPÓSITO: Cliente que genera placas automáticamente y las envía al servidor
-// DESCRIPCIÓN: Conecta al servidor de parqueadero y envía placas aleatorias
-//              cada 2-5 segundos automáticamente
-// ============================================================================
-
-#include <iostream>
-#include <WinSock2.h>   // Librería de sockets de Windows
-#include <WS2tcpip.h>   // Funciones adicionales de TCP/IP
-#include <string>       // Para usar std::string
-#include <cstdlib>      // Para rand() y srand()
-#include <ctime>        // Para time() (semilla aleatoria)
-
-// Vincular la librería de sockets de Windows
-#pragma comment(lib, "ws2_32.lib")
-
-// Definir el puerto del servidor (debe coincidir con servidor.cpp)
-#define PORT 8080
-
-using namespace std;
-
-// ============================================================================
-// FUNCIÓN: generateRandomPlate
-// PROPÓSITO: Genera una placa aleatoria con formato AAA000
-// RETORNA: String con 3 letras mayúsculas + 3 números (ej: "XYZ789")
-// ============================================================================
-string generateRandomPlate() {
-	string plate = "";
-	
-	// GENERAR 3 LETRAS ALEATORIAS (A-Z)
-	// ----------------------------------
-	// 'A' tiene código ASCII 65
-	// rand() % 26 genera números entre 0 y 25
-	// 'A' + 0 = 'A', 'A' + 1 = 'B', ... 'A' + 25 = 'Z'
-	for (int i = 0; i < 3; i++) {
-		plate += (char)('A' + rand() % 26);
-	}
-	
-	// GENERAR 3 NÚMEROS ALEATORIOS (0-9)
-	// -----------------------------------
-	// '0' tiene código ASCII 48
-	// rand() % 10 genera números entre 0 y 9
-	// '0' + 0 = '0', '0' + 1 = '1', ... '0' + 9 = '9'
-	for (int i = 0; i < 3; i++) {
-		plate += (char)('0' + rand() % 10);
-	}
-	
-	return plate;
-}
-
-// ============================================================================
-// FUNCIÓN: generateRandomSpot
-// PROPÓSITO: Genera un número de plaza aleatorio entre 1 y 40
-// RETORNA: Entero entre 1 y 40
-// ============================================================================
-int generateRandomSpot() {
-	// rand() % 40 genera 0-39, sumamos 1 para obtener 1-40
-	return (rand() % 40) + 1;
-}
-
-int main()
-{
-	// INICIALIZAR GENERADOR DE NÚMEROS ALEATORIOS
-	// --------------------------------------------
-	// srand() establece la "semilla" del generador aleatorio
-	// time(0) = segundos desde 1970 (siempre diferente)
-	// Sin esto, rand() generaría siempre los mismos números
-	srand(static_cast<unsigned int>(time(0)));
-	
-	// VARIABLES PARA SOCKETS
-	// ----------------------
-	WSADATA wsaData;               // Información de Winsock
-	SOCKET sock = INVALID_SOCKET;  // Socket del cliente
-	struct sockaddr_in serv_addr;  // Dirección del servidor
-	char buffer[1024] = { 0 };     // Buffer para recibir respuestas
-
-	// ========================================================================
-	// PASO 1: INICIALIZAR WINSOCK
-	// ========================================================================
-	// WSAStartup inicializa la librería de sockets de Windows
-	// MAKEWORD(2, 2) = versión 2.2 de Winsock
-	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
-	{
-		cerr << "Fallo al inicializar el winsock. Código de error: " << WSAGetLastError() << endl;
-		return 1;
-	}
-
-	// ========================================================================
-	// PASO 2: CREAR SOCKET
-	// ========================================================================
-	// socket() crea un nuevo socket
-	// AF_INET = IPv4
-	// SOCK_STREAM = TCP (conexión confiable)
-	// 0 = protocolo automático
-	sock = socket(AF_INET, SOCK_STREAM, 0);
-	if (sock == INVALID_SOCKET)
-	{
-		cerr << "Fallo el socket. Código de error: " << WSAGetLastError() << endl;
-		WSACleanup();
-		return 1;
-	}
-
-	// ========================================================================
-	// PASO 3: CONFIGURAR DIRECCIÓN DEL SERVIDOR
-	// ========================================================================
-	serv_addr.sin_family = AF_INET;      // IPv4
-	serv_addr.sin_port = htons(PORT);    // Puerto 8080 (htons = host to network short)
-
-	// CONVERTIR DIRECCIÓN IP DE TEXTO A BINARIO
-	// ------------------------------------------
-	// inet_pton = "Internet presentation to numeric"
-	// Convierte "127.0.0.1" (texto) a formato binario
-	int result = inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr);
-	if (result <= 0)
-	{
-		cerr << "Direccion IPv4 inválida o no soportada." << endl;
-		closesocket(sock);
-		WSACleanup();
-		return 1;
-	}
-
-	// ========================================================================
-	// PASO 4: CONECTAR AL SERVIDOR
-	// ========================================================================
-	// connect() establece la conexión con el servidor
-	// Si el servidor no está ejecutándose, esto fallará
-	if (connect(sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) == SOCKET_ERROR)
-	{
-		cerr << "Fallo en connect. Código de error: " << WSAGetLastError() << endl;
-		closesocket(sock);
-		WSACleanup();
-		return 1;
-	}
-
-	cout << "\n";
-	cout << "============================================\n";
-	cout << "  CLIENTE - GENERADOR AUTOMATICO DE PLACAS\n";
-	cout << "============================================\n";
-	cout << "[OK] Conectado al servidor en puerto " << PORT << "\n";
-	cout << "[*] Generando placas automaticamente cada 2-5 segundos...\n";
-	cout << "[*] Formato: AAA000 (3 letras + 3 numeros)\n";
-	cout << "[*] Plaza aleatoria entre 1 y 40\n";
-	cout << "\n";
-
-	// ========================================================================
-	// BUCLE PRINCIPAL: GENERAR Y ENVIAR PLACAS AUTOMÁTICAMENTE
-	// ========================================================================
-	// Este bucle se ejecuta indefinidamente hasta que se cierre el programa
-	while (true)
-	{
-		// GENERAR DATOS ALEATORIOS
-		// ------------------------
-		// Generar número de plaza aleatorio (1-40)
-		int spotNum = generateRandomSpot();
-		
-		// Generar placa aleatoria (AAA000)
-		string plate = generateRandomPlate();
-
-		// OBTENER TIMESTAMP ACTUAL
-		// -------------------------
-		// time_t = tipo de dato para tiempo
-		// time(0) = obtiene el tiempo actual
-		time_t now = time(0);
-		
-		// Convertir a estructura tm para formatear
-		struct tm timeinfo;
-		localtime_s(&timeinfo, &now);
-		
-		// Formatear como "YYYY-MM-DD HH:MM:SS"
-		char timestamp[30];
-		strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
-
-		// CONSTRUIR MENSAJE EN FORMATO "PLAZA:PLACA:TIMESTAMP"
-		// -----------------------------------------------------
-		// Ejemplo: "15:XYZ789:2024-11-25 14:30:45"
-		// Incluye: número de plaza, placa del vehículo y hora exacta
-		string message = to_string(spotNum) + ":" + plate + ":" + string(timestamp);
-
-		// ENVIAR MENSAJE AL SERVIDOR
-		// ---------------------------
-		// send() envía datos por el socket
-		// message.c_str() convierte string a char* (C-style string)
-		// message.length() = número de bytes a enviar
-		send(sock, message.c_str(), static_cast<int>(message.length()), 0);
-		
-		// Mostrar lo que se envió (con timestamp)
-		cout << ">> [" << spotNum << "] Enviando:\n";
-		cout << "   Plaza: " << spotNum << "\n";
-		cout << "   Placa: " << plate << "\n";
-		cout << "   Hora: " << timestamp << endl;
-
-		// RECIBIR RESPUESTA DEL SERVIDOR
-		// -------------------------------
-		// recv() espera y recibe datos del servidor
-		// buffer = donde se guardan los datos recibidos
-		// 1024 = tamaño máximo a recibir
-		// 0 = flags (ninguno)
-		int valread = recv(sock, buffer, 1024, 0);
-		
-		// PROCESAR LA RESPUESTA
-		// ---------------------
-		if (valread > 0)
-		{
-			// valread = número de bytes recibidos
-			
-			// AGREGAR TERMINADOR NULO AL FINAL
-			// ---------------------------------
-			// Los strings en C++ necesitan '\0' al final
-			if (valread < 1024)
-			{
-				buffer[valread] = '\0';  // Terminar el string
-			}
-			else
-			{
-				buffer[1023] = '\0';  // Si el buffer está lleno, terminar en la última posición
-			}
-			
-			// Mostrar la respuesta del servidor
-			cout << "<< Respuesta: " << buffer << endl;
-			cout << "----------------------------------------\n";
-
-		}
-		else if (valread == 0)
-		{
-			// valread == 0 significa que el servidor cerró la conexión
-			cout << "[!] El servidor cerro la conexion." << endl;
-			break;  // Salir del bucle
-		}
-		else
-		{
-			// valread < 0 significa error
-			cerr << "[ERROR] Fallo en recv. Codigo de error: " << WSAGetLastError() << endl;
-			break;  // Salir del bucle
-		}
-
-		// ESPERAR TIEMPO ALEATORIO ANTES DE LA SIGUIENTE PLACA
-		// -----------------------------------------------------
-		// rand() % 3000 = número entre 0 y 2999 milisegundos
-		// 2000 + rand() % 3000 = entre 2000 y 4999 milisegundos
-		// Es decir: entre 2 y 5 segundos
-		int waitTime = 2000 + (rand() % 3001);  // 2000-5000 ms
-		cout << "** Esperando " << (waitTime / 1000.0) << " segundos...\n\n";
-		Sleep(waitTime);
-
-	}
-
-	// ========================================================================
-	// LIMPIEZA Y CIERRE
-	// ========================================================================
-	// Cuando se sale del bucle, cerrar el socket y limpiar Winsock
-	cout << "\nCerrando conexión...\n";
-	closesocket(sock);
-	WSACleanup();
-	return 0;
-}
+// ============================================================================
+// ARCHIVO: cliente.cpp
+// PROPÓSITO: Cliente que genera placas automáticamente y las envía al servidor
+// DESCRIPCIÓN: Conecta al servidor de parqueadero y envía cada 2-5 segundos
+//              el siguiente evento del modelo de tráfico (workload_model.h):
+//              entradas de una flota de placas y salidas de los vehículos
+//              que ya están dentro
+// USO: cliente [--binario] [--host IP] [--puerto N]
+//      --binario: usa el protocolo binario de 24 bytes (binary_protocol.h)
+//                 en lugar de "PLAZA:PLACA:TIMESTAMP"
+//
+//
+//      cliente --carga [--conexiones N] [--tasa EV_POR_SEG] [--llegadas poisson|fija|modelo]
+//              [--duracion SEG] [--profundidad N] [--semilla N] [--plazas N]
+//      --carga: generador de carga (load_generator.h). Abre N conexiones,
+//               envía eventos a la tasa pedida (0 = lo más rápido posible)
+//               y al final muestra throughput y percentiles de latencia
+//
+//      cliente --reproducir ARCHIVO [--velocidad N|max] [--hilos N] [--profundidad N]
+//      --reproducir: envía al servidor una traza grabada con servidor --traza
+//                    (trace_replay.h) respetando sus tiempos, N veces más
+//                    rápido o lo más rápido posible, y mide la latencia
+//
+//      Modelo de tráfico (ambos modos): [--ocupacion PORCENTAJE]
+//              [--estancia-media MIN] [--estancia lognormal|exponencial|fija]
+//              [--flota N] [--hora-inicio H]
+// ============================================================================
+
+#include <iostream>
+#include <string>       // Para usar std::string
+#include <cstdlib>      // Para rand(), srand(), atoi(), atof()
+#include <vector>
+#include <ctime>        // Para time() (semilla aleatoria)
+#include <cstring>      // Para strlen(), strcmp()
+#include <chrono>
+#include <thread>       // Para this_thread::sleep_for
+#include "net_compat.h" // Sockets Winsock2 / POSIX
+#include "binary_protocol.h"
+#include "plate_codec.h"
+#include "load_generator.h"
+#include "workload_model.h"
+#include "trace_replay.h"
+
+// Puerto por defecto del servidor (debe coincidir con servidor_multicliente.cpp)
+#define PORT 8080
+
+using namespace std;
+
+// ============================================================================
+// FUNCIÓN: recvBinary
+// PROPÓSITO: Recibe exactamente un mensaje binario (un recv puede traer
+//            solo una parte)
+// RETORNA: Bytes del último recv (<= 0 si se cerró o hubo error)
+// ============================================================================
+int recvBinary(SOCKET sock, BinaryMessage& message) {
+	char bytes[BINARY_MESSAGE_SIZE];
+	int received = 0;
+	while (received < BINARY_MESSAGE_SIZE) {
+		int valread = (int)recv(sock, bytes + received, BINARY_MESSAGE_SIZE - received, 0);
+		if (valread <= 0) {
+			return valread;
+		}
+		received += valread;
+	}
+	decodeBinaryMessage(bytes, message);
+	return received;
+}
+
+// ============================================================================
+// FUNCIÓN: recvBinaryReply
+// PROPÓSITO: Espera la respuesta a la última solicitud. Las difusiones de
+//            otros clientes que lleguen antes se ignoran
+// ============================================================================
+int recvBinaryReply(SOCKET sock, BinaryMessage& reply) {
+	while (true) {
+		int valread = recvBinary(sock, reply);
+		if (valread <= 0 || (reply.op & BIN_OP_REPLY) != 0) {
+			return valread;
+		}
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: printUsage
+// PROPÓSITO: Muestra las opciones de línea de comandos
+// ============================================================================
+void printUsage(const char* program) {
+	cerr << "Uso: " << program << " [--binario] [--host IP] [--puerto N]\n"
+	     << "     " << program << " --carga [--conexiones N] [--tasa EV_POR_SEG]"
+	     << " [--llegadas poisson|fija|modelo] [--duracion SEG] [--profundidad N]"
+	     << " [--semilla N] [--plazas N] [--binario] [--host IP] [--puerto N]\n"
+	     << "     " << program << " --reproducir ARCHIVO [--velocidad N|max] [--hilos N]"
+	     << " [--profundidad N] [--host IP] [--puerto N]\n"
+	     << "Modelo: [--ocupacion PORCENTAJE] [--estancia-media MIN]"
+	     << " [--estancia lognormal|exponencial|fija] [--flota N] [--hora-inicio H]" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	// OPCIONES: protocolo (texto o binario), servidor y modo de carga
+	LoadConfig load;
+	load.port = PORT;
+	bool loadMode = false;
+	bool seedGiven = false;
+	ReplayConfig replay;
+	bool depthGiven = false;
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--binario") == 0) {
+			load.binary = true;
+		} else if (strcmp(argv[i], "--carga") == 0) {
+			loadMode = true;
+		} else if (strcmp(argv[i], "--reproducir") == 0 && hasValue) {
+			replay.path = argv[++i];
+		} else if (strcmp(argv[i], "--velocidad") == 0 && hasValue) {
+			++i;
+			replay.speed = strcmp(argv[i], "max") == 0 ? 0.0 : atof(argv[i]);
+			if (replay.speed <= 0 && strcmp(argv[i], "max") != 0) {
+				printUsage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--hilos") == 0 && hasValue) {
+			replay.threads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--host") == 0 && hasValue) {
+			load.host = argv[++i];
+		} else if (strcmp(argv[i], "--puerto") == 0 && hasValue) {
+			load.port = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--conexiones") == 0 && hasValue) {
+			load.connections = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--tasa") == 0 && hasValue) {
+			load.rate = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--llegadas") == 0 && hasValue) {
+			++i;
+			if (strcmp(argv[i], "poisson") == 0) {
+				load.arrivals = ARRIVALS_POISSON;
+			} else if (strcmp(argv[i], "fija") == 0) {
+				load.arrivals = ARRIVALS_FIXED;
+			} else if (strcmp(argv[i], "modelo") == 0) {
+				load.arrivals = ARRIVALS_MODEL;
+			} else {
+				printUsage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--duracion") == 0 && hasValue) {
+			load.durationSeconds = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--profundidad") == 0 && hasValue) {
+			load.depth = atoi(argv[++i]);
+			depthGiven = true;
+		} else if (strcmp(argv[i], "--semilla") == 0 && hasValue) {
+			load.seed = strtoull(argv[++i], nullptr, 10);
+			seedGiven = true;
+		} else if (strcmp(argv[i], "--plazas") == 0 && hasValue) {
+			load.spots = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--ocupacion") == 0 && hasValue) {
+			load.workload.occupancy = atof(argv[++i]) / 100.0;
+		} else if (strcmp(argv[i], "--estancia-media") == 0 && hasValue) {
+			load.workload.meanDwellMinutes = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--estancia") == 0 && hasValue) {
+			++i;
+			if (strcmp(argv[i], "lognormal") == 0) {
+				load.workload.dwell = DWELL_LOGNORMAL;
+			} else if (strcmp(argv[i], "exponencial") == 0) {
+				load.workload.dwell = DWELL_EXPONENTIAL;
+			} else if (strcmp(argv[i], "fija") == 0) {
+				load.workload.dwell = DWELL_FIXED;
+			} else {
+				printUsage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--flota") == 0 && hasValue) {
+			load.workload.fleetSize = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--hora-inicio") == 0 && hasValue) {
+			load.workload.startHour = atoi(argv[++i]) % 24;
+		} else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	bool binary = load.binary;
+
+	// INICIALIZAR GENERADOR DE NÚMEROS ALEATORIOS
+	// --------------------------------------------
+	// srand() establece la "semilla" del generador aleatorio
+	// time(0) = segundos desde 1970 (siempre diferente)
+	// Sin esto, rand() generaría siempre los mismos números
+	// Con --semilla, los eventos se repiten de una ejecución a otra
+	unsigned long long seed = seedGiven ? load.seed : (unsigned long long)time(0);
+	srand(static_cast<unsigned int>(seed));
+	
+	// VARIABLES PARA SOCKETS
+	// ----------------------
+	SOCKET sock = INVALID_SOCKET;  // Socket del cliente
+	struct sockaddr_in serv_addr;  // Dirección del servidor
+	char buffer[1024] = { 0 };     // Buffer para recibir respuestas
+
+	// ========================================================================
+	// PASO 1: INICIALIZAR SOCKETS (WSAStartup en Windows)
+	// ========================================================================
+	if (!initSockets())
+	{
+		cerr << "Fallo al inicializar los sockets." << endl;
+		return 1;
+	}
+
+	// MODO CARGA: el generador abre sus propias conexiones
+	if (loadMode)
+	{
+		int status = runLoadGenerator(load);
+		cleanupSockets();
+		return status;
+	}
+
+	// MODO REPRODUCCIÓN: una conexión por cada conexión grabada
+	if (!replay.path.empty())
+	{
+		replay.host = load.host;
+		replay.port = load.port;
+		if (depthGiven) replay.depth = load.depth;
+		int status = runTraceReplay(replay);
+		cleanupSockets();
+		return status;
+	}
+
+	// ========================================================================
+	// PASO 2: CREAR SOCKET
+	// ========================================================================
+	// socket() crea un nuevo socket
+	// AF_INET = IPv4
+	// SOCK_STREAM = TCP (conexión confiable)
+	// 0 = protocolo automático
+	sock = socket(AF_INET, SOCK_STREAM, 0);
+	if (sock == INVALID_SOCKET)
+	{
+		cerr << "Fallo el socket." << endl;
+		cleanupSockets();
+		return 1;
+	}
+
+	// ========================================================================
+	// PASO 3: CONFIGURAR DIRECCIÓN DEL SERVIDOR
+	// ========================================================================
+	serv_addr.sin_family = AF_INET;      // IPv4
+	serv_addr.sin_port = htons((unsigned short)load.port);  // Puerto (htons = host to network short)
+
+	// CONVERTIR DIRECCIÓN IP DE TEXTO A BINARIO
+	// ------------------------------------------
+	// inet_pton = "Internet presentation to numeric"
+	// Convierte "127.0.0.1" (texto) a formato binario
+	int result = inet_pton(AF_INET, load.host.c_str(), &serv_addr.sin_addr);
+	if (result <= 0)
+	{
+		cerr << "Direccion IPv4 inválida o no soportada." << endl;
+		closesocket(sock);
+		cleanupSockets();
+		return 1;
+	}
+
+	// ========================================================================
+	// PASO 4: CONECTAR AL SERVIDOR
+	// ========================================================================
+	// connect() establece la conexión con el servidor
+	// Si el servidor no está ejecutándose, esto fallará
+	if (connect(sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) == SOCKET_ERROR)
+	{
+		cerr << "Fallo en connect." << endl;
+		closesocket(sock);
+		cleanupSockets();
+		return 1;
+	}
+
+	// ========================================================================
+	// PASO 5: NEGOCIAR EL PROTOCOLO BINARIO (si se pidió)
+	// ========================================================================
+	// El primer mensaje, BIN_OP_HELLO, le indica al servidor que toda la
+	// conexión usa mensajes de 24 bytes
+	if (binary)
+	{
+		BinaryMessage hello = {};
+		hello.op = BIN_OP_HELLO;
+		hello.aux = BINARY_PROTOCOL_VERSION;
+		char bytes[BINARY_MESSAGE_SIZE];
+		encodeBinaryMessage(hello, bytes);
+		send(sock, bytes, BINARY_MESSAGE_SIZE, 0);
+
+		BinaryMessage reply;
+		if (recvBinaryReply(sock, reply) <= 0 || reply.result != RESULT_HELLO)
+		{
+			cerr << "El servidor no acepta el protocolo binario v" << BINARY_PROTOCOL_VERSION << endl;
+			closesocket(sock);
+			cleanupSockets();
+			return 1;
+		}
+	}
+
+	cout << "\n";
+	cout << "============================================\n";
+	cout << "  CLIENTE - GENERADOR AUTOMATICO DE PLACAS\n";
+	cout << "============================================\n";
+	cout << "[OK] Conectado al servidor en puerto " << load.port << "\n";
+	cout << "[*] Generando placas automaticamente cada 2-5 segundos...\n";
+	cout << "[*] Formato: AAA000 (3 letras + 3 numeros)\n";
+	cout << "[*] Plazas 1 a " << load.spots << ", ocupacion en hora pico "
+	     << (int)(load.workload.occupancy * 100 + 0.5) << " %\n";
+	cout << "[*] Protocolo: " << (binary ? "binario (24 bytes)" : "texto") << "\n";
+	cout << "\n";
+
+	// MODELO DE TRÁFICO
+	// -----------------
+	// Primero llena el parqueadero hasta la ocupación media (entradas
+	// iniciales) y luego alterna llegadas y salidas. Solo se usa el orden
+	// de los eventos: la hora enviada es la hora real
+	vector<int> spots;
+	for (int spot = 1; spot <= load.spots; spot++)
+	{
+		spots.push_back(spot);
+	}
+	WorkloadModel model(load.workload, spots, seed, 0);
+	size_t initialSent = 0;
+
+	// ========================================================================
+	// BUCLE PRINCIPAL: GENERAR Y ENVIAR PLACAS AUTOMÁTICAMENTE
+	// ========================================================================
+	// Este bucle se ejecuta indefinidamente hasta que se cierre el programa
+	while (true)
+	{
+		// SIGUIENTE EVENTO DEL MODELO
+		// ---------------------------
+		// Una SALIDA reenvía la placa del vehículo que está en esa plaza
+		WorkloadEvent event = initialSent < model.initialEntries().size()
+			? model.initialEntries()[initialSent++]
+			: model.next();
+		int spotNum = event.spot;
+		char plateText[PLATE_RECORD_SIZE];
+		decodePlate(event.plate, plateText);
+		string plate = plateText;
+		const char* kind = event.entry ? "ENTRADA" : "SALIDA";
+
+		// OBTENER TIMESTAMP ACTUAL
+		// -------------------------
+		// Formato "YYYY-MM-DD HH:MM:SS" (hora local). secondsNow es la
+		// misma hora en segundos desde 1970, sin zona horaria: es lo que
+		// guarda el servidor
+		char timestamp[30];
+		long long secondsNow = localTimestamp(timestamp);
+
+		// PROTOCOLO BINARIO: plaza, placa y hora ya como enteros
+		// --------------------------------------------------------
+		if (binary)
+		{
+			BinaryMessage request = {};
+			request.op = BIN_OP_PARK;
+			request.spot = (uint32_t)spotNum;
+			request.plate = encodePlate(plate.c_str());
+			request.timestamp = (int64_t)secondsNow;
+			char bytes[BINARY_MESSAGE_SIZE];
+			encodeBinaryMessage(request, bytes);
+			send(sock, bytes, BINARY_MESSAGE_SIZE, 0);
+
+			cout << ">> [" << spotNum << "] Enviando " << kind << " (binario):\n";
+			cout << "   Plaza: " << spotNum << "\n";
+			cout << "   Placa: " << plate << "\n";
+			cout << "   Hora: " << timestamp << endl;
+
+			BinaryMessage reply;
+			int valread = recvBinaryReply(sock, reply);
+			if (valread <= 0)
+			{
+				cout << "[!] El servidor cerro la conexion." << endl;
+				break;
+			}
+			cout << "<< Respuesta: " << resultText(reply.result) << endl;
+			cout << "----------------------------------------\n";
+
+			int waitTime = 2000 + (rand() % 3001);  // 2000-5000 ms
+			cout << "** Esperando " << (waitTime / 1000.0) << " segundos...\n\n";
+			this_thread::sleep_for(chrono::milliseconds(waitTime));
+			continue;
+		}
+
+		// CONSTRUIR MENSAJE EN FORMATO "PLAZA:PLACA:TIMESTAMP"
+		// -----------------------------------------------------
+		// Ejemplo: "15:XYZ789:2024-11-25 14:30:45"
+		// Incluye: número de plaza, placa del vehículo y hora exacta
+		// El '\n' final delimita el mensaje: TCP puede juntar o partir
+		// varios send() y el servidor separa los mensajes por líneas
+		string message = to_string(spotNum) + ":" + plate + ":" + string(timestamp) + "\n";
+
+		// ENVIAR MENSAJE AL SERVIDOR
+		// ---------------------------
+		// send() envía datos por el socket
+		// message.c_str() convierte string a char* (C-style string)
+		// message.length() = número de bytes a enviar
+		send(sock, message.c_str(), static_cast<int>(message.length()), 0);
+		
+		// Mostrar lo que se envió (con timestamp)
+		cout << ">> [" << spotNum << "] Enviando " << kind << ":\n";
+		cout << "   Plaza: " << spotNum << "\n";
+		cout << "   Placa: " << plate << "\n";
+		cout << "   Hora: " << timestamp << endl;
+
+		// RECIBIR RESPUESTA DEL SERVIDOR
+		// -------------------------------
+		// recv() espera y recibe datos del servidor
+		// buffer = donde se guardan los datos recibidos
+		// 1024 = tamaño máximo a recibir
+		// 0 = flags (ninguno)
+		int valread = (int)recv(sock, buffer, 1024, 0);
+		
+		// PROCESAR LA RESPUESTA
+		// ---------------------
+		if (valread > 0)
+		{
+			// valread = número de bytes recibidos
+			
+			// AGREGAR TERMINADOR NULO AL FINAL
+			// ---------------------------------
+			// Los strings en C++ necesitan '\0' al final
+			if (valread < 1024)
+			{
+				buffer[valread] = '\0';  // Terminar el string
+			}
+			else
+			{
+				buffer[1023] = '\0';  // Si el buffer está lleno, terminar en la última posición
+			}
+
+			// Quitar el '\n' con que el servidor delimita la respuesta
+			size_t responseLen = strlen(buffer);
+			if (responseLen > 0 && buffer[responseLen - 1] == '\n')
+			{
+				buffer[responseLen - 1] = '\0';
+			}
+			
+			// Mostrar la respuesta del servidor
+			cout << "<< Respuesta: " << buffer << endl;
+			cout << "----------------------------------------\n";
+
+		}
+		else if (valread == 0)
+		{
+			// valread == 0 significa que el servidor cerró la conexión
+			cout << "[!] El servidor cerro la conexion." << endl;
+			break;  // Salir del bucle
+		}
+		else
+		{
+			// valread < 0 significa error
+			cerr << "[ERROR] Fallo en recv." << endl;
+			break;  // Salir del bucle
+		}
+
+		// ESPERAR TIEMPO ALEATORIO ANTES DE LA SIGUIENTE PLACA
+		// -----------------------------------------------------
+		// rand() % 3000 = número entre 0 y 2999 milisegundos
+		// 2000 + rand() % 3000 = entre 2000 y 4999 milisegundos
+		// Es decir: entre 2 y 5 segundos
+		int waitTime = 2000 + (rand() % 3001);  // 2000-5000 ms
+		cout << "** Esperando " << (waitTime / 1000.0) << " segundos...\n\n";
+		this_thread::sleep_for(chrono::milliseconds(waitTime));
+
+	}
+
+	// ========================================================================
+	// LIMPIEZA Y CIERRE
+	// ========================================================================
+	// Cuando se sale del bucle, cerrar el socket y liberar los sockets
+	cout << "\nCerrando conexión...\n";
+	closesocket(sock);
+	cleanupSockets();
+	return 0;
+}
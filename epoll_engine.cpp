@@ -0,0 +1,610 @@
+// ============================================================================
+// ARCHIVO: epoll_engine.cpp
+// PROPÓSITO: Bucle de eventos epoll para el servidor de parqueadero
+// DESCRIPCIÓN: accept/recv/send no bloqueantes, con un buffer de salida por
+//              conexión. Habla el mismo protocolo "PLAZA:PLACA:TIMESTAMP"
+//              que handleClient (ver parking_protocol.cpp). Con --bucles N
+//              hay N bucles, cada uno en su hilo y con su propio socket de
+//              escucha (ver loop_inbox.h)
+// ============================================================================
+
+#include "epoll_engine.h"
+#include "parking_protocol.h"
+#include "framing.h"
+#include "async_log.h"
+#include "trace_recorder.h"
+#include "broadcaster.h"
+#include "loop_inbox.h"
+#include "net_compat.h"
+#include "wal.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <string.h>    // Para strlen
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+using namespace std;
+
+// Eventos procesados por cada llamada a epoll_wait
+#define MAX_EVENTS 256
+
+// ============================================================================
+// ESTRUCTURA: Connection
+// PROPÓSITO: Estado de un cliente conectado al bucle de eventos
+// ============================================================================
+struct Connection {
+	SOCKET fd;
+	unsigned long long id;      // Origen de sus lotes (newConnectionId)
+	StreamFramer framer;        // Buffer de lectura y separación de mensajes
+	OutboundQueue outbound;     // Respuestas y difusiones pendientes de enviar
+	string held;                // Respuestas que esperan su fsync (--durabilidad evento)
+	unsigned long long heldSequence;    // Evento que debe estar en disco (0 = nada retenido)
+	bool wantWrite;             // true si está registrado EPOLLOUT
+	bool closed;                // Cerrado, pendiente de liberar
+};
+
+// ============================================================================
+// CLASE: EpollLoop
+// PROPÓSITO: Un bucle epoll con su socket de escucha y sus conexiones
+// ============================================================================
+class EpollLoop {
+private:
+	int epfd;
+	SOCKET listenFd;
+	unordered_map<SOCKET, Connection*> connections;
+	vector<Connection*> toDelete;
+
+	// Difusiones publicadas por cualquier bucle, incluido este (el bucle 0
+	// además lleva los ticks)
+	size_t index;
+	const vector<LoopInbox*>* inboxes;
+	LoopInbox inbox;
+	vector<PayloadPtr> received;
+
+	// Reutilizados entre lecturas (el bucle es de un solo hilo)
+	ParkingBatch batch;
+	string output;
+	vector<Connection*> targets;
+
+	// Conexiones con respuestas retenidas hasta su fsync
+	vector<Connection*> holding;
+
+	void updateInterest(Connection* conn)
+	{
+		struct epoll_event ev;
+		ev.events = EPOLLIN | (conn->wantWrite ? (uint32_t)EPOLLOUT : 0u);
+		ev.data.ptr = conn;
+		epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev);
+	}
+
+	void closeConnection(Connection* conn)
+	{
+		if (conn->closed)
+		{
+			return;
+		}
+		logClientDisconnected(conn->fd);
+		traceDisconnected(conn->fd);
+		epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, nullptr);
+		connections.erase(conn->fd);
+		if (conn->heldSequence != 0)
+		{
+			holding.erase(find(holding.begin(), holding.end(), conn));
+		}
+		closesocket(conn->fd);
+		conn->closed = true;
+
+		// Se libera al final de la iteración: puede quedar algún evento
+		// pendiente en el lote actual que apunte a esta conexión
+		toDelete.push_back(conn);
+	}
+
+	// Registrar EPOLLOUT solo mientras queden datos pendientes
+	void handleFlush(Connection* conn, FlushResult result)
+	{
+		if (result == FLUSH_ERROR)
+		{
+			closeConnection(conn);
+			return;
+		}
+		bool pending = (result == FLUSH_BLOCKED);
+		if (pending != conn->wantWrite)
+		{
+			conn->wantWrite = pending;
+			updateInterest(conn);
+		}
+	}
+
+	// ENVIAR TODO LO POSIBLE SIN BLOQUEAR
+	void flush(Connection* conn)
+	{
+		handleFlush(conn, flushQueue(conn->fd, conn->outbound));
+	}
+
+	// bounded = false para un snapshot, que puede superar MAX_PENDING_OUTPUT
+	void queueSend(Connection* conn, const char* data, size_t len, bool bounded = true)
+	{
+		if (conn->closed)
+		{
+			return;
+		}
+		FlushResult result = sendOrQueue(conn->fd, conn->outbound, data, len, bounded);
+		if (result == FLUSH_ERROR && conn->outbound.pendingBytes() > 0)
+		{
+			logWarning(conn->fd, "no consume sus mensajes, se desconecta");
+		}
+		handleFlush(conn, result);
+	}
+
+	// ENCOLAR UN LOTE PARA TODOS EXCEPTO EL ORIGEN
+	// El lote se codifica una vez y todas las colas comparten el mismo payload
+	void broadcast(const PayloadPtr& payload)
+	{
+		targets.clear();
+		for (auto& entry : connections)
+		{
+			if (entry.second->id != payload->origin)
+			{
+				targets.push_back(entry.second);
+			}
+		}
+		for (Connection* conn : targets)
+		{
+			if (conn->closed)
+			{
+				continue;
+			}
+			conn->outbound.setMode(conn->framer.mode());
+			if (!conn->outbound.pushUpdates(payload))
+			{
+				logWarning(conn->fd, "no consume sus mensajes, se desconecta");
+				closeConnection(conn);
+				continue;
+			}
+			if (!conn->wantWrite)
+			{
+				flush(conn);
+			}
+		}
+	}
+
+	void acceptClients()
+	{
+		while (true)
+		{
+			SOCKET fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+			if (fd == INVALID_SOCKET)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				if (errno != EAGAIN && errno != EWOULDBLOCK)
+				{
+					cerr << "✗ Error en accept\n";
+				}
+				return;
+			}
+
+			setNoDelay(fd);
+
+			Connection* conn = new Connection();
+			conn->fd = fd;
+			conn->id = newConnectionId();
+			conn->heldSequence = 0;
+			conn->wantWrite = false;
+			conn->closed = false;
+
+			struct epoll_event ev;
+			ev.events = EPOLLIN;
+			ev.data.ptr = conn;
+			if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+			{
+				closesocket(fd);
+				delete conn;
+				continue;
+			}
+			connections[fd] = conn;
+			logClientConnected(fd);
+			traceConnected(fd);
+		}
+	}
+
+	void handleReadable(Connection* conn)
+	{
+		ssize_t valread = recv(conn->fd, conn->framer.writePtr(), conn->framer.writable(), 0);
+		if (valread == 0)
+		{
+			closeConnection(conn);
+			return;
+		}
+		if (valread < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			{
+				closeConnection(conn);
+			}
+			return;
+		}
+		conn->framer.commit((size_t)valread);
+		long long receivedAt = traceClock();
+
+		// Un recv puede traer varios mensajes: se validan todos, se aplican
+		// con un solo lock y las respuestas salen en un solo send
+		batch.clear();
+		char* buffer;
+		size_t length;
+		while (conn->framer.next(buffer, length))
+		{
+			traceMessage(conn->fd, receivedAt, conn->framer.mode() == FRAME_BINARY, buffer, length);
+			batch.requests.emplace_back();
+			if (conn->framer.mode() == FRAME_BINARY)
+			{
+				parseBinaryRequest(buffer, batch.requests.back());
+			}
+			else
+			{
+				parseRequest(buffer, batch.requests.back());
+			}
+		}
+
+		if (!batch.requests.empty())
+		{
+			// Los cambios del lote se publican al aplicarlo (ver loop_inbox.h)
+			batch.origin = conn->id;
+			applyBatch(batch);
+
+			output.clear();
+			bool subscribed = false;
+			for (size_t i = 0; i < batch.responses.size(); ++i)
+			{
+				if (batch.responses[i] == nullptr)
+				{
+					// SUSCRIBIR: el snapshot cubre todo evento hasta su
+					// secuencia. Lo publicado después, también por otros
+					// bucles, se difunde desde el buzón (deliverInbox, más
+					// abajo) ya con "EV:" y en orden; un EV anterior que
+					// llegue después, el cliente lo ignora
+					buildSubscription(batch.requests[i].resumeFrom, conn->framer.mode(), output);
+					conn->outbound.setSequenced(true);
+					subscribed = true;
+					continue;
+				}
+				encodeResponse(conn->framer.mode(), batch, i, output);
+			}
+			sendWhenDurable(conn, subscribed);
+
+			// Lo que este hilo publicó quedó en su buzón sin aviso
+			deliverInbox();
+		}
+
+		if (!conn->closed && conn->framer.hasError())
+		{
+			logWarning(conn->fd, "envio un mensaje demasiado largo");
+			closeConnection(conn);
+		}
+	}
+
+	// --durabilidad evento: las respuestas del lote (output) salen cuando
+	// sus eventos están en disco. Mientras tanto el bucle sigue con otras
+	// conexiones; las respuestas siguientes de esta se retienen detrás, en
+	// orden. Un snapshot sí espera aquí: los EV que el buzón le encole
+	// después no pueden adelantarlo
+	void sendWhenDurable(Connection* conn, bool subscribed)
+	{
+		unsigned long long needed = batch.updates.empty() ? 0 : batch.updates.back().sequence;
+		needed = max(needed, conn->heldSequence);
+		WalStatus status = (needed == 0) ? WAL_SAVED : walStatus(needed);
+		if (status == WAL_PENDING && subscribed)
+		{
+			status = walWaitDurable(needed) ? WAL_SAVED : WAL_LOST;
+		}
+
+		if (status == WAL_PENDING)
+		{
+			if (conn->heldSequence == 0)
+			{
+				holding.push_back(conn);
+			}
+			conn->held += output;
+			conn->heldSequence = needed;
+			return;
+		}
+		if (conn->heldSequence != 0)
+		{
+			releaseHeld(conn, status);
+		}
+		if (status == WAL_SAVED)
+		{
+			queueSend(conn, output.data(), output.size(), !subscribed);
+		}
+		else
+		{
+			rejectLost(conn);
+		}
+	}
+
+	// Respuestas que el WAL no guardó: no se confirman (ver ERRORES en wal.h)
+	void rejectLost(Connection* conn)
+	{
+		if (conn->closed)
+		{
+			return;
+		}
+		logWarning(conn->fd, "sus cambios no llegaron al WAL, se desconecta");
+		closeConnection(conn);
+	}
+
+	// Envía (o descarta, si se perdieron) las respuestas retenidas
+	void releaseHeld(Connection* conn, WalStatus status)
+	{
+		holding.erase(find(holding.begin(), holding.end(), conn));
+		conn->heldSequence = 0;
+		if (status == WAL_SAVED)
+		{
+			queueSend(conn, conn->held.data(), conn->held.size());
+		}
+		else
+		{
+			rejectLost(conn);
+		}
+		conn->held.clear();
+	}
+
+	// Aviso del WAL: sale lo que ya está en disco
+	void releaseDurable()
+	{
+		for (size_t i = 0; i < holding.size();)
+		{
+			Connection* conn = holding[i];
+			WalStatus status = walStatus(conn->heldSequence);
+			if (status == WAL_PENDING)
+			{
+				++i;
+				continue;
+			}
+			releaseHeld(conn, status);
+		}
+	}
+
+	// DIFUNDIR A LOS CLIENTES DE ESTE BUCLE LO PUBLICADO, EN ORDEN
+	void deliverInbox()
+	{
+		inbox.take(received);
+		for (const PayloadPtr& payload : received)
+		{
+			broadcast(payload);
+		}
+		received.clear();
+	}
+
+	// Aviso del eventfd: otro hilo dejó algo en el buzón
+	void drainInbox()
+	{
+		uint64_t count;
+		ssize_t readBytes = read(inbox.fd(), &count, sizeof(count));
+		(void)readBytes;
+		deliverInbox();
+		releaseDurable();
+	}
+
+public:
+	EpollLoop(SOCKET listenSocket, size_t loopIndex, const vector<LoopInbox*>* allInboxes)
+		: epfd(-1), listenFd(listenSocket), index(loopIndex), inboxes(allInboxes)
+	{
+		batch.deferDurable = true;
+	}
+
+	LoopInbox& mailbox()
+	{
+		return inbox;
+	}
+
+	~EpollLoop()
+	{
+		for (auto& entry : connections)
+		{
+			closesocket(entry.first);
+			delete entry.second;
+		}
+		if (epfd != -1)
+		{
+			close(epfd);
+		}
+	}
+
+	bool init()
+	{
+		epfd = epoll_create1(EPOLL_CLOEXEC);
+		if (epfd == -1 || !inbox.init())
+		{
+			return false;
+		}
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.ptr = nullptr;  // nullptr identifica al socket de escucha
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, listenFd, &ev) != 0)
+		{
+			return false;
+		}
+		ev.data.ptr = &inbox;
+		return epoll_ctl(epfd, EPOLL_CTL_ADD, inbox.fd(), &ev) == 0;
+	}
+
+	void run()
+	{
+		struct epoll_event events[MAX_EVENTS];
+		inbox.bindToCurrentThread();
+
+		// Solo el bucle 0 recoge los ticks y los pasa a los demás
+		int tickMs = (index == 0) ? broadcastTickMs() : 0;
+		chrono::steady_clock::time_point nextTick = chrono::steady_clock::now() + chrono::milliseconds(tickMs);
+
+		while (true)
+		{
+			// Sin ticks se espera indefinidamente; con ticks, hasta el siguiente
+			int timeout = -1;
+			if (tickMs > 0)
+			{
+				auto remaining = chrono::duration_cast<chrono::milliseconds>(nextTick - chrono::steady_clock::now());
+				timeout = remaining.count() > 0 ? (int)remaining.count() : 0;
+			}
+
+			int n = epoll_wait(epfd, events, MAX_EVENTS, timeout);
+			if (n < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				cerr << "✗ Error en epoll_wait\n";
+				inbox.close();
+				return;
+			}
+
+			for (int i = 0; i < n; ++i)
+			{
+				if (events[i].data.ptr == &inbox)
+				{
+					drainInbox();
+					continue;
+				}
+				Connection* conn = (Connection*)events[i].data.ptr;
+				if (conn == nullptr)
+				{
+					acceptClients();
+					continue;
+				}
+				if (conn->closed)
+				{
+					continue;
+				}
+				if (events[i].events & EPOLLIN)
+				{
+					handleReadable(conn);
+				}
+				if ((events[i].events & (EPOLLERR | EPOLLHUP)) && !conn->closed)
+				{
+					closeConnection(conn);
+					continue;
+				}
+				if ((events[i].events & EPOLLOUT) && !conn->closed)
+				{
+					flush(conn);
+				}
+			}
+
+			// TICK: una sola trama con el estado final de lo que cambió
+			if (tickMs > 0 && chrono::steady_clock::now() >= nextTick)
+			{
+				PayloadPtr delta = collectDeltaPayload();
+				if (delta)
+				{
+					broadcast(delta);
+					postToOtherLoops(*inboxes, index, delta);
+				}
+				nextTick += chrono::milliseconds(tickMs);
+				if (nextTick < chrono::steady_clock::now())
+				{
+					nextTick = chrono::steady_clock::now() + chrono::milliseconds(tickMs);
+				}
+			}
+
+			for (Connection* conn : toDelete)
+			{
+				delete conn;
+			}
+			toDelete.clear();
+		}
+	}
+};
+
+// ============================================================================
+// FUNCIÓN: runEpollServer
+// ============================================================================
+int runEpollServer(const ServerConfig& config)
+{
+	// Un socket de escucha por bucle: con SO_REUSEPORT el núcleo reparte
+	// las conexiones entrantes entre ellos
+	int loopCount = eventLoopCount(config.loops);
+	vector<LoopInbox*> inboxes;
+	vector<EpollLoop*> loops;
+	vector<SOCKET> listenSockets;
+	bool ok = true;
+	for (int i = 0; i < loopCount && ok; ++i)
+	{
+		SOCKET servidor_fd = createListenSocket(config.port, config.backlog, loopCount > 1);
+		if (servidor_fd == INVALID_SOCKET || !setNonBlocking(servidor_fd))
+		{
+			cerr << "✗ Error al crear el socket de escucha en el puerto " << config.port << "\n";
+			if (servidor_fd != INVALID_SOCKET)
+			{
+				closesocket(servidor_fd);
+			}
+			ok = false;
+			break;
+		}
+		listenSockets.push_back(servidor_fd);
+
+		EpollLoop* loop = new EpollLoop(servidor_fd, (size_t)i, &inboxes);
+		loops.push_back(loop);
+		if (!loop->init())
+		{
+			cerr << "✗ Error al crear epoll\n";
+			ok = false;
+			break;
+		}
+		inboxes.push_back(&loop->mailbox());
+	}
+
+	if (ok)
+	{
+		if (loopCount == 1)
+		{
+			cout << "[*] Motor: epoll (un hilo, sockets no bloqueantes)\n";
+		}
+		else
+		{
+			cout << "[*] Motor: epoll (" << loopCount << " bucles, cada uno con su socket de escucha)\n";
+		}
+		cout << "[*] Esperando conexiones...\n";
+		cout << "========================================================\n\n";
+
+		// Sin ticks, cada lote aplicado se publica en todos los buzones
+		if (broadcastTickMs() == 0)
+		{
+			setEventPublisher(publishToLoops, &inboxes);
+		}
+		setWalListener(wakeLoops, &inboxes);
+
+		// El bucle 0 corre en este hilo
+		vector<thread> threads;
+		for (size_t i = 1; i < loops.size(); ++i)
+		{
+			threads.emplace_back(&EpollLoop::run, loops[i]);
+		}
+		loops[0]->run();
+		for (thread& worker : threads)
+		{
+			worker.join();
+		}
+		setEventPublisher(nullptr, nullptr);
+		setWalListener(nullptr, nullptr);
+	}
+
+	for (EpollLoop* loop : loops)
+	{
+		delete loop;
+	}
+	for (SOCKET servidor_fd : listenSockets)
+	{
+		closesocket(servidor_fd);
+	}
+	return 1;
+}
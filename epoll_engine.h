@@ -0,0 +1,18 @@
+// ============================================================================
+// ARCHIVO: epoll_engine.h
+// PROPÓSITO: Motor del servidor basado en epoll (solo Linux)
+// DESCRIPCIÓN: Cada bucle (--bucles, uno por núcleo) multiplexa sus
+//              sockets con epoll en un solo hilo, sin crear un thread por
+//              cliente. El número de conexiones queda limitado por los
+//              descriptores de archivo, no por las pilas
+// ============================================================================
+
+#ifndef EPOLL_ENGINE_H
+#define EPOLL_ENGINE_H
+
+#include "server_config.h"
+
+// Retorna el código de salida del proceso (0 = ok)
+int runEpollServer(const ServerConfig& config);
+
+#endif
@@ -0,0 +1,161 @@
+#include "framing.h"
+#include "parking_protocol.h"
+#include "binary_protocol.h"
+#include <string.h>
+
+StreamFramer::StreamFramer(size_t capacity)
+    : capacity(capacity), readPos(0), writePos(0), rawEnd(0),
+      frameMode(FRAME_RAW), modeDetected(false), error(false),
+      savedPos(0), savedByte(0), hasSaved(false) {
+    buffer = new char[capacity + 1];
+}
+
+StreamFramer::~StreamFramer() {
+    delete[] buffer;
+}
+
+void StreamFramer::restoreSavedByte() {
+    if (hasSaved) {
+        buffer[savedPos] = savedByte;
+        hasSaved = false;
+    }
+}
+
+char* StreamFramer::writePtr() {
+    writable();
+    return buffer + writePos;
+}
+
+size_t StreamFramer::writable() {
+    restoreSavedByte();
+
+    // Todo consumido: volver al inicio sin copiar nada
+    if (readPos == writePos) {
+        readPos = writePos = rawEnd = 0;
+    }
+    // Sin espacio al final: mover el mensaje parcial al inicio del buffer
+    else if (writePos == capacity && readPos > 0) {
+        size_t pending = writePos - readPos;
+        memmove(buffer, buffer + readPos, pending);
+        rawEnd = (rawEnd > readPos) ? rawEnd - readPos : 0;
+        writePos = pending;
+        readPos = 0;
+    }
+    return capacity - writePos;
+}
+
+void StreamFramer::commit(size_t n) {
+    if (n == 0) return;
+
+    char* data = buffer + writePos;
+
+    // DETECTAR EL MODO CON EL PRIMER BYTE DE LA CONEXIÓN
+    if (!modeDetected) {
+        modeDetected = true;
+        if ((unsigned char)data[0] < 0x04) {
+            frameMode = FRAME_LENGTH;
+        } else if ((unsigned char)data[0] == BIN_OP_HELLO) {
+            frameMode = FRAME_BINARY;
+        }
+    }
+
+    // Un cliente de texto pasa a modo línea al enviar su primer '\n';
+    // mientras tanto, cada recv es un mensaje completo (clientes antiguos)
+    if (frameMode == FRAME_RAW) {
+        if (memchr(data, '\n', n) != nullptr) {
+            frameMode = FRAME_LINE;
+        } else {
+            rawEnd = writePos + n;
+        }
+    }
+
+    writePos += n;
+}
+
+bool StreamFramer::next(char*& msg, size_t& len) {
+    restoreSavedByte();
+    if (error) return false;
+
+    while (readPos < writePos) {
+        char* start = buffer + readPos;
+        size_t available = writePos - readPos;
+
+        if (frameMode == FRAME_BINARY) {
+            if (available < BINARY_MESSAGE_SIZE) return false;
+            msg = start;
+            len = BINARY_MESSAGE_SIZE;
+            readPos += BINARY_MESSAGE_SIZE;
+            savedPos = readPos;
+            savedByte = buffer[savedPos];
+            hasSaved = true;
+            buffer[savedPos] = '\0';
+            return true;
+        }
+
+        if (frameMode == FRAME_LENGTH) {
+            if (available < 2) return false;
+            size_t frameLen = ((size_t)(unsigned char)start[0] << 8) | (unsigned char)start[1];
+            if (frameLen >= MAX_MESSAGE) {
+                error = true;
+                return false;
+            }
+            if (available < 2 + frameLen) return false;
+
+            msg = start + 2;
+            len = frameLen;
+            readPos += 2 + frameLen;
+
+            // El byte siguiente puede ser el prefijo del próximo mensaje:
+            // se guarda y se restaura en la siguiente llamada
+            savedPos = readPos;
+            savedByte = buffer[savedPos];
+            hasSaved = true;
+            buffer[savedPos] = '\0';
+            return true;
+        }
+
+        if (frameMode == FRAME_LINE) {
+            char* newline = (char*)memchr(start, '\n', available);
+            if (newline == nullptr) {
+                if (available >= MAX_MESSAGE) error = true;
+                return false;
+            }
+            *newline = '\0';
+            len = (size_t)(newline - start);
+            if (len > 0 && start[len - 1] == '\r') {
+                start[--len] = '\0';
+            }
+            readPos += (size_t)(newline - start) + 1;
+
+            // Ignorar líneas vacías
+            if (len == 0) continue;
+            msg = start;
+            return true;
+        }
+
+        // FRAME_RAW: todo lo recibido en el último recv es un mensaje
+        if (rawEnd <= readPos) return false;
+        msg = start;
+        len = rawEnd - readPos;
+        readPos = rawEnd;
+        savedPos = readPos;
+        savedByte = buffer[savedPos];
+        hasSaved = true;
+        buffer[savedPos] = '\0';
+        return true;
+    }
+    return false;
+}
+
+void StreamFramer::encode(FrameMode mode, const char* msg, size_t len, std::string& out) {
+    if (mode == FRAME_LENGTH) {
+        out.push_back((char)((len >> 8) & 0xFF));
+        out.push_back((char)(len & 0xFF));
+        out.append(msg, len);
+    } else if (mode == FRAME_LINE) {
+        out.append(msg, len);
+        out.push_back('\n');
+    } else {
+        out.append(msg, len);
+    }
+}
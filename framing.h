@@ -0,0 +1,86 @@
+// ============================================================================
+// ARCHIVO: framing.h
+// PROPÓSITO: Separar el flujo TCP en mensajes del protocolo
+// DESCRIPCIÓN: TCP no respeta los límites de los send(): varios mensajes
+//              pueden llegar juntos en un recv, o uno partido en dos.
+//              StreamFramer acumula los bytes de una conexión y extrae
+//              todos los mensajes completos que contenga.
+//
+// MODOS (se detectan con los primeros bytes de la conexión):
+//   - FRAME_RAW:    Clientes antiguos sin delimitador. Cada recv es un
+//                   mensaje (comportamiento original de handleClient)
+//   - FRAME_LINE:   Mensajes terminados en '\n' (se acepta "\r\n"). Se
+//                   activa al ver el primer '\n'
+//   - FRAME_LENGTH: Prefijo de 2 bytes big-endian con la longitud. Se
+//                   activa si el primer byte es < 0x04: como un mensaje
+//                   mide menos de MAX_MESSAGE (1024) bytes, el byte alto
+//                   del prefijo vale 0..3, y un mensaje de texto siempre
+//                   empieza por un dígito
+//   - FRAME_BINARY: Mensajes de BINARY_MESSAGE_SIZE bytes (ver
+//                   binary_protocol.h). Se activa si el primer byte es
+//                   BIN_OP_HELLO
+// ============================================================================
+
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <stddef.h>
+#include <string>
+
+enum FrameMode {
+    FRAME_RAW,
+    FRAME_LINE,
+    FRAME_LENGTH,
+    FRAME_BINARY
+};
+
+// Capacidad por defecto del buffer de cada conexión
+#define FRAMER_CAPACITY (16 * 1024)
+
+class StreamFramer {
+private:
+    char* buffer;        // capacity + 1 bytes (uno extra para el '\0')
+    size_t capacity;
+    size_t readPos;      // Inicio de los bytes aún no consumidos
+    size_t writePos;     // Fin de los bytes recibidos
+    size_t rawEnd;       // Modo RAW: fin del último recv pendiente
+    FrameMode frameMode;
+    bool modeDetected;
+    bool error;
+
+    // Byte sobrescrito con '\0' al devolver el último mensaje
+    size_t savedPos;
+    char savedByte;
+    bool hasSaved;
+
+    void restoreSavedByte();
+
+public:
+    explicit StreamFramer(size_t capacity = FRAMER_CAPACITY);
+    ~StreamFramer();
+
+    StreamFramer(const StreamFramer&) = delete;
+    StreamFramer& operator=(const StreamFramer&) = delete;
+
+    // Espacio libre donde recv() puede escribir directamente
+    char* writePtr();
+    size_t writable();
+
+    // Registrar n bytes recibidos en writePtr()
+    void commit(size_t n);
+
+    // Extraer el siguiente mensaje completo. El mensaje queda terminado en
+    // '\0' dentro del buffer y es válido hasta la siguiente llamada
+    bool next(char*& msg, size_t& len);
+
+    FrameMode mode() const { return frameMode; }
+
+    // true si el cliente violó el protocolo (mensaje demasiado largo)
+    bool hasError() const { return error; }
+
+    // Añadir a out un mensaje con el encuadre del modo indicado (en
+    // FRAME_BINARY el mensaje ya viene codificado y se copia tal cual)
+    static void encode(FrameMode mode, const char* msg, size_t len, std::string& out);
+};
+
+#endif
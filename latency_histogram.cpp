@@ -0,0 +1,81 @@
+#include "latency_histogram.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static inline int msb64(uint64_t x) {
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return (int)index;
+}
+#else
+static inline int msb64(uint64_t x) { return 63 - __builtin_clzll(x); }
+#endif
+
+// Valores < 128 tienen cubeta propia; a partir de ahí, 64 sub-cubetas por
+// potencia de dos (los 7 bits más altos del valor)
+static const int SUB_BUCKET_BITS = 7;
+static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+static const int HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+static const int BUCKET_COUNT = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+    : counts(BUCKET_COUNT, 0), total(0), minValue(UINT64_MAX), maxValue(0), sum(0.0) {}
+
+int LatencyHistogram::indexOf(uint64_t value) {
+    if (value < (uint64_t)SUB_BUCKETS) return (int)value;
+    int shift = msb64(value) - (SUB_BUCKET_BITS - 1);
+    int sub = (int)(value >> shift) - HALF_SUB_BUCKETS;
+    return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::highestValueAt(int index) {
+    if (index < SUB_BUCKETS) return (uint64_t)index;
+    int shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    uint64_t sub = (uint64_t)((index - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS);
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts[(size_t)indexOf(value)]++;
+    total++;
+    sum += (double)value;
+    if (value < minValue) minValue = value;
+    if (value > maxValue) maxValue = value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    if (other.minValue < minValue) minValue = other.minValue;
+    if (other.maxValue > maxValue) maxValue = other.maxValue;
+}
+
+void LatencyHistogram::reset() {
+    counts.assign(counts.size(), 0);
+    total = 0;
+    minValue = UINT64_MAX;
+    maxValue = 0;
+    sum = 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (total == 0) return 0;
+    if (percentile >= 100.0) return maxValue;
+
+    // Rango de la muestra buscada (al menos la primera)
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t value = highestValueAt((int)i);
+            return value < maxValue ? value : maxValue;
+        }
+    }
+    return maxValue;
+}
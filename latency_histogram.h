@@ -0,0 +1,47 @@
+// ============================================================================
+// ARCHIVO: latency_histogram.h
+// PROPÓSITO: Histograma de latencias al estilo HdrHistogram
+// DESCRIPCIÓN: Cubetas log-lineales: cada potencia de dos se divide en 64
+//              sub-cubetas, así que cualquier valor (de 1 ns a horas) se
+//              guarda con un error relativo menor al 1.6 % en un arreglo
+//              fijo de contadores. Registrar un valor es O(1) y no reserva
+//              memoria; los histogramas de varios hilos se combinan con
+//              merge() al final
+// ============================================================================
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class LatencyHistogram {
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    uint64_t minValue;
+    uint64_t maxValue;
+    double sum;
+
+    static int indexOf(uint64_t value);
+    static uint64_t highestValueAt(int index);
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? minValue : 0; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return total ? sum / (double)total : 0.0; }
+
+    // Valor bajo el que queda el "percentile" % de las muestras (0-100).
+    // Se devuelve el máximo de su cubeta: nunca subestima la latencia
+    uint64_t percentile(double percentile) const;
+};
+
+#endif
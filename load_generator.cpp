@@ -0,0 +1,487 @@
+#include "load_generator.h"
+
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+#include "binary_protocol.h"
+#include "latency_histogram.h"
+#include "net_compat.h"
+#include "plate_codec.h"
+#include "workload_model.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Tiempo máximo para recibir las respuestas pendientes al terminar (y las
+// de las entradas iniciales del modelo)
+static const std::chrono::seconds DRAIN_TIMEOUT(2);
+
+long long localTimestamp(char* text) {
+    time_t now = time(0);
+    struct tm info;
+#ifdef _WIN32
+    localtime_s(&info, &now);
+    strftime(text, 20, "%Y-%m-%d %H:%M:%S", &info);
+    // _mkgmtime toma la hora local como si fuera UTC: hora civil
+    return (long long)_mkgmtime(&info);
+#else
+    localtime_r(&now, &info);
+    strftime(text, 20, "%Y-%m-%d %H:%M:%S", &info);
+    return (long long)timegm(&info);
+#endif
+}
+
+bool ReplyReader::next(bool& reply, bool& error) {
+    if (binary) {
+        // Ningún mensaje binario del servidor empieza por un carácter
+        // imprimible: lo que empiece así es una línea de texto
+        while (!synced && start < inbound.size()
+               && (unsigned char)inbound[start] >= 0x20 && (unsigned char)inbound[start] < 0x7F) {
+            size_t newline = inbound.find('\n', start);
+            if (newline == std::string::npos) {
+                compact();
+                return false;
+            }
+            start = newline + 1;
+        }
+        if (inbound.size() - start < BINARY_MESSAGE_SIZE) {
+            compact();
+            return false;
+        }
+        BinaryMessage message;
+        decodeBinaryMessage(inbound.data() + start, message);
+        start += BINARY_MESSAGE_SIZE;
+        synced = true;
+        reply = (message.op & BIN_OP_REPLY) != 0;
+        error = reply && message.result >= ERROR_FORMAT;
+        return true;
+    }
+
+    size_t newline = inbound.find('\n', start);
+    if (newline == std::string::npos) {
+        compact();
+        return false;
+    }
+    const char* line = inbound.c_str() + start;
+    bool ok = strncmp(line, "OK", 2) == 0;
+    error = strncmp(line, "ERROR", 5) == 0;
+    reply = ok || error;
+    start = newline + 1;
+    return true;
+}
+
+void ReplyReader::compact() {
+    inbound.erase(0, start);
+    start = 0;
+}
+
+static void printLatency(const char* name, uint64_t ns) {
+    std::cout << "  " << std::left << std::setw(10) << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ns / 1000.0 << " us\n";
+}
+
+void printLatencyReport(const LatencyHistogram& latency) {
+    printLatency("p50", latency.percentile(50));
+    printLatency("p90", latency.percentile(90));
+    printLatency("p99", latency.percentile(99));
+    printLatency("p99.9", latency.percentile(99.9));
+    printLatency("max", latency.max());
+}
+
+namespace {
+
+struct ConnectionStats {
+    LatencyHistogram latency;
+    uint64_t sent = 0;
+    uint64_t entries = 0;
+    uint64_t replies = 0;
+    uint64_t errors = 0;
+    uint64_t broadcasts = 0;
+    uint64_t unanswered = 0;
+    uint64_t rejected = 0;
+    int occupied = 0;
+    int spots = 0;
+    double simulatedSeconds = 0;
+    bool failed = false;
+};
+
+class LoadConnection {
+public:
+    LoadConnection(const LoadConfig& config, SOCKET fd, int index, ConnectionStats& stats)
+        : config(config), fd(fd), stats(stats),
+          random(config.seed + (unsigned long long)index),
+          model(config.workload, connectionSpots(config, index), config.seed + (unsigned long long)index,
+                index * fleetSize(config)),
+          replies(config.binary), lastTimestamp(-1) {
+        timestampText[0] = '\0';
+        upcoming = model.next();
+        double perConnection = config.rate / config.connections;
+        closedLoop = perConnection <= 0;
+        interval = closedLoop ? 0.0 : 1e9 / perConnection;
+        arrivals = std::exponential_distribution<double>(closedLoop ? 1.0 : perConnection / 1e9);
+        // Con --llegadas modelo, un segundo real equivale a "timeScale"
+        // segundos simulados para que la tasa media sea la pedida
+        timeScale = closedLoop ? 1.0 : perConnection / model.meanEventRate();
+        // Con llegadas fijas las conexiones se escalonan para no enviar
+        // todas a la vez
+        if (config.arrivals == ARRIVALS_POISSON) {
+            firstOffset = nextGap();
+        } else if (config.arrivals == ARRIVALS_FIXED) {
+            firstOffset = interval * index / config.connections;
+        } else {
+            firstOffset = upcoming.time / timeScale * 1e9;
+        }
+    }
+
+    // Plazas de la conexión "index": 1+index, 1+index+N, ... Así los modelos
+    // de las distintas conexiones nunca usan la misma plaza
+    static std::vector<int> connectionSpots(const LoadConfig& config, int index) {
+        std::vector<int> spots;
+        for (int spot = 1 + index; spot <= config.spots; spot += config.connections) {
+            spots.push_back(spot);
+        }
+        return spots;
+    }
+
+    static int fleetSize(const LoadConfig& config) {
+        int spots = (config.spots + config.connections - 1) / config.connections;
+        return config.workload.fleetSize > 0 ? config.workload.fleetSize : 2 * spots;
+    }
+
+    // Envía las entradas que dejan el parqueadero con la ocupación inicial
+    // del modelo y espera sus respuestas. No se mide
+    bool warmUp() {
+        const std::vector<WorkloadEvent>& entries = model.initialEntries();
+        if (entries.empty()) return true;
+
+        std::string batch;
+        for (const WorkloadEvent& event : entries) appendEvent(batch, event);
+        if (!sendAll(batch)) return false;
+
+        expectedWarmUp = entries.size();
+        Clock::time_point limit = Clock::now() + DRAIN_TIMEOUT;
+        char buffer[16384];
+        while (expectedWarmUp > 0 && Clock::now() < limit) {
+            if (waitReadable(fd, 100) <= 0) continue;
+            int received = (int)recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) return false;
+            consume(buffer, received);
+        }
+        stats.broadcasts = 0;
+        return expectedWarmUp == 0;
+    }
+
+    void run(Clock::time_point start) {
+        Clock::time_point end = start + toDuration(config.durationSeconds * 1e9);
+        Clock::time_point drainLimit = end + DRAIN_TIMEOUT;
+        Clock::time_point nextIntended = start + toDuration(firstOffset);
+
+        std::this_thread::sleep_until(start);
+
+        std::string batch;
+        char buffer[16384];
+        while (true) {
+            Clock::time_point now = Clock::now();
+
+            // ENVIAR todo lo que ya debió salir (hasta llenar la profundidad)
+            batch.clear();
+            while ((int)pending.size() < config.depth) {
+                Clock::time_point intended = closedLoop ? now : nextIntended;
+                if (intended >= end || (!closedLoop && intended > now)) break;
+                if (config.onSend) config.onSend(upcoming);
+                appendEvent(batch, upcoming);
+                pending.push_back(intended);
+                stats.sent++;
+                if (upcoming.entry) stats.entries++;
+                stats.simulatedSeconds = upcoming.time;
+                upcoming = model.next();
+                if (closedLoop) continue;
+                if (config.arrivals == ARRIVALS_POISSON) {
+                    nextIntended += toDuration(nextGap());
+                } else if (config.arrivals == ARRIVALS_FIXED) {
+                    nextIntended += toDuration(interval);
+                } else {
+                    nextIntended = start + toDuration(upcoming.time / timeScale * 1e9);
+                }
+            }
+            if (!batch.empty() && !sendAll(batch)) {
+                stats.failed = true;
+                break;
+            }
+
+            bool sending = closedLoop ? now < end : nextIntended < end;
+            if (!sending && pending.empty()) break;
+            if (now >= drainLimit) break;
+
+            // ESPERAR la próxima llegada prevista o una respuesta
+            Clock::time_point wakeUp = drainLimit;
+            if (sending && (int)pending.size() < config.depth) {
+                wakeUp = closedLoop ? now : nextIntended;
+            }
+            int timeoutMs = 0;
+            if (wakeUp > now) {
+                long long waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeUp - now).count();
+                timeoutMs = (int)((waitNs + 999999) / 1000000);
+            }
+            int ready = waitReadable(fd, timeoutMs);
+            if (ready < 0) {
+                stats.failed = true;
+                break;
+            }
+            if (ready == 0) continue;
+
+            int received = (int)recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                stats.failed = true;
+                break;
+            }
+            consume(buffer, received);
+        }
+        stats.unanswered = pending.size();
+        stats.rejected = model.getRejected();
+        stats.occupied = model.getOccupied();
+        stats.spots = model.getSpotCount();
+    }
+
+private:
+    const LoadConfig& config;
+    SOCKET fd;
+    ConnectionStats& stats;
+    std::mt19937_64 random;
+    std::exponential_distribution<double> arrivals;
+    WorkloadModel model;
+    WorkloadEvent upcoming;   // Próximo evento a enviar
+    bool closedLoop;
+    double interval;          // ns entre llegadas fijas
+    double timeScale;         // Segundos simulados por segundo real
+    double firstOffset;       // ns desde el inicio hasta la primera llegada
+    size_t expectedWarmUp = 0;
+
+    // Instante previsto de cada solicitud sin respuesta. Las respuestas
+    // llegan en el orden de las solicitudes, así que basta una cola
+    std::deque<Clock::time_point> pending;
+    ReplyReader replies;
+
+    // La hora solo se formatea cuando cambia de segundo
+    long long lastTimestamp;
+    char timestampText[20];
+
+    static Clock::duration toDuration(double ns) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds((long long)ns));
+    }
+
+    double nextGap() { return arrivals(random); }
+
+    void appendEvent(std::string& batch, const WorkloadEvent& event) {
+        if (config.binary) {
+            BinaryMessage request = {};
+            request.op = BIN_OP_PARK;
+            request.spot = (uint32_t)event.spot;
+            request.plate = event.plate;
+            request.timestamp = (int64_t)event.timestamp;
+            char bytes[BINARY_MESSAGE_SIZE];
+            encodeBinaryMessage(request, bytes);
+            batch.append(bytes, BINARY_MESSAGE_SIZE);
+            return;
+        }
+
+        // Entrada y salida se envían igual: la placa de un vehículo que ya
+        // está dentro es una SALIDA
+        if (event.timestamp != lastTimestamp) {
+            lastTimestamp = event.timestamp;
+            formatCivilTime(event.timestamp, timestampText);
+        }
+        char plate[PLATE_RECORD_SIZE];
+        decodePlate(event.plate, plate);
+        batch += std::to_string(event.spot);
+        batch += ':';
+        batch += plate;
+        batch += ':';
+        batch += timestampText;
+        batch += '\n';
+    }
+
+    bool sendAll(const std::string& batch) {
+        size_t offset = 0;
+        while (offset < batch.size()) {
+            int n = (int)send(fd, batch.data() + offset, (int)(batch.size() - offset), SEND_FLAGS);
+            if (n == SOCKET_ERROR) {
+                if (socketWouldBlock()) continue;
+                return false;
+            }
+            offset += (size_t)n;
+        }
+        return true;
+    }
+
+    void completeRequest(bool error) {
+        if (expectedWarmUp > 0) {
+            expectedWarmUp--;
+            return;
+        }
+        if (pending.empty()) return;
+        Clock::time_point intended = pending.front();
+        pending.pop_front();
+
+        Clock::time_point now = Clock::now();
+        stats.latency.record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - intended).count());
+        stats.replies++;
+        if (error) stats.errors++;
+    }
+
+    void consume(const char* data, int length) {
+        replies.append(data, (size_t)length);
+        bool reply, error;
+        while (replies.next(reply, error)) {
+            if (reply) {
+                completeRequest(error);
+            } else {
+                stats.broadcasts++;
+            }
+        }
+    }
+};
+
+// Conecta y, si hace falta, negocia el protocolo binario
+SOCKET openConnection(const LoadConfig& config) {
+    SOCKET fd = connectSocket(config.host.c_str(), config.port);
+    if (fd == INVALID_SOCKET || !config.binary) return fd;
+
+    BinaryMessage hello = {};
+    hello.op = BIN_OP_HELLO;
+    hello.aux = BINARY_PROTOCOL_VERSION;
+    char bytes[BINARY_MESSAGE_SIZE];
+    encodeBinaryMessage(hello, bytes);
+    if (send(fd, bytes, BINARY_MESSAGE_SIZE, SEND_FLAGS) == BINARY_MESSAGE_SIZE) {
+        // La respuesta es el primer mensaje: aún no hay difusiones
+        int received = 0;
+        while (received < BINARY_MESSAGE_SIZE) {
+            int n = recvWait(fd, bytes + received, BINARY_MESSAGE_SIZE - received);
+            if (n <= 0) break;
+            received += n;
+        }
+        BinaryMessage reply;
+        decodeBinaryMessage(bytes, reply);
+        if (received == BINARY_MESSAGE_SIZE && reply.result == RESULT_HELLO) return fd;
+    }
+    closesocket(fd);
+    return INVALID_SOCKET;
+}
+
+} // namespace
+
+bool runLoad(const LoadConfig& config, LoadResult& result) {
+    if (config.connections < 1 || config.depth < 1 || config.spots < 1 ||
+        config.durationSeconds <= 0 || config.rate < 0 ||
+        config.workload.occupancy <= 0 || config.workload.occupancy > 1 ||
+        config.workload.meanDwellMinutes <= 0) {
+        std::cerr << "Parametros de carga invalidos\n";
+        return false;
+    }
+    if (config.connections > config.spots) {
+        std::cerr << "Cada conexion necesita al menos una plaza (--plazas >= --conexiones)\n";
+        return false;
+    }
+
+    // Todas las conexiones se abren antes de empezar a medir
+    std::vector<SOCKET> sockets;
+    for (int i = 0; i < config.connections; i++) {
+        SOCKET fd = openConnection(config);
+        if (fd == INVALID_SOCKET) {
+            std::cerr << "No se pudo abrir la conexion " << (i + 1) << " con "
+                      << config.host << ":" << config.port << "\n";
+            for (SOCKET open : sockets) closesocket(open);
+            return false;
+        }
+        sockets.push_back(fd);
+    }
+
+    // Ocupación inicial del modelo, antes de medir
+    std::vector<ConnectionStats> stats((size_t)config.connections);
+    std::vector<std::unique_ptr<LoadConnection> > connections;
+    for (int i = 0; i < config.connections; i++) {
+        connections.emplace_back(new LoadConnection(config, sockets[(size_t)i], i, stats[(size_t)i]));
+        if (!connections.back()->warmUp()) {
+            std::cerr << "La conexion " << (i + 1) << " no pudo enviar las entradas iniciales\n";
+            for (SOCKET open : sockets) closesocket(open);
+            return false;
+        }
+    }
+
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(50);
+    for (int i = 0; i < config.connections; i++) {
+        LoadConnection* connection = connections[(size_t)i].get();
+        threads.emplace_back([connection, start]() { connection->run(start); });
+    }
+    for (std::thread& thread : threads) thread.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    for (SOCKET fd : sockets) closesocket(fd);
+
+    result = LoadResult();
+    for (const ConnectionStats& s : stats) {
+        result.latency.merge(s.latency);
+        result.sent += s.sent;
+        result.entries += s.entries;
+        result.replies += s.replies;
+        result.errors += s.errors;
+        result.broadcasts += s.broadcasts;
+        result.unanswered += s.unanswered;
+        result.rejected += s.rejected;
+        result.occupied += s.occupied;
+        result.spots += s.spots;
+        if (s.simulatedSeconds > result.simulatedSeconds) result.simulatedSeconds = s.simulatedSeconds;
+        if (s.failed) result.failedConnections++;
+    }
+
+    // Throughput sobre la duración pedida (sin el drenaje final)
+    result.measuredSeconds = elapsed < config.durationSeconds ? elapsed : config.durationSeconds;
+    return true;
+}
+
+int runLoadGenerator(const LoadConfig& config) {
+    LoadResult total;
+    if (!runLoad(config, total)) return 1;
+
+    std::cout << "\n================================================\n";
+    std::cout << "  PRUEBA DE CARGA\n";
+    std::cout << "================================================\n";
+    std::cout << "  Conexiones: " << config.connections << " | Profundidad: " << config.depth
+              << " | Protocolo: " << (config.binary ? "binario" : "texto") << "\n";
+    if (config.rate > 0) {
+        static const char* ARRIVAL_NAMES[] = { "Poisson", "fijas", "modelo" };
+        std::cout << "  Tasa objetivo: " << config.rate << " ev/s | Llegadas: "
+                  << ARRIVAL_NAMES[config.arrivals] << "\n";
+    } else {
+        std::cout << "  Tasa objetivo: maxima (lazo cerrado)\n";
+    }
+    std::cout << "  Duracion: " << config.durationSeconds << " s | Semilla: " << config.seed << "\n\n";
+    std::cout << "  Modelo: ocupacion " << (int)(config.workload.occupancy * 100 + 0.5)
+              << " % | estancia media " << config.workload.meanDwellMinutes << " min | "
+              << std::fixed << std::setprecision(1) << total.simulatedSeconds / 3600.0
+              << " h simuladas desde las " << config.workload.startHour << ":00\n";
+    std::cout << "  Ocupacion final: " << total.occupied << " / " << total.spots
+              << " | Llegadas perdidas (lleno): " << total.rejected << "\n\n";
+    std::cout << "  Enviados:     " << total.sent << " (" << total.entries << " entradas, "
+              << (total.sent - total.entries) << " salidas)\n";
+    std::cout << "  Respuestas:   " << total.replies << " (" << total.errors << " errores)\n";
+    std::cout << "  Sin respuesta: " << total.unanswered << "\n";
+    std::cout << "  Difusiones:   " << total.broadcasts << "\n";
+    std::cout << "  Throughput:   " << std::fixed << std::setprecision(1)
+              << total.replies / total.measuredSeconds << " respuestas/s\n\n";
+    std::cout << "  Latencia desde el envio previsto:\n";
+    printLatencyReport(total.latency);
+    if (total.failedConnections > 0) {
+        std::cout << "\n  [!] " << total.failedConnections << " conexiones se cerraron antes de terminar\n";
+    }
+    std::cout << "\n";
+    return total.failedConnections > 0 ? 1 : 0;
+}
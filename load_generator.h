@@ -0,0 +1,123 @@
+// ============================================================================
+// ARCHIVO: load_generator.h
+// PROPÓSITO: Generador de carga para medir el servidor (modo --carga de
+//            cliente.cpp)
+// DESCRIPCIÓN: Abre N conexiones (un hilo cada una) y envía eventos de
+//              ENTRADA/SALIDA a una tasa objetivo durante un tiempo fijo.
+//              Cada conexión tiene su propio WorkloadModel con sus plazas y
+//              su flota, así que las salidas son de vehículos que sí están
+//              dentro.
+//              Al final informa el throughput logrado y los percentiles de
+//              latencia (p50/p90/p99/p99.9) de un LatencyHistogram.
+//
+// LAZO ABIERTO: Los envíos siguen un calendario fijado de antemano
+//   (llegadas Poisson, a intervalo fijo o con las horas del modelo),
+//   independiente de las respuestas. La latencia se mide desde el instante
+//   PREVISTO de envío, no desde el real: si el servidor se atasca, los
+//   eventos que debieron salir durante el atasco cuentan todo ese tiempo
+//   ("coordinated omission"). Con --tasa 0 es lazo cerrado: cada conexión envía en
+//   cuanto tiene hueco (throughput máximo, latencias no comparables).
+//
+// PROFUNDIDAD: Solicitudes en vuelo por conexión (pipelining). Si se llega
+//   al límite, los eventos previstos esperan y esa espera forma parte de su
+//   latencia.
+// ============================================================================
+
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <functional>
+#include <string>
+#include <stdint.h>
+
+#include "latency_histogram.h"
+#include "workload_model.h"
+
+// Cuándo sale cada evento
+enum LoadArrivals {
+    ARRIVALS_POISSON,   // Intervalos exponenciales a la tasa pedida
+    ARRIVALS_FIXED,     // Intervalo constante
+    ARRIVALS_MODEL      // Horas del modelo (curva del día) comprimidas a la tasa media
+};
+
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    int connections = 1;
+    double rate = 1000;            // Eventos por segundo en total (0 = lazo cerrado)
+    LoadArrivals arrivals = ARRIVALS_POISSON;
+    double durationSeconds = 10;
+    int depth = 1;                 // Solicitudes en vuelo por conexión
+    unsigned long long seed = 1;   // Misma semilla = mismos eventos y llegadas
+    int spots = 40;                // Plazas, repartidas entre las conexiones
+    bool binary = false;           // Protocolo binario (binary_protocol.h)
+    WorkloadConfig workload;       // Qué eventos se envían (workload_model.h)
+
+    // Opcional: se llama desde el hilo de la conexión justo antes de enviar
+    // cada evento medido (bench_e2e.cpp lo usa para medir las difusiones)
+    std::function<void(const WorkloadEvent& event)> onSend;
+};
+
+// Totales de una prueba
+struct LoadResult {
+    LatencyHistogram latency;      // Desde el envío previsto
+    uint64_t sent = 0;
+    uint64_t entries = 0;
+    uint64_t replies = 0;
+    uint64_t errors = 0;
+    uint64_t broadcasts = 0;
+    uint64_t unanswered = 0;
+    uint64_t rejected = 0;         // Llegadas del modelo con el parqueadero lleno
+    int occupied = 0;
+    int spots = 0;
+    double simulatedSeconds = 0;
+    double measuredSeconds = 0;    // Duración de los envíos (sin el drenaje final)
+    int failedConnections = 0;     // Conexiones cerradas antes de terminar
+};
+
+// Ejecuta la prueba sin imprimir el informe.
+// RETORNA: false si no se pudo empezar (el motivo sale por cerr)
+bool runLoad(const LoadConfig& config, LoadResult& result);
+
+// Ejecuta la prueba e imprime el informe. Retorna el código de salida
+// (0 = todas las conexiones funcionaron)
+int runLoadGenerator(const LoadConfig& config);
+
+// ============================================================================
+// CLASE: ReplyReader
+// PROPÓSITO: Separa lo que llega por una conexión en mensajes completos y
+//            distingue las respuestas (texto "OK..."/"ERROR...", binario
+//            op | BIN_OP_REPLY) de las difusiones. Las respuestas llegan en
+//            el orden de las solicitudes. En binario, las difusiones que
+//            salen antes de que el servidor lea el HELLO llegan como líneas
+//            de texto: se descartan hasta el primer mensaje binario
+// ============================================================================
+class ReplyReader {
+private:
+    std::string inbound;
+    size_t start;
+    bool binary;
+    bool synced;         // Binario: ya llegó el primer mensaje binario
+
+    void compact();
+
+public:
+    explicit ReplyReader(bool binary = false) : start(0), binary(binary), synced(false) {}
+
+    void setBinary(bool value) { binary = value; synced = false; }
+    void append(const char* data, size_t length) { inbound.append(data, length); }
+
+    // Siguiente mensaje completo (false si no hay). error solo vale true
+    // en respuestas de error
+    bool next(bool& reply, bool& error);
+};
+
+// Imprime p50/p90/p99/p99.9/max en microsegundos
+void printLatencyReport(const LatencyHistogram& latency);
+
+// Hora local actual en "YYYY-MM-DD HH:MM:SS" (text: al menos 20 bytes).
+// Retorna la misma hora en segundos desde 1970 como hora civil, sin zona
+// horaria (lo que guarda el servidor)
+long long localTimestamp(char* text);
+
+#endif
@@ -0,0 +1,87 @@
+#include "loop_inbox.h"
+#include <thread>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Buzón del bucle que corre en este hilo (nullptr fuera de los bucles)
+static thread_local LoopInbox* ownInbox = nullptr;
+
+LoopInbox::LoopInbox() : eventFd(-1), closed(false) {}
+
+LoopInbox::~LoopInbox() {
+    if (eventFd != -1) ::close(eventFd);
+}
+
+bool LoopInbox::init() {
+    eventFd = eventfd(0, EFD_CLOEXEC);
+    return eventFd != -1;
+}
+
+void LoopInbox::bindToCurrentThread() {
+    ownInbox = this;
+}
+
+void LoopInbox::post(const PayloadPtr& payload) {
+    bool wasEmpty;
+    {
+        lock_guard<mutex> guard(lock);
+        if (closed) return;
+        wasEmpty = pending.empty();
+        pending.push_back(payload);
+    }
+    // Si no estaba vacío, el dueño ya tiene un aviso sin atender
+    if (wasEmpty && this != ownInbox) {
+        wake();
+    }
+}
+
+void LoopInbox::wake() {
+    uint64_t one = 1;
+    ssize_t written = write(eventFd, &one, sizeof(one));
+    (void)written;
+}
+
+void LoopInbox::take(vector<PayloadPtr>& out) {
+    lock_guard<mutex> guard(lock);
+    out.swap(pending);
+    pending.clear();
+}
+
+void LoopInbox::close() {
+    lock_guard<mutex> guard(lock);
+    closed = true;
+    pending.clear();
+}
+
+int eventLoopCount(int requested) {
+    if (requested > 0) return requested;
+    int cores = (int)thread::hardware_concurrency();
+    return (cores > 0) ? cores : 1;
+}
+
+void postToOtherLoops(const vector<LoopInbox*>& inboxes, size_t self, const PayloadPtr& payload) {
+    for (size_t i = 0; i < inboxes.size(); ++i) {
+        if (i != self) inboxes[i]->post(payload);
+    }
+}
+
+void publishToLoops(vector<ParkingUpdate>& updates, void* context) {
+    const vector<LoopInbox*>& inboxes = *(const vector<LoopInbox*>*)context;
+    static vector<PayloadPtr> payloads;    // Solo desde publishEvents
+    makeOrderedPayloads(updates, payloads);
+    for (const PayloadPtr& payload : payloads) {
+        for (LoopInbox* inbox : inboxes) {
+            inbox->post(payload);
+        }
+    }
+    payloads.clear();
+}
+
+void wakeLoops(void* context) {
+    const vector<LoopInbox*>& inboxes = *(const vector<LoopInbox*>*)context;
+    for (LoopInbox* inbox : inboxes) {
+        inbox->wake();
+    }
+}
@@ -0,0 +1,77 @@
+// ============================================================================
+// ARCHIVO: loop_inbox.h
+// PROPÓSITO: Buzón de difusiones entre los bucles de los motores epoll y
+//            uring (solo Linux)
+// DESCRIPCIÓN: Con --bucles N cada bucle tiene su propio socket de escucha
+//              (SO_REUSEPORT) y sus propias conexiones, pero un cambio en
+//              una plaza debe llegar a los clientes de todos. Quien publica
+//              (ver publishEvents) deja cada payload (ya codificado,
+//              compartido) en el buzón de TODOS los bucles, también en el
+//              suyo, y en orden de secuencia: cada bucle difunde desde su
+//              buzón, así que todos reciben los eventos en el mismo orden.
+//              Un eventfd despierta al dueño del buzón, que lo vigila junto
+//              con sus sockets; solo se escribe en él cuando el buzón pasa
+//              de vacío a no vacío, y nunca para el buzón del propio hilo
+//              (el bucle lo vacía al terminar de aplicar su lote).
+// ============================================================================
+
+#ifndef LOOP_INBOX_H
+#define LOOP_INBOX_H
+
+#include <mutex>
+#include <vector>
+#include "broadcaster.h"
+
+class LoopInbox {
+private:
+    std::mutex lock;
+    std::vector<PayloadPtr> pending;
+    int eventFd;
+    bool closed;
+
+public:
+    LoopInbox();
+    ~LoopInbox();
+    LoopInbox(const LoopInbox&) = delete;
+    LoopInbox& operator=(const LoopInbox&) = delete;
+
+    // Crea el eventfd. RETORNA: false si falla
+    bool init();
+
+    // Descriptor que se vuelve legible cuando hay algo en el buzón
+    int fd() const { return eventFd; }
+
+    // Desde el hilo del dueño, antes de su bucle: lo que este hilo deje en
+    // su propio buzón no escribe en el eventfd
+    void bindToCurrentThread();
+
+    // Desde cualquier hilo
+    void post(const PayloadPtr& payload);
+
+    // Desde cualquier hilo: despierta al dueño aunque no haya nada que
+    // sacar (el WAL avisa así que hay respuestas que ya se pueden enviar)
+    void wake();
+
+    // Desde el dueño, después de leer el eventfd: saca todo lo pendiente,
+    // en orden de llegada
+    void take(std::vector<PayloadPtr>& out);
+
+    // Desde el dueño, cuando su bucle termina: lo pendiente y lo que llegue
+    // después se descarta (nadie lo va a sacar)
+    void close();
+};
+
+// Bucles a crear para --bucles N (0 = uno por núcleo)
+int eventLoopCount(int requested);
+
+// Deja el payload en todos los buzones menos en el del bucle self
+void postToOtherLoops(const std::vector<LoopInbox*>& inboxes, size_t self, const PayloadPtr& payload);
+
+// Publicador de los motores epoll y uring (ver setEventPublisher); context
+// es el std::vector<LoopInbox*> de todos los bucles
+void publishToLoops(std::vector<ParkingUpdate>& updates, void* context);
+
+// Aviso del WAL (ver setWalListener) para los mismos bucles
+void wakeLoops(void* context);
+
+#endif
@@ -0,0 +1,101 @@
+// ============================================================================
+// ARCHIVO: mpsc_queue.h
+// PROPÓSITO: Cola acotada sin locks, varios productores / un consumidor
+// DESCRIPCIÓN: Arreglo circular en el que cada celda lleva un número de
+//              secuencia atómico (esquema de D. Vyukov). Los productores
+//              reservan una celda con un CAS sobre enqueuePos; el único
+//              consumidor no necesita operaciones atómicas de escritura
+//              compartida. Si la cola está llena, push() retorna false
+//              y el productor decide (descartar, reintentar...)
+// ============================================================================
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T>
+class MpscQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    Cell* cells;
+    size_t mask;
+
+    // En líneas de caché distintas para que productores y consumidor
+    // no se invaliden mutuamente
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos;
+
+public:
+    // capacity se redondea a la siguiente potencia de dos
+    explicit MpscQueue(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells = new Cell[size];
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue() {
+        delete[] cells;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Seguro desde cualquier hilo
+    bool push(const T& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Llena
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Solo desde el hilo consumidor
+    bool pop(T& value) {
+        Cell* cell = &cells[dequeuePos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (seq != dequeuePos + 1) {
+            return false;  // Vacía (o el productor aún no termina de escribir)
+        }
+        value = cell->value;
+        cell->sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    // Solo desde el hilo consumidor: true si pop() fallaría ahora
+    bool empty() const {
+        const Cell* cell = &cells[dequeuePos & mask];
+        return cell->sequence.load(std::memory_order_acquire) != dequeuePos + 1;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
+
+#endif
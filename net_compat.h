@@ -0,0 +1,338 @@
+// ============================================================================
+// ARCHIVO: net_compat.h
+// PROPÓSITO: Capa mínima de compatibilidad de sockets Windows / POSIX
+// DESCRIPCIÓN: Permite compilar el servidor y el cliente con Winsock2
+//              (Windows) o con sockets BSD (Linux) sin llenar el código de
+//              #ifdef
+// ============================================================================
+
+#ifndef NET_COMPAT_H
+#define NET_COMPAT_H
+
+#ifdef _WIN32
+
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+#pragma comment(lib, "ws2_32.lib")
+
+typedef int socklen_t;
+
+// En Windows send() no genera señales
+#define SEND_FLAGS 0
+
+// Windows no tiene MSG_DONTWAIT: el socket se pone en modo no bloqueante
+// con enableNonBlockingSend()
+#define SEND_NOWAIT_FLAGS 0
+
+#else
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+
+typedef int SOCKET;
+
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR   (-1)
+
+// MSG_NOSIGNAL evita que un cliente desconectado mate el proceso con SIGPIPE
+#define SEND_FLAGS MSG_NOSIGNAL
+
+// send() que nunca espera, sin cambiar el modo del socket
+#define SEND_NOWAIT_FLAGS (MSG_NOSIGNAL | MSG_DONTWAIT)
+
+inline int closesocket(SOCKET s)
+{
+	return close(s);
+}
+
+#endif
+
+// ============================================================================
+// FUNCIÓN: initSockets / cleanupSockets
+// PROPÓSITO: Inicializar y liberar la librería de sockets (solo Windows)
+// ============================================================================
+inline bool initSockets()
+{
+#ifdef _WIN32
+	WSADATA wsaData;
+	return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+#else
+	return true;
+#endif
+}
+
+inline void cleanupSockets()
+{
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+// ============================================================================
+// FUNCIÓN: setNonBlocking
+// PROPÓSITO: Pone un socket en modo no bloqueante
+// RETORNA: true si se pudo cambiar el modo
+// ============================================================================
+inline bool setNonBlocking(SOCKET s)
+{
+#ifdef _WIN32
+	u_long mode = 1;
+	return ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+	int flags = fcntl(s, F_GETFL, 0);
+	if (flags == -1)
+	{
+		return false;
+	}
+	return fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+// ============================================================================
+// FUNCIÓN: enableNonBlockingSend
+// PROPÓSITO: Prepara un socket para send(..., SEND_NOWAIT_FLAGS)
+// NOTA: En Windows el socket entero pasa a no bloqueante, así que quien
+//       lee de él debe usar recvWait()
+// ============================================================================
+inline bool enableNonBlockingSend(SOCKET s)
+{
+#ifdef _WIN32
+	return setNonBlocking(s);
+#else
+	(void)s;
+	return true;
+#endif
+}
+
+// true si el último send/recv falló solo porque el socket no estaba listo
+inline bool socketWouldBlock()
+{
+#ifdef _WIN32
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+// ============================================================================
+// FUNCIÓN: recvWait
+// PROPÓSITO: recv() que espera datos aunque el socket sea no bloqueante
+// RETORNA: Lo mismo que recv() (0 = conexión cerrada)
+// ============================================================================
+inline int recvWait(SOCKET s, char* buffer, int length)
+{
+	while (true)
+	{
+		int n = (int)recv(s, buffer, length, 0);
+		if (n != SOCKET_ERROR || !socketWouldBlock())
+		{
+			return n;
+		}
+
+#ifdef _WIN32
+		// Esperar a que haya datos (en POSIX el socket sigue bloqueante y
+		// aquí solo se llega por EINTR)
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(s, &readable);
+		select(0, &readable, nullptr, nullptr, nullptr);
+#endif
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: waitReadable
+// PROPÓSITO: Espera hasta timeoutMs ms (-1 = sin límite) a que el socket
+//            tenga datos. En POSIX usa poll: select no admite descriptores
+//            mayores que FD_SETSIZE
+// RETORNA: 1 si hay datos (o la conexión se cerró), 0 si expiró, -1 si error
+// ============================================================================
+inline int waitReadable(SOCKET s, int timeoutMs)
+{
+#ifdef _WIN32
+	fd_set readable;
+	FD_ZERO(&readable);
+	FD_SET(s, &readable);
+	struct timeval timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_usec = (timeoutMs % 1000) * 1000;
+	int ready = select(0, &readable, nullptr, nullptr, timeoutMs < 0 ? nullptr : &timeout);
+#else
+	struct pollfd entry;
+	entry.fd = s;
+	entry.events = POLLIN;
+	entry.revents = 0;
+	int ready = poll(&entry, 1, timeoutMs);
+#endif
+	if (ready == SOCKET_ERROR)
+	{
+		return -1;
+	}
+	return ready > 0 ? 1 : 0;
+}
+
+// ============================================================================
+// FUNCIÓN: pollSockets
+// PROPÓSITO: poll() sobre varios sockets a la vez (WSAPoll en Windows).
+//            Cada PollEntry lleva fd, events (POLLIN...) y revents
+// RETORNA: Sockets listos, 0 si expiró, SOCKET_ERROR si hubo error
+// ============================================================================
+#ifdef _WIN32
+typedef WSAPOLLFD PollEntry;
+#else
+typedef struct pollfd PollEntry;
+#endif
+
+inline int pollSockets(PollEntry* entries, unsigned long count, int timeoutMs)
+{
+#ifdef _WIN32
+	return WSAPoll(entries, count, timeoutMs);
+#else
+	return poll(entries, (nfds_t)count, timeoutMs);
+#endif
+}
+
+// ============================================================================
+// FUNCIÓN: setNoDelay
+// PROPÓSITO: Desactiva Nagle. Los mensajes son pequeños: con Nagle, una
+//            respuesta seguida de una difusión espera al ACK retardado del
+//            otro extremo (~40 ms) antes de salir
+// ============================================================================
+inline void setNoDelay(SOCKET s)
+{
+	int yes = 1;
+	setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&yes, sizeof(yes));
+}
+
+// ============================================================================
+// FUNCIÓN: connectSocket
+// PROPÓSITO: Crea un socket TCP sin Nagle y lo conecta a host:puerto (IPv4)
+// RETORNA: El socket conectado, o INVALID_SOCKET si algo falla
+// ============================================================================
+inline SOCKET connectSocket(const char* host, int port)
+{
+	struct sockaddr_in direccion;
+	direccion.sin_family = AF_INET;
+	direccion.sin_port = htons((unsigned short)port);
+	if (inet_pton(AF_INET, host, &direccion.sin_addr) <= 0)
+	{
+		return INVALID_SOCKET;
+	}
+
+	SOCKET fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd == INVALID_SOCKET)
+	{
+		return INVALID_SOCKET;
+	}
+	if (connect(fd, (struct sockaddr*)&direccion, sizeof(direccion)) == SOCKET_ERROR)
+	{
+		closesocket(fd);
+		return INVALID_SOCKET;
+	}
+
+	setNoDelay(fd);
+	return fd;
+}
+
+// ============================================================================
+// FUNCIÓN: createWakeSocket
+// PROPÓSITO: Socket UDP conectado a sí mismo en 127.0.0.1. Un send() desde
+//            otro hilo lo vuelve legible y despierta a quien espera en
+//            pollSockets (WSAPoll no acepta pipes)
+// RETORNA: El socket (no bloqueante), o INVALID_SOCKET si algo falla
+// ============================================================================
+inline SOCKET createWakeSocket()
+{
+	SOCKET fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd == INVALID_SOCKET)
+	{
+		return INVALID_SOCKET;
+	}
+
+	struct sockaddr_in direccion = {};
+	direccion.sin_family = AF_INET;
+	direccion.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(direccion);
+
+	if (bind(fd, (struct sockaddr*)&direccion, sizeof(direccion)) == SOCKET_ERROR ||
+		getsockname(fd, (struct sockaddr*)&direccion, &length) == SOCKET_ERROR ||
+		connect(fd, (struct sockaddr*)&direccion, sizeof(direccion)) == SOCKET_ERROR ||
+		!setNonBlocking(fd))
+	{
+		closesocket(fd);
+		return INVALID_SOCKET;
+	}
+	return fd;
+}
+
+// ============================================================================
+// FUNCIÓN: shutdownSocket
+// PROPÓSITO: Corta la conexión sin liberar el socket: el recv() del hilo
+//            dueño retorna 0 y es ese hilo quien llama a closesocket()
+// ============================================================================
+inline void shutdownSocket(SOCKET s)
+{
+#ifdef _WIN32
+	shutdown(s, SD_BOTH);
+#else
+	shutdown(s, SHUT_RDWR);
+#endif
+}
+
+// ============================================================================
+// FUNCIÓN: createListenSocket
+// PROPÓSITO: Crea un socket TCP, lo enlaza al puerto y lo pone a escuchar
+// PARÁMETROS:
+//   - backlog: Conexiones completas que esperan accept() (el núcleo lo
+//              limita a net.core.somaxconn)
+//   - reusePort: SO_REUSEPORT (Linux): varios sockets en el mismo puerto,
+//                el núcleo reparte las conexiones entre ellos
+// RETORNA: El socket listo para accept(), o INVALID_SOCKET si algo falla
+// ============================================================================
+inline SOCKET createListenSocket(int port, int backlog, bool reusePort = false)
+{
+	SOCKET fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd == INVALID_SOCKET)
+	{
+		return INVALID_SOCKET;
+	}
+
+#ifdef _WIN32
+	(void)reusePort;    // Windows no tiene SO_REUSEPORT
+#else
+	// Permitir reiniciar el servidor sin esperar a que expire TIME_WAIT
+	// (en Windows SO_REUSEADDR permite robar el puerto, por eso no se usa)
+	int yes = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&yes, sizeof(yes));
+#ifdef SO_REUSEPORT
+	if (reusePort && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (const char*)&yes, sizeof(yes)) == SOCKET_ERROR)
+	{
+		closesocket(fd);
+		return INVALID_SOCKET;
+	}
+#endif
+#endif
+
+	struct sockaddr_in direccion;
+	direccion.sin_family = AF_INET;
+	direccion.sin_addr.s_addr = INADDR_ANY;
+	direccion.sin_port = htons((unsigned short)port);
+
+	if (bind(fd, (struct sockaddr*)&direccion, sizeof(direccion)) == SOCKET_ERROR ||
+		listen(fd, backlog) == SOCKET_ERROR)
+	{
+		closesocket(fd);
+		return INVALID_SOCKET;
+	}
+	return fd;
+}
+
+#endif
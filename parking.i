@@ -1,7 +1,13 @@
-%module parking
-
-%{
-#include "parking_lib.h"
-%}
-
+%module parking
+
+%{
+#include "parking_lib.h"
+%}
+
+// Permite ParkingManager(capacity=2000) desde Python
+%feature("kwargs") ParkingManager::ParkingManager;
+
+// El índice de placas es interno (el servidor lo usa directamente)
+%ignore PlateIndex;
+
 %include "parking_lib.h"
\ No newline at end of file
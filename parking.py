@@ -1,108 +0,0 @@
-# This file was automatically generated by SWIG (https://www.swig.org).
-# Version 4.4.0
-#
-# Do not make changes to this file unless you know what you are doing - modify
-# the SWIG interface file instead.
-
-from sys import version_info as _swig_python_version_info
-# Import the low-level C/C++ module
-if getattr(globals().get("__spec__"), "parent", None) or __package__ or "." in __name__:
-    from . import _parking
-else:
-    import _parking
-
-try:
-    import builtins as __builtin__
-except ImportError:
-    import __builtin__
-
-def _swig_repr(self):
-    try:
-        strthis = "proxy of " + self.this.__repr__()
-    except __builtin__.Exception:
-        strthis = ""
-    return "<%s.%s; %s >" % (self.__class__.__module__, self.__class__.__name__, strthis,)
-
-
-def _swig_setattr_nondynamic_instance_variable(set):
-    def set_instance_attr(self, name, value):
-        if name == "this":
-            set(self, name, value)
-        elif name == "thisown":
-            self.this.own(value)
-        elif hasattr(self, name) and isinstance(getattr(type(self), name), property):
-            set(self, name, value)
-        else:
-            raise AttributeError("You cannot add instance attributes to %s" % self)
-    return set_instance_attr
-
-
-def _swig_setattr_nondynamic_class_variable(set):
-    def set_class_attr(cls, name, value):
-        if hasattr(cls, name) and not isinstance(getattr(cls, name), property):
-            set(cls, name, value)
-        else:
-            raise AttributeError("You cannot add class attributes to %s" % cls)
-    return set_class_attr
-
-
-def _swig_add_metaclass(metaclass):
-    """Class decorator for adding a metaclass to a SWIG wrapped class - a slimmed down version of six.add_metaclass"""
-    def wrapper(cls):
-        return metaclass(cls.__name__, cls.__bases__, cls.__dict__.copy())
-    return wrapper
-
-
-class _SwigNonDynamicMeta(type):
-    """Meta class to enforce nondynamic attributes (no new attributes) for a class"""
-    __setattr__ = _swig_setattr_nondynamic_class_variable(type.__setattr__)
-
-
-class VehicleInfo(object):
-    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
-    __repr__ = _swig_repr
-    plate = property(_parking.VehicleInfo_plate_get, _parking.VehicleInfo_plate_set)
-    timestamp = property(_parking.VehicleInfo_timestamp_get, _parking.VehicleInfo_timestamp_set)
-    occupied = property(_parking.VehicleInfo_occupied_get, _parking.VehicleInfo_occupied_set)
-
-    def __init__(self):
-        _parking.VehicleInfo_swiginit(self, _parking.new_VehicleInfo())
-    __swig_destroy__ = _parking.delete_VehicleInfo
-
-# Register VehicleInfo in _parking:
-_parking.VehicleInfo_swigregister(VehicleInfo)
-class ParkingManager(object):
-    thisown = property(lambda x: x.this.own(), lambda x, v: x.this.own(v), doc="The membership flag")
-    __repr__ = _swig_repr
-
-    def __init__(self):
-        _parking.ParkingManager_swiginit(self, _parking.new_ParkingManager())
-
-    def getTotalSpots(self):
-        return _parking.ParkingManager_getTotalSpots(self)
-
-    def isSpotOccupied(self, spotIndex):
-        return _parking.ParkingManager_isSpotOccupied(self, spotIndex)
-
-    def getPlate(self, spotIndex):
-        return _parking.ParkingManager_getPlate(self, spotIndex)
-
-    def addVehicle(self, spotIndex, plate, timestamp):
-        return _parking.ParkingManager_addVehicle(self, spotIndex, plate, timestamp)
-
-    def removeVehicle(self, plate):
-        return _parking.ParkingManager_removeVehicle(self, plate)
-
-    def findPlate(self, plate):
-        return _parking.ParkingManager_findPlate(self, plate)
-
-    def getOccupiedCount(self):
-        return _parking.ParkingManager_getOccupiedCount(self)
-
-    def getFreeCount(self):
-        return _parking.ParkingManager_getFreeCount(self)
-    __swig_destroy__ = _parking.delete_ParkingManager
-
-# Register ParkingManager in _parking:
-_parking.ParkingManager_swigregister(ParkingManager)
-
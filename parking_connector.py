@@ -1,251 +1,444 @@
-# ============================================================================
-# ARCHIVO: parking_connector.py
-# PROPÓSITO: Conecta el visualizador Python con el sistema de parking
-# DESCRIPCIÓN: Esta clase actúa como "puente" entre:
-#              1. La librería SWIG (parking) - gestiona el estado en memoria
-#              2. El servidor C++ (opcional) - recibe actualizaciones en tiempo real
-# ============================================================================
-
-# IMPORTACIONES
-# -------------
-# socket: Para comunicación de red (conectar al servidor C++)
-import socket
-
-# parking: La librería que creamos con SWIG desde C++
-# Nos permite usar la clase ParkingManager desde Python
-import parking
-
-# threading: Para manejar hilos (no se usa directamente aquí, pero se importó)
-import threading
-
-# datetime: Para obtener fecha y hora actual
-from datetime import datetime
-
-
-class ParkingConnector:
-    """
-    Clase que conecta todos los componentes del sistema.
-    
-    Responsabilidades:
-    - Crear y gestionar una instancia de ParkingManager (librería SWIG)
-    - Conectarse al servidor C++ (opcional)
-    - Escuchar mensajes del servidor
-    - Proporcionar el estado del parking al visualizador
-    """
-    
-    def __init__(self):
-        """
-        Constructor: Se ejecuta al crear un objeto ParkingConnector.
-        
-        Inicializa:
-        - parking_manager: Instancia de la clase C++ a través de SWIG
-        - sock: Socket para conectar al servidor (inicialmente None)
-        """
-        
-        # CREAR INSTANCIA DE LA LIBRERÍA SWIG
-        # ------------------------------------
-        # parking.ParkingManager() llama al constructor de la clase C++
-        # Esto crea un objeto en memoria que gestiona las 40 plazas
-        # ¡Es código C++ ejecutándose desde Python gracias a SWIG!
-        self.parking_manager = parking.ParkingManager()
-        
-        # INICIALIZAR SOCKET
-        # ------------------
-        # El socket nos permitirá conectarnos al servidor C++
-        # Inicialmente es None (sin conexión)
-        self.sock = None
-        
-    def connect_to_server(self):
-        """
-        Intenta conectarse al servidor C++ en localhost:8080.
-        
-        ¿Qué hace?
-        1. Crea un socket TCP/IP
-        2. Intenta conectar a 127.0.0.1 (localhost) puerto 8080
-        3. Si falla, lanza una excepción
-        
-        NOTA: El servidor actual solo acepta un cliente a la vez.
-        Por eso el visualizador funciona en modo local.
-        """
-        
-        # CREAR SOCKET
-        # ------------
-        # AF_INET = Familia de direcciones IPv4
-        # SOCK_STREAM = Tipo TCP (conexión confiable y ordenada)
-        self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-        
-        # CONECTAR AL SERVIDOR
-        # --------------------
-        # 'localhost' o '127.0.0.1' = Esta misma computadora
-        # 8080 = Puerto donde el servidor está escuchando
-        # Si el servidor no está corriendo, esto lanzará una excepción
-        self.sock.connect(('localhost', 8080))
-    
-    def listen_updates(self):
-        """
-        Escucha actualizaciones del servidor en tiempo real.
-        
-        ¿Cómo funciona?
-        1. Intenta conectar al servidor C++
-        2. Si conecta: escucha mensajes en un bucle infinito
-        3. Si NO conecta: imprime mensaje y termina (modo local)
-        
-        Este método se ejecuta en un hilo separado para no bloquear la GUI.
-        """
-        
-        # BLOQUE TRY-EXCEPT PRINCIPAL
-        # ---------------------------
-        # Intenta conectar al servidor, pero si falla, no rompe el programa
-        try:
-            # Intentar conectarse
-            self.connect_to_server()
-            print("✓ Conectado al servidor en puerto 8080")
-            
-            # BUCLE DE ESCUCHA
-            # ----------------
-            # Ciclo infinito que escucha mensajes del servidor
-            while True:
-                try:
-                    # RECIBIR DATOS
-                    # -------------
-                    # recv(1024) = "Recibe hasta 1024 bytes de datos"
-                    # Este método BLOQUEA hasta que lleguen datos
-                    data = self.sock.recv(1024)
-                    
-                    # VERIFICAR SI EL SERVIDOR CERRÓ LA CONEXIÓN
-                    # -------------------------------------------
-                    # Si data está vacío, significa que el servidor cerró
-                    if not data:
-                        break
-                    
-                    # DECODIFICAR MENSAJE
-                    # -------------------
-                    # Los datos llegan como bytes, los convertimos a texto
-                    message = data.decode('utf-8').strip()
-                    print(f"📨 Mensaje del servidor: {message}")
-                    
-                    # PARSEAR Y ACTUALIZAR PARKING_MANAGER
-                    # -------------------------------------
-                    # El servidor envía mensajes en formato "PLAZA:PLACA:TIMESTAMP"
-                    # Ejemplo: "15:ABC123:2024-11-25 14:30:45"
-                    
-                    # Verificar si el mensaje tiene el formato correcto
-                    if ':' in message:
-                        try:
-                            # SEPARAR EL MENSAJE
-                            # ------------------
-                            # split(':') divide el string en el carácter ':'
-                            # Ejemplo: "15:ABC123:2024-11-25 14:30:45".split(':')
-                            #          → ["15", "ABC123", "2024-11-25 14", "30", "45"]
-                            # Necesitamos unir las últimas 3 partes para el timestamp
-                            parts = message.split(':')
-                            spot_str = parts[0]  # "15"
-                            plate = parts[1] if len(parts) > 1 else ""      # "ABC123"
-                            
-                            # Reconstruir timestamp (puede tener ':' en HH:MM:SS)
-                            timestamp = ':'.join(parts[2:]) if len(parts) > 2 else datetime.now().strftime("%Y-%m-%d %H:%M:%S")
-                            
-                            # CONVERTIR PLAZA A NÚMERO
-                            # -------------------------
-                            # El servidor envía plazas 1-40, pero internamente usamos 0-39
-                            spot_num = int(spot_str)  # Convertir "15" a 15
-                            spot_index = spot_num - 1  # Restar 1 para obtener índice (14)
-                            
-                            # VERIFICAR SI LA PLAZA ESTÁ EN RANGO VÁLIDO
-                            # -------------------------------------------
-                            if 0 <= spot_index < 40:
-                                # ACTUALIZAR EL PARKING_MANAGER
-                                # ------------------------------
-                                # El timestamp ya viene del mensaje parseado arriba
-                                
-                                # Verificar si la plaza ya está ocupada
-                                if self.parking_manager.isSpotOccupied(spot_index):
-                                    # Plaza ocupada → Verificar si es la misma placa
-                                    current_plate = self.parking_manager.getPlate(spot_index)
-                                    if current_plate == plate:
-                                        # Misma placa → Liberar (SALIDA)
-                                        self.parking_manager.removeVehicle(plate)
-                                        print(f"🚗→ Plaza {spot_num} liberada (era {plate})")
-                                    else:
-                                        # Placa diferente → Reemplazar (nueva placa en plaza ocupada)
-                                        self.parking_manager.removeVehicle(current_plate)
-                                        self.parking_manager.addVehicle(spot_index, plate, timestamp)
-                                        print(f"🔄 Plaza {spot_num} cambió: {current_plate} → {plate}")
-                                else:
-                                    # Plaza vacía → Ocupar (ENTRADA)
-                                    self.parking_manager.addVehicle(spot_index, plate, timestamp)
-                                    print(f"🚗← Plaza {spot_num} ocupada con {plate}")
-                            else:
-                                print(f"⚠ Plaza fuera de rango: {spot_num}")
-                                
-                        except Exception as e:
-                            print(f"✗ Error al parsear mensaje '{message}': {e}")
-                    
-                except Exception as e:
-                    # Si hay error al recibir datos, salir del bucle
-                    print(f"Error al recibir: {e}")
-                    break
-                    
-        except Exception as e:
-            # MANEJO DE ERROR DE CONEXIÓN
-            # ---------------------------
-            # Si no se puede conectar, el sistema funciona en "modo local"
-            # Esto es útil para desarrollar/probar sin tener el servidor corriendo
-            print(f"⚠ No se pudo conectar al servidor: {e}")
-            print("📝 Modo local: Puedes usar el visualizador sin servidor")
-            print("   Los cambios solo se guardarán en memoria local")
-    
-    def get_parking_state(self):
-        """
-        Obtiene el estado completo del parqueadero desde la librería SWIG.
-        
-        Retorna un diccionario con:
-        - total_spots: Número total de plazas (siempre 40)
-        - occupied_count: Cuántas plazas están ocupadas
-        - free_count: Cuántas plazas están libres
-        - vehicles: Lista de vehículos estacionados con su plaza y placa
-        
-        Este método es llamado por el visualizador cada vez que necesita
-        actualizar la pantalla.
-        """
-        
-        # OBTENER ESTADÍSTICAS GENERALES
-        # --------------------------------
-        # Estas funciones llaman directamente a los métodos de C++
-        # gracias a SWIG que genera automáticamente los "wrappers"
-        total_spots = self.parking_manager.getTotalSpots()        # Retorna 40
-        occupied_count = self.parking_manager.getOccupiedCount()  # Cuenta ocupadas
-        free_count = self.parking_manager.getFreeCount()          # Cuenta vacías
-        
-        # CREAR DICCIONARIO DE ESTADO
-        # ---------------------------
-        # Usamos un diccionario (dict) para organizar la información
-        # Es más fácil de usar que devolver 4 valores separados
-        parking_state = {
-            'total_spots': total_spots,
-            'occupied_count': occupied_count,
-            'free_count': free_count,
-            'vehicles': []  # Lista vacía que llenaremos a continuación
-        }
-        
-        # OBTENER INFORMACIÓN DE CADA VEHÍCULO
-        # -----------------------------------
-        # Iteramos por todas las plazas (0 a 39)
-        for spot_index in range(total_spots):
-            # Preguntar si esta plaza está ocupada
-            # (llama al método C++ isSpotOccupied)
-            if self.parking_manager.isSpotOccupied(spot_index):
-                # Si está ocupada, obtener la placa
-                # (llama al método C++ getPlate)
-                plate = self.parking_manager.getPlate(spot_index)
-                
-                # Agregar este vehículo a la lista
-                parking_state['vehicles'].append({
-                    'spot_index': spot_index,  # Índice de la plaza (0-39)
-                    'plate': plate              # Placa del vehículo (ej: "ABC123")
-                })
-        
-        # RETORNAR DICCIONARIO COMPLETO
-        # -----------------------------
-        # El visualizador usará este diccionario para actualizar la GUI
+# ============================================================================
+# ARCHIVO: parking_connector.py
+# PROPÓSITO: Conecta el visualizador Python con el sistema de parking
+# DESCRIPCIÓN: Esta clase actúa como "puente" entre:
+#              1. La librería SWIG (parking) - gestiona el estado en memoria
+#              2. El servidor C++ (opcional) - recibe actualizaciones en tiempo real
+# ============================================================================
+
+# IMPORTACIONES
+# -------------
+# socket: Para comunicación de red (conectar al servidor C++)
+import socket
+
+# parking: La librería que creamos con SWIG desde C++
+# Nos permite usar la clase ParkingManager desde Python
+import parking
+
+# threading: Para manejar hilos (no se usa directamente aquí, pero se importó)
+import threading
+
+# datetime: Para obtener fecha y hora actual
+from datetime import datetime, timedelta
+
+# base64, struct, time: Para decodificar el snapshot binario y esperar
+# entre reintentos de conexión
+import base64
+import struct
+import time
+
+
+# Segundos entre reintentos si se pierde la conexión con el servidor
+RECONNECT_DELAY = 2.0
+
+# Registro de vehículo del snapshot (ver buildSubscription en
+# parking_protocol.h): plaza u32, código de placa u32, hora i64
+SNAPSHOT_RECORD = struct.Struct('<IIq')
+
+
+def decode_plate(code):
+    """
+    Texto "AAA000" de un código de placa (mismo formato que plate_codec.h:
+    5 bits por letra y 10 bits para el número).
+    """
+    letters = ''.join(chr(ord('A') + ((code >> shift) & 31)) for shift in (20, 15, 10))
+    return f"{letters}{code & 0x3FF:03d}"
+
+
+def format_entry_time(seconds):
+    """Hora de entrada del snapshot (segundos desde 1970) como texto."""
+    if seconds == 0:
+        return datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+    return (datetime(1970, 1, 1) + timedelta(seconds=seconds)).strftime("%Y-%m-%d %H:%M:%S")
+
+
+class ParkingConnector:
+    """
+    Clase que conecta todos los componentes del sistema.
+    
+    Responsabilidades:
+    - Crear y gestionar una instancia de ParkingManager (librería SWIG)
+    - Conectarse al servidor C++ (opcional)
+    - Escuchar mensajes del servidor
+    - Proporcionar el estado del parking al visualizador
+    """
+    
+    def __init__(self):
+        """
+        Constructor: Se ejecuta al crear un objeto ParkingConnector.
+        
+        Inicializa:
+        - parking_manager: Instancia de la clase C++ a través de SWIG
+        - sock: Socket para conectar al servidor (inicialmente None)
+        """
+        
+        # CREAR INSTANCIA DE LA LIBRERÍA SWIG
+        # ------------------------------------
+        # parking.ParkingManager() llama al constructor de la clase C++
+        # Esto crea un objeto en memoria que gestiona las plazas (40 por
+        # defecto; parking.ParkingManager(capacity=2000) para otro tamaño)
+        # ¡Es código C++ ejecutándose desde Python gracias a SWIG!
+        self.parking_manager = parking.ParkingManager()
+        
+        # INICIALIZAR SOCKET
+        # ------------------
+        # El socket nos permitirá conectarnos al servidor C++
+        # Inicialmente es None (sin conexión)
+        self.sock = None
+        
+        # SUSCRIPCIÓN
+        # -----------
+        # last_sequence: último evento aplicado (None = aún sin snapshot).
+        # Al reconectar se pide "SUSCRIBIR:<last_sequence>" y el servidor
+        # reenvía solo lo que faltó (o un snapshot si ya no lo tiene)
+        self.last_sequence = None
+        self.snapshot_pending = 0
+        # resync_pending: se detectó un hueco y se pidió "SUSCRIBIR:<N>";
+        # los eventos que lleguen antes de la respuesta ya vienen en ella
+        self.resync_pending = False
+        
+    def connect_to_server(self):
+        """
+        Intenta conectarse al servidor C++ en localhost:8080.
+        
+        ¿Qué hace?
+        1. Crea un socket TCP/IP
+        2. Intenta conectar a 127.0.0.1 (localhost) puerto 8080
+        3. Si falla, lanza una excepción
+        
+        NOTA: El servidor actual solo acepta un cliente a la vez.
+        Por eso el visualizador funciona en modo local.
+        """
+        
+        # CREAR SOCKET
+        # ------------
+        # AF_INET = Familia de direcciones IPv4
+        # SOCK_STREAM = Tipo TCP (conexión confiable y ordenada)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        
+        # CONECTAR AL SERVIDOR
+        # --------------------
+        # 'localhost' o '127.0.0.1' = Esta misma computadora
+        # 8080 = Puerto donde el servidor está escuchando
+        # Si el servidor no está corriendo, esto lanzará una excepción
+        self.sock.connect(('localhost', 8080))
+        
+        # PEDIR EL ESTADO INICIAL Y LOS EVENTOS NUMERADOS
+        # -----------------------------------------------
+        self.resync_pending = False
+        if self.last_sequence is None:
+            self.sock.sendall(b"SUSCRIBIR\n")
+        else:
+            self.sock.sendall(f"SUSCRIBIR:{self.last_sequence}\n".encode())
+    
+    def listen_updates(self):
+        """
+        Escucha actualizaciones del servidor en tiempo real.
+        
+        ¿Cómo funciona?
+        1. Intenta conectar al servidor C++
+        2. Si conecta: escucha mensajes en un bucle infinito
+        3. Si NO conecta: imprime mensaje y termina (modo local)
+        
+        Este método se ejecuta en un hilo separado para no bloquear la GUI.
+        """
+        
+        # BLOQUE TRY-EXCEPT PRINCIPAL
+        # ---------------------------
+        # Intenta conectar al servidor, pero si falla, no rompe el programa
+        try:
+            # Intentar conectarse
+            self.connect_to_server()
+            print("✓ Conectado al servidor en puerto 8080")
+        except Exception as e:
+            # MANEJO DE ERROR DE CONEXIÓN
+            # ---------------------------
+            # Si no se puede conectar, el sistema funciona en "modo local"
+            # Esto es útil para desarrollar/probar sin tener el servidor corriendo
+            print(f"⚠ No se pudo conectar al servidor: {e}")
+            print("📝 Modo local: Puedes usar el visualizador sin servidor")
+            print("   Los cambios solo se guardarán en memoria local")
+            return
+        
+        # Si la conexión se pierde se reintenta: el servidor reanuda desde
+        # last_sequence, así no se pierde ningún evento
+        while True:
+            self.receive_messages()
+            self.sock.close()
+            print(f"⚠ Conexion perdida, reintentando en {RECONNECT_DELAY:.0f} s...")
+            while True:
+                time.sleep(RECONNECT_DELAY)
+                try:
+                    self.connect_to_server()
+                    print("✓ Reconectado al servidor")
+                    break
+                except Exception:
+                    self.sock.close()
+    
+    def receive_messages(self):
+        """
+        Procesa los mensajes de la conexión actual hasta que se cierra.
+        """
+        
+        # BUCLE DE ESCUCHA
+        # ----------------
+        # Ciclo infinito que escucha mensajes del servidor
+        pending = ''
+        while True:
+            try:
+                # RECIBIR DATOS
+                # -------------
+                # recv(4096) = "Recibe hasta 4096 bytes de datos"
+                # Este método BLOQUEA hasta que lleguen datos
+                data = self.sock.recv(4096)
+                
+                # VERIFICAR SI EL SERVIDOR CERRÓ LA CONEXIÓN
+                # -------------------------------------------
+                # Si data está vacío, significa que el servidor cerró
+                if not data:
+                    break
+                
+                # DECODIFICAR Y SEPARAR MENSAJES
+                # ------------------------------
+                # Los datos llegan como bytes, los convertimos a texto.
+                # Cada actualización del servidor termina en '\n', pero un
+                # recv puede traer varias juntas (o media): se acumulan en
+                # "pending" y se procesa cada línea completa
+                pending += data.decode('utf-8')
+                while '\n' in pending:
+                    line, pending = pending.split('\n', 1)
+                    message = line.strip()
+                    if not message:
+                        continue
+                    if not message.startswith('SNAPDATA:'):
+                        print(f"📨 Mensaje del servidor: {message}")
+                    
+                    # PARSEAR Y ACTUALIZAR PARKING_MANAGER
+                    # -------------------------------------
+                    self.apply_message(message)
+                
+            except Exception as e:
+                # Si hay error al recibir datos, salir del bucle
+                print(f"Error al recibir: {e}")
+                break
+    
+    def apply_snapshot_header(self, message):
+        """
+        "SNAPSHOT:<secuencia>:<plazas>:<ocupadas>": el estado local se
+        descarta y se reconstruye con las tramas SNAPDATA que siguen.
+        """
+        _, sequence, total, occupied = message.split(':')
+        total = int(total)
+        
+        # Vaciar todas las plazas y ajustar la capacidad
+        for spot_index in range(self.parking_manager.getTotalSpots()):
+            if self.parking_manager.isSpotOccupied(spot_index):
+                self.parking_manager.removeVehicle(self.parking_manager.getPlate(spot_index))
+        if total > self.parking_manager.getTotalSpots():
+            self.parking_manager.grow(total)
+        
+        self.last_sequence = int(sequence)
+        self.snapshot_pending = int(occupied)
+        print(f"📷 Estado completo: {total} plazas, {occupied} ocupadas (secuencia {sequence})")
+    
+    def apply_snapshot_data(self, message):
+        """
+        "SNAPDATA:<base64>": registros de 16 bytes con los vehículos.
+        """
+        raw = base64.b64decode(message[len('SNAPDATA:'):])
+        for offset in range(0, len(raw), SNAPSHOT_RECORD.size):
+            spot_index, code, entry_time = SNAPSHOT_RECORD.unpack_from(raw, offset)
+            self.parking_manager.addVehicle(spot_index, decode_plate(code),
+                                            format_entry_time(entry_time))
+            self.snapshot_pending -= 1
+    
+    def apply_message(self, message):
+        """
+        Aplica al ParkingManager un mensaje recibido del servidor.
+        
+        Mensajes posibles:
+        - "CAPACIDAD:N"                  → el parqueadero se amplió a N plazas
+        - "PLAZA:PLACA[:TIMESTAMP]"      → la plaza está ocupada por PLACA
+        - "PLAZA:SALIDA"                 → la plaza quedó libre
+        - "DELTA:msg|msg|..."            → estado final de varias plazas en
+                                           un tick (--tick-difusion)
+        - "EV:<secuencia>:msg"           → evento numerado (tras SUSCRIBIR)
+        - "EVP:<secuencia>:msg"          → parte de un DELTA cuya última
+                                           trama es "EV:<secuencia>:..."
+        - "SNAPSHOT:..." / "SNAPDATA:..." → estado completo
+        - "REANUDADO:<N>:<actual>"       → siguen los eventos que faltaban
+        
+        Si entre dos "EV" sueltos falta una secuencia, se pide
+        "SUSCRIBIR:<último aplicado>" y se ignoran los eventos hasta la
+        respuesta (REANUDADO o SNAPSHOT).
+        """
+        
+        # SUSCRIPCIÓN: estado completo, reanudación y eventos numerados
+        # -------------------------------------------------------------
+        if message.startswith('SNAPSHOT:'):
+            self.resync_pending = False
+            self.apply_snapshot_header(message)
+            return
+        if message.startswith('SNAPDATA:'):
+            self.apply_snapshot_data(message)
+            return
+        if message.startswith('REANUDADO:'):
+            self.resync_pending = False
+            print(f"🔁 Reanudando desde el evento {message.split(':')[1]}")
+            return
+        if message.startswith(('EV:', 'EVP:')):
+            tag, sequence, event = message.split(':', 2)
+            sequence = int(sequence)
+            if self.resync_pending:
+                return
+            # Un evento ya incluido en el snapshot puede llegar después
+            if self.last_sequence is not None and sequence <= self.last_sequence:
+                return
+            # HUECO: los eventos sueltos llegan con secuencias seguidas (un
+            # DELTA sí cubre las que salta). Si falta alguno se pide desde
+            # el último aplicado, como al reconectar
+            if (tag == 'EV' and not event.startswith('DELTA:')
+                    and self.last_sequence is not None
+                    and sequence != self.last_sequence + 1):
+                print(f"⚠ Faltan los eventos {self.last_sequence + 1}..{sequence - 1}, pidiendo reanudación")
+                self.resync_pending = True
+                self.sock.sendall(f"SUSCRIBIR:{self.last_sequence}\n".encode())
+                return
+            self.apply_message(event)
+            if tag == 'EV':
+                self.last_sequence = sequence
+            return
+        
+        # TRAMA DELTA: varios mensajes separados por '|'
+        # ----------------------------------------------
+        if message.startswith('DELTA:'):
+            for item in message[len('DELTA:'):].split('|'):
+                if item:
+                    self.apply_message(item)
+            return
+        
+        # AMPLIACIÓN DEL PARQUEADERO: "CAPACIDAD:N"
+        # -----------------------------------------
+        # El servidor avisa cuando se amplía en caliente; grow()
+        # conserva los vehículos ya estacionados
+        if message.startswith('CAPACIDAD:'):
+            try:
+                new_capacity = int(message.split(':', 1)[1])
+                if self.parking_manager.grow(new_capacity):
+                    print(f"🏗 Parqueadero ampliado a {new_capacity} plazas")
+            except ValueError:
+                print(f"✗ Capacidad invalida: '{message}'")
+            return
+        
+        # Verificar si el mensaje tiene el formato correcto
+        if ':' not in message:
+            return
+        
+        try:
+            # SEPARAR EL MENSAJE
+            # ------------------
+            # split(':') divide el string en el carácter ':'
+            # Ejemplo: "15:ABC123:2024-11-25 14:30:45".split(':')
+            #          → ["15", "ABC123", "2024-11-25 14", "30", "45"]
+            # Necesitamos unir las últimas 3 partes para el timestamp
+            parts = message.split(':')
+            spot_num = int(parts[0])  # El servidor envía plazas 1-N
+            spot_index = spot_num - 1  # Internamente usamos 0-(N-1)
+            plate = parts[1] if len(parts) > 1 else ""
+            
+            # Reconstruir timestamp (puede tener ':' en HH:MM:SS)
+            timestamp = ':'.join(parts[2:]) if len(parts) > 2 else datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+            
+            # VERIFICAR SI LA PLAZA ESTÁ EN RANGO VÁLIDO
+            # -------------------------------------------
+            if not 0 <= spot_index < self.parking_manager.getTotalSpots():
+                print(f"⚠ Plaza fuera de rango: {spot_num}")
+                return
+            
+            # Cada mensaje dice el estado NUEVO de la plaza, así que aplicarlo
+            # dos veces no cambia nada (los ticks pueden repetir una plaza)
+            current_plate = None
+            if self.parking_manager.isSpotOccupied(spot_index):
+                # getPlate la devuelve siempre en mayúsculas
+                current_plate = self.parking_manager.getPlate(spot_index)
+            
+            # SALIDA: liberar la plaza
+            # ------------------------
+            if plate.upper() == 'SALIDA':
+                if current_plate is not None:
+                    self.parking_manager.removeVehicle(current_plate)
+                    print(f"🚗→ Plaza {spot_num} liberada (era {current_plate})")
+                return
+            
+            # ENTRADA: la plaza queda con esta placa
+            # ---------------------------------------
+            if current_plate == plate.upper():
+                return
+            if current_plate is not None:
+                self.parking_manager.removeVehicle(current_plate)
+            # Si el vehículo figuraba en otra plaza, se movió
+            if self.parking_manager.findPlate(plate) != -1:
+                self.parking_manager.removeVehicle(plate)
+            self.parking_manager.addVehicle(spot_index, plate, timestamp)
+            if current_plate is not None:
+                print(f"🔄 Plaza {spot_num} cambió: {current_plate} → {plate}")
+            else:
+                print(f"🚗← Plaza {spot_num} ocupada con {plate}")
+            
+        except Exception as e:
+            print(f"✗ Error al parsear mensaje '{message}': {e}")
+    
+    def get_parking_state(self):
+        """
+        Obtiene el estado completo del parqueadero desde la librería SWIG.
+        
+        Retorna un diccionario con:
+        - total_spots: Número total de plazas (40 por defecto)
+        - occupied_count: Cuántas plazas están ocupadas
+        - free_count: Cuántas plazas están libres
+        - vehicles: Lista de vehículos estacionados con su plaza y placa
+        
+        Este método es llamado por el visualizador cada vez que necesita
+        actualizar la pantalla.
+        """
+        
+        # OBTENER ESTADÍSTICAS GENERALES
+        # --------------------------------
+        # Estas funciones llaman directamente a los métodos de C++
+        # gracias a SWIG que genera automáticamente los "wrappers"
+        total_spots = self.parking_manager.getTotalSpots()        # 40 por defecto
+        occupied_count = self.parking_manager.getOccupiedCount()  # Cuenta ocupadas
+        free_count = self.parking_manager.getFreeCount()          # Cuenta vacías
+        
+        # CREAR DICCIONARIO DE ESTADO
+        # ---------------------------
+        # Usamos un diccionario (dict) para organizar la información
+        # Es más fácil de usar que devolver 4 valores separados
+        parking_state = {
+            'total_spots': total_spots,
+            'occupied_count': occupied_count,
+            'free_count': free_count,
+            'vehicles': []  # Lista vacía que llenaremos a continuación
+        }
+        
+        # OBTENER INFORMACIÓN DE CADA VEHÍCULO
+        # -----------------------------------
+        # Iteramos por todas las plazas (0 a 39)
+        for spot_index in range(total_spots):
+            # Preguntar si esta plaza está ocupada
+            # (llama al método C++ isSpotOccupied)
+            if self.parking_manager.isSpotOccupied(spot_index):
+                # Si está ocupada, obtener la placa
+                # (llama al método C++ getPlate)
+                plate = self.parking_manager.getPlate(spot_index)
+                
+                # Agregar este vehículo a la lista
+                parking_state['vehicles'].append({
+                    'spot_index': spot_index,  # Índice de la plaza (0-39)
+                    'plate': plate              # Placa del vehículo (ej: "ABC123")
+                })
+        
+        # RETORNAR DICCIONARIO COMPLETO
+        # -----------------------------
+        # El visualizador usará este diccionario para actualizar la GUI
         return parking_state
\ No newline at end of file
@@ -1,64 +1,383 @@
-#include "parking_lib.h"
-#include <cstring>
-
-ParkingManager::ParkingManager() {
-    for (int i = 0; i < 40; ++i) {
-        spots[i].occupied = false;
-        spots[i].plate[0] = '\0';
-        spots[i].timestamp[0] = '\0';
-    }
-}
-
-int ParkingManager::getTotalSpots() const {
-    return 40;
-}
-
-bool ParkingManager::isSpotOccupied(int spotIndex) const {
-    if (spotIndex < 0 || spotIndex >= 40) return false;
-    return spots[spotIndex].occupied;
-}
-
-const char* ParkingManager::getPlate(int spotIndex) const {
-    if (spotIndex < 0 || spotIndex >= 40 || !spots[spotIndex].occupied) return "";
-    return spots[spotIndex].plate;
-}
-
-bool ParkingManager::addVehicle(int spotIndex, const char* plate, const char* timestamp) {
-    if (spotIndex < 0 || spotIndex >= 40 || spots[spotIndex].occupied) return false;
-    
-    strncpy(spots[spotIndex].plate, plate, 9);
-    spots[spotIndex].plate[9] = '\0';
-    strncpy(spots[spotIndex].timestamp, timestamp, 29);
-    spots[spotIndex].timestamp[29] = '\0';
-    spots[spotIndex].occupied = true;
-    return true;
-}
-
-int ParkingManager::removeVehicle(const char* plate) {
-    int spotIndex = findPlate(plate);
-    if (spotIndex == -1) return -1;
-    
-    spots[spotIndex].occupied = false;
-    spots[spotIndex].plate[0] = '\0';
-    spots[spotIndex].timestamp[0] = '\0';
-    return spotIndex;
-}
-
-int ParkingManager::findPlate(const char* plate) const {
-    for (int i = 0; i < 40; ++i) {
-        if (spots[i].occupied && strcmp(spots[i].plate, plate) == 0) return i;
-    }
-    return -1;
-}
-
-int ParkingManager::getOccupiedCount() const {
-    int count = 0;
-    for (int i = 0; i < 40; ++i) {
-        if (spots[i].occupied) count++;
-    }
-    return count;
-}
-
-int ParkingManager::getFreeCount() const {
-    return 40 - getOccupiedCount();
+#include "parking_lib.h"
+#include "plate_codec.h"
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static inline int popcount64(unsigned long long x) { return (int)__popcnt64(x); }
+static inline int ctz64(unsigned long long x) {
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int)index;
+}
+#else
+static inline int popcount64(unsigned long long x) { return __builtin_popcountll(x); }
+static inline int ctz64(unsigned long long x) { return __builtin_ctzll(x); }
+#endif
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+static inline int wordsFor(int spots) {
+    return (spots + 63) / 64;
+}
+
+// Código de una plaza libre / posición vacía del índice
+static const unsigned int NO_PLATE = PLATE_INVALID;
+
+// Días desde 1970-01-01 de una fecha del calendario gregoriano
+// (algoritmo "days_from_civil" de H. Hinnant)
+static long long daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = (int)(y - era * 400);
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civilFromDays(long long z, int& y, int& m, int& d) {
+    z += 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = (int)(z - era * 146097);
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = (int)(yoe + era * 400) + (m <= 2);
+}
+
+// Lee n dígitos; retorna -1 si alguno no lo es
+static int readDigits(const char* text, int n) {
+    int value = 0;
+    for (int i = 0; i < n; ++i) {
+        unsigned int digit = (unsigned int)(text[i] - '0');
+        if (digit >= 10) return -1;
+        value = value * 10 + (int)digit;
+    }
+    return value;
+}
+
+long long ParkingManager::parseTimestamp(const char* text) {
+    if (text == nullptr || strlen(text) != 19) return 0;
+    if (text[4] != '-' || text[7] != '-' || text[10] != ' ' || text[13] != ':' || text[16] != ':') return 0;
+    int year = readDigits(text, 4), month = readDigits(text + 5, 2), day = readDigits(text + 8, 2);
+    int hour = readDigits(text + 11, 2), minute = readDigits(text + 14, 2), second = readDigits(text + 17, 2);
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) return 0;
+    return daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+void ParkingManager::formatTimestamp(long long seconds, char* text) {
+    int year, month, day;
+    civilFromDays(seconds / 86400, year, month, day);
+    int daySeconds = (int)(seconds % 86400);
+    int fields[6] = { year, month, day, daySeconds / 3600, daySeconds / 60 % 60, daySeconds % 60 };
+    const int widths[6] = { 4, 2, 2, 2, 2, 2 };
+    const char separators[6] = { '-', '-', ' ', ':', ':', '\0' };
+    char* out = text;
+    for (int f = 0; f < 6; ++f) {
+        for (int i = widths[f] - 1; i >= 0; --i) {
+            out[i] = (char)('0' + fields[f] % 10);
+            fields[f] /= 10;
+        }
+        out += widths[f];
+        *out++ = separators[f];
+    }
+}
+
+// Hash multiplicativo de Fibonacci: reparte bien claves consecutivas
+unsigned int PlateIndex::slotOf(unsigned int key) const {
+    return (key * 2654435769u) >> (32 - bits);
+}
+
+PlateIndex::PlateIndex(int minEntries)
+    : keys(nullptr), spots(nullptr), bits(0), count(0), allocationCount(0) {
+    reserve(minEntries);
+}
+
+PlateIndex::~PlateIndex() {
+    delete[] keys;
+    delete[] spots;
+}
+
+// Reconstruye la tabla con espacio para al menos minEntries placas
+void PlateIndex::reserve(int minEntries) {
+    int newBits = 4;
+    while ((1 << newBits) < 2 * minEntries) newBits++;
+    if (newBits <= bits) return;
+
+    unsigned int* oldKeys = keys;
+    int* oldSpots = spots;
+    int oldSize = (oldKeys != nullptr) ? (1 << bits) : 0;
+
+    bits = newBits;
+    keys = new unsigned int[1 << bits];
+    spots = new int[1 << bits];
+    allocationCount += 2;
+    for (int i = 0; i < (1 << bits); ++i) {
+        keys[i] = NO_PLATE;
+        spots[i] = -1;
+    }
+
+    count = 0;
+    for (int i = 0; i < oldSize; ++i) {
+        if (oldKeys[i] != NO_PLATE) insert(oldKeys[i], oldSpots[i]);
+    }
+    delete[] oldKeys;
+    delete[] oldSpots;
+}
+
+int PlateIndex::find(unsigned int key) const {
+    if (key == NO_PLATE) return -1;
+    const unsigned int mask = (1u << bits) - 1;
+    for (unsigned int slot = slotOf(key); ; slot = (slot + 1) & mask) {
+        if (keys[slot] == key) return spots[slot];
+        if (keys[slot] == NO_PLATE) return -1;
+    }
+}
+
+void PlateIndex::insert(unsigned int key, int spotIndex) {
+    if (2 * (count + 1) > (1 << bits)) reserve(2 * (count + 1));
+
+    const unsigned int mask = (1u << bits) - 1;
+    unsigned int slot = slotOf(key);
+    while (keys[slot] != NO_PLATE) {
+        slot = (slot + 1) & mask;
+    }
+    keys[slot] = key;
+    spots[slot] = spotIndex;
+    count++;
+}
+
+// Borrado con desplazamiento hacia atrás: no deja lápidas, así las
+// búsquedas no se degradan con el tiempo
+void PlateIndex::erase(unsigned int key) {
+    if (key == NO_PLATE) return;
+    const unsigned int mask = (1u << bits) - 1;
+    unsigned int slot = slotOf(key);
+    while (keys[slot] != key) {
+        if (keys[slot] == NO_PLATE) return;
+        slot = (slot + 1) & mask;
+    }
+
+    unsigned int hole = slot;
+    for (unsigned int next = (hole + 1) & mask; keys[next] != NO_PLATE; next = (next + 1) & mask) {
+        unsigned int home = slotOf(keys[next]);
+        // Mover la entrada al hueco si su posición ideal no queda entre
+        // el hueco y su posición actual
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            keys[hole] = keys[next];
+            spots[hole] = spots[next];
+            hole = next;
+        }
+    }
+    keys[hole] = NO_PLATE;
+    spots[hole] = -1;
+    count--;
+}
+
+int PlateIndex::size() const {
+    return count;
+}
+
+int PlateIndex::getAllocationCount() const {
+    return allocationCount;
+}
+
+ParkingManager::ParkingManager(int capacity)
+    : capacity(0), occupiedCount(0), plateCodes(nullptr), occupancy(nullptr), occupancyWords(0),
+      entryTimes(nullptr), index(capacity < 1 ? DEFAULT_CAPACITY : capacity), allocationCount(0) {
+    if (capacity < 1) capacity = DEFAULT_CAPACITY;
+    this->capacity = capacity;
+    plateCodes = new unsigned int[capacity];
+    entryTimes = new long long[capacity]();
+    for (int i = 0; i < capacity; ++i) {
+        plateCodes[i] = NO_PLATE;
+    }
+    occupancyWords = wordsFor(capacity);
+    occupancy = new unsigned long long[occupancyWords]();
+    allocationCount += 3;
+    plateText[0] = '\0';
+    timeText[0] = '\0';
+}
+
+ParkingManager::~ParkingManager() {
+    delete[] plateCodes;
+    delete[] entryTimes;
+    delete[] occupancy;
+}
+
+int ParkingManager::getTotalSpots() const {
+    return capacity;
+}
+
+bool ParkingManager::grow(int newCapacity) {
+    if (newCapacity <= capacity) return false;
+
+    unsigned int* newCodes = new unsigned int[newCapacity];
+    memcpy(newCodes, plateCodes, sizeof(unsigned int) * capacity);
+    for (int i = capacity; i < newCapacity; ++i) {
+        newCodes[i] = NO_PLATE;
+    }
+    delete[] plateCodes;
+    plateCodes = newCodes;
+
+    long long* newTimes = new long long[newCapacity]();
+    allocationCount += 2;
+    memcpy(newTimes, entryTimes, sizeof(long long) * capacity);
+    delete[] entryTimes;
+    entryTimes = newTimes;
+
+    int newWords = wordsFor(newCapacity);
+    if (newWords > occupancyWords) {
+        unsigned long long* newOccupancy = new unsigned long long[newWords]();
+        allocationCount++;
+        memcpy(newOccupancy, occupancy, sizeof(unsigned long long) * occupancyWords);
+        delete[] occupancy;
+        occupancy = newOccupancy;
+        occupancyWords = newWords;
+    }
+    capacity = newCapacity;
+
+    // Las plazas existentes conservan su índice: solo hace falta
+    // reconstruir la tabla hash si quedó pequeña
+    index.reserve(newCapacity);
+    return true;
+}
+
+bool ParkingManager::isSpotOccupied(int spotIndex) const {
+    if (spotIndex < 0 || spotIndex >= capacity) return false;
+    return (occupancy[spotIndex >> 6] >> (spotIndex & 63)) & 1;
+}
+
+const char* ParkingManager::getPlate(int spotIndex) const {
+    if (!isSpotOccupied(spotIndex)) return "";
+    decodePlate(plateCodes[spotIndex], plateText);
+    return plateText;
+}
+
+const char* ParkingManager::getTimestamp(int spotIndex) const {
+    if (!isSpotOccupied(spotIndex) || entryTimes[spotIndex] == 0) return "";
+    formatTimestamp(entryTimes[spotIndex], timeText);
+    return timeText;
+}
+
+bool ParkingManager::addVehicle(int spotIndex, const char* plate, const char* timestamp) {
+    if (spotIndex < 0 || spotIndex >= capacity || isSpotOccupied(spotIndex)) return false;
+
+    unsigned int key = encodePlate(plate);
+    if (key == NO_PLATE || index.find(key) != -1) return false;
+
+    plateCodes[spotIndex] = key;
+    entryTimes[spotIndex] = parseTimestamp(timestamp);
+    index.insert(key, spotIndex);
+    occupancy[spotIndex >> 6] |= 1ULL << (spotIndex & 63);
+    occupiedCount++;
+    return true;
+}
+
+int ParkingManager::removeVehicle(const char* plate) {
+    int spotIndex = findPlate(plate);
+    if (spotIndex == -1) return -1;
+
+    index.erase(plateCodes[spotIndex]);
+    plateCodes[spotIndex] = NO_PLATE;
+    entryTimes[spotIndex] = 0;
+    occupancy[spotIndex >> 6] &= ~(1ULL << (spotIndex & 63));
+    occupiedCount--;
+    return spotIndex;
+}
+
+int ParkingManager::findPlate(const char* plate) const {
+    return index.find(encodePlate(plate));
+}
+
+int ParkingManager::getOccupiedCount() const {
+    return occupiedCount;
+}
+
+int ParkingManager::getAllocationCount() const {
+    return allocationCount + index.getAllocationCount();
+}
+
+int ParkingManager::getFreeCount() const {
+    return capacity - getOccupiedCount();
+}
+
+int ParkingManager::countOccupied(int first, int last) const {
+    if (first < 0) first = 0;
+    if (last > capacity) last = capacity;
+    if (first >= last) return 0;
+
+    int firstWord = first >> 6;
+    int lastWord = (last - 1) >> 6;
+    unsigned long long firstMask = ~0ULL << (first & 63);
+    unsigned long long lastMask = ~0ULL >> (63 - ((last - 1) & 63));
+
+    if (firstWord == lastWord) {
+        return popcount64(occupancy[firstWord] & firstMask & lastMask);
+    }
+    int count = popcount64(occupancy[firstWord] & firstMask);
+    for (int w = firstWord + 1; w < lastWord; ++w) {
+        count += popcount64(occupancy[w]);
+    }
+    return count + popcount64(occupancy[lastWord] & lastMask);
+}
+
+int ParkingManager::findFirstFree() const {
+    return findNextFree(0);
+}
+
+int ParkingManager::findNextFree(int from) const {
+    if (from < 0) from = 0;
+    if (from >= capacity) return -1;
+
+    int word = from >> 6;
+    // Las plazas anteriores a "from" se tratan como ocupadas
+    unsigned long long freeBits = ~occupancy[word] & (~0ULL << (from & 63));
+    while (freeBits == 0) {
+        if (++word >= occupancyWords) return -1;
+#ifdef __AVX2__
+        // Saltar de a 256 plazas mientras el bloque esté completamente lleno
+        const __m256i full = _mm256_set1_epi64x(-1);
+        while (word + 4 <= occupancyWords) {
+            __m256i block = _mm256_loadu_si256((const __m256i*)(occupancy + word));
+            if (!_mm256_testc_si256(block, full)) break;
+            word += 4;
+        }
+        if (word >= occupancyWords) return -1;
+#endif
+        freeBits = ~occupancy[word];
+    }
+
+    // Los bits de la última palabra por encima de capacity están a 0, así
+    // que pueden aparecer como libres: se descartan aquí
+    int spot = (word << 6) + ctz64(freeBits);
+    return spot < capacity ? spot : -1;
+}
+
+int ParkingManager::findNextOccupied(int from) const {
+    if (from < 0) from = 0;
+    if (from >= capacity) return -1;
+
+    int word = from >> 6;
+    unsigned long long bits = occupancy[word] & (~0ULL << (from & 63));
+    while (bits == 0) {
+        if (++word >= occupancyWords) return -1;
+        bits = occupancy[word];
+    }
+    return (word << 6) + ctz64(bits);
+}
+
+unsigned int ParkingManager::getPlateCode(int spotIndex) const {
+    if (spotIndex < 0 || spotIndex >= capacity) return NO_PLATE;
+    return plateCodes[spotIndex];
+}
+
+long long ParkingManager::getEntryTime(int spotIndex) const {
+    if (spotIndex < 0 || spotIndex >= capacity) return 0;
+    return entryTimes[spotIndex];
 }
\ No newline at end of file
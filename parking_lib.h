@@ -1,26 +1,117 @@
-#ifndef PARKING_LIB_H
-#define PARKING_LIB_H
-
-struct VehicleInfo {
-    char plate[10];
-    char timestamp[30];
-    bool occupied;
-};
-
-class ParkingManager {
-private:
-    VehicleInfo spots[40];
-    
-public:
-    ParkingManager();
-    int getTotalSpots() const;
-    bool isSpotOccupied(int spotIndex) const;
-    const char* getPlate(int spotIndex) const;
-    bool addVehicle(int spotIndex, const char* plate, const char* timestamp);
-    int removeVehicle(const char* plate);
-    int findPlate(const char* plate) const;
-    int getOccupiedCount() const;
-    int getFreeCount() const;
-};
-
+#ifndef PARKING_LIB_H
+#define PARKING_LIB_H
+
+// Capacidad por defecto (el parqueadero original)
+#define DEFAULT_CAPACITY 40
+
+// Índice hash placa -> plaza con direccionamiento abierto (sondeo lineal).
+// La clave es el código de placa (plate_codec.h). La tabla mide una
+// potencia de dos de al menos el doble de las entradas pedidas a reserve(),
+// así que buscar, insertar y borrar no reservan memoria mientras no se
+// supere esa cantidad
+class PlateIndex {
+private:
+    unsigned int* keys;
+    int* spots;
+    int bits;
+    int count;
+    int allocationCount;
+
+    unsigned int slotOf(unsigned int key) const;
+
+public:
+    explicit PlateIndex(int minEntries = 8);
+    ~PlateIndex();
+    PlateIndex(const PlateIndex&) = delete;
+    PlateIndex& operator=(const PlateIndex&) = delete;
+
+    // Amplía la tabla para al menos minEntries placas (nunca la reduce)
+    void reserve(int minEntries);
+    // Plaza de la placa, o -1 si no está
+    int find(unsigned int key) const;
+    // La placa no debe estar ya en el índice. Si se supera la mitad de
+    // la tabla, esta se duplica
+    void insert(unsigned int key, int spotIndex);
+    void erase(unsigned int key);
+    int size() const;
+    int getAllocationCount() const;
+};
+
+// Plazas en columnas separadas (estructura de arreglos) en lugar de un
+// arreglo de registros { char plate[10]; char timestamp[30]; bool occupied; }
+// de 41 bytes. Las búsquedas y conteos solo recorren columnas pequeñas; las
+// placas y horas se convierten a texto únicamente al salir por la API
+class ParkingManager {
+private:
+    int capacity;
+    int occupiedCount;    // Contador al día: getOccupiedCount() no recorre las plazas
+
+    // Datos calientes (4 bytes + 1 bit por plaza)
+    // Placa AAA000 codificada con plate_codec, 0xFFFFFFFF si la plaza está libre
+    unsigned int* plateCodes;
+    // Mapa de ocupación: bit i = plaza i ocupada. Las búsquedas de plazas
+    // libres leen 64 plazas por palabra
+    unsigned long long* occupancy;
+    int occupancyWords;
+
+    // Datos fríos: hora de entrada en segundos desde 1970-01-01 00:00:00
+    // (hora civil, sin zona horaria). 0 = sin hora
+    long long* entryTimes;
+
+    // Texto devuelto por getPlate/getTimestamp (válido hasta la siguiente llamada)
+    mutable char plateText[8];    // PLATE_RECORD_SIZE (ver plate_codec.h)
+    mutable char timeText[20];
+
+    // Índice placa -> plaza, con espacio para todas las plazas
+    PlateIndex index;
+
+    // Reservas de memoria hechas desde la construcción. Solo el constructor,
+    // grow() y el redimensionado del índice reservan: entradas y salidas no
+    int allocationCount;
+
+public:
+    ParkingManager(int capacity = DEFAULT_CAPACITY);
+    ~ParkingManager();
+    ParkingManager(const ParkingManager&) = delete;
+    ParkingManager& operator=(const ParkingManager&) = delete;
+
+    int getTotalSpots() const;
+    // Amplía el parqueadero sin perder los vehículos estacionados.
+    // No se puede reducir: retorna false si newCapacity <= capacidad actual
+    bool grow(int newCapacity);
+    bool isSpotOccupied(int spotIndex) const;
+    // Placa en mayúsculas ("" si la plaza está libre)
+    const char* getPlate(int spotIndex) const;
+    // "YYYY-MM-DD HH:MM:SS", o "" si está libre o se registró sin hora
+    const char* getTimestamp(int spotIndex) const;
+    // Falla si la plaza está ocupada, si la placa no tiene el formato AAA000
+    // o si ese vehículo ya está estacionado en otra plaza. Un timestamp que
+    // no tenga el formato "YYYY-MM-DD HH:MM:SS" se guarda como "sin hora"
+    bool addVehicle(int spotIndex, const char* plate, const char* timestamp);
+    int removeVehicle(const char* plate);
+    // O(1): consulta el índice hash, no recorre las plazas
+    int findPlate(const char* plate) const;
+    int getOccupiedCount() const;
+    int getAllocationCount() const;
+    int getFreeCount() const;
+    // Plazas ocupadas en el rango [first, last), p. ej. un piso del edificio
+    int countOccupied(int first, int last) const;
+    // Primera plaza libre (desde la 0 o desde "from"), o -1 si no hay
+    int findFirstFree() const;
+    int findNextFree(int from) const;
+    // Primera plaza ocupada desde "from" (incluida), o -1 si no hay
+    int findNextOccupied(int from) const;
+    // Datos crudos, p. ej. para un snapshot binario: código de placa
+    // (plate_codec.h, 0xFFFFFFFF si está libre) y hora de entrada en
+    // segundos desde 1970-01-01 00:00:00 (0 = sin hora)
+    unsigned int getPlateCode(int spotIndex) const;
+    long long getEntryTime(int spotIndex) const;
+
+    // "YYYY-MM-DD HH:MM:SS" <-> segundos desde 1970. parseTimestamp
+    // retorna 0 (sin hora) si el texto no tiene ese formato; text de
+    // formatTimestamp debe tener espacio para 20 bytes
+    static long long parseTimestamp(const char* text);
+    static void formatTimestamp(long long seconds, char* text);
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,1036 @@
+// ============================================================================
+// ARCHIVO: parking_protocol.cpp
+// PROPÓSITO: Implementación del protocolo "PLAZA:PLACA:TIMESTAMP"
+// DESCRIPCIÓN: Extraído de handleClient para que todos los motores del
+//              servidor (hilos, epoll) respondan exactamente igual
+// ============================================================================
+
+#include "parking_protocol.h"
+#include "async_log.h"
+#include "state_actor.h"
+#include "wal.h"
+#include <string.h>    // Para strchr, strcmp, strncmp, memset, strlen
+#include <stdlib.h>    // Para atoi, atoll
+#include <stdio.h>     // Para snprintf
+
+using namespace std;
+
+// ============================================================================
+// VARIABLES GLOBALES COMPARTIDAS
+// ============================================================================
+
+atomic<int> numSpots(0);
+
+// ZONA: plazas [first, first + parking->getTotalSpots()) con índices
+// locales en parking. Alineada a 64 bytes para que los mutex de zonas
+// vecinas no compartan línea de caché
+struct alignas(64) ParkingZone {
+	mutex lock;
+	ParkingManager* parking = nullptr;
+	int first = 0;
+	// Plazas cambiadas desde el último collectDelta, un bit por plaza local
+	vector<unsigned long long> dirty;
+};
+
+// FRANJA del índice global: placas cuyo hash cae en ella -> plaza
+struct alignas(64) PlateStripe {
+	mutex lock;
+	PlateIndex index;
+};
+
+// Una zona tiene al menos una palabra de bits de plazas: con zonas más
+// pequeñas habría más locks que tomar en cada snapshot que contención que
+// evitar
+static const int MIN_ZONE_SPOTS = 64;
+
+// Todas las zonas miden zoneSize plazas salvo la última. El arreglo de
+// zonas se dimensiona al arrancar para MAX_SPOTS y no se redimensiona:
+// una zona nueva se guarda antes de publicar numSpots
+static int zoneSize = 1;
+static vector<ParkingZone*> zones;
+static PlateStripe* stripes = nullptr;
+
+// Protege la creación de zonas y el crecimiento de la última
+static mutex growthMutex;
+
+// Contadores para ESTADO sin tomar ninguna zona
+static atomic<int> occupiedTotal(0);
+static atomic<int> allocationTotal(0);
+
+// Número de secuencia del último evento y anillo con los más recientes:
+// el evento s está en history[s % history.size()]. También capacityDirty
+// (protegidos por historyMutex)
+static mutex historyMutex;
+static unsigned long long eventSequence = 0;
+static vector<ParkingUpdate> history;
+
+// Eventos numerados pendientes de publicar (con historyMutex) y el
+// publicador del motor (se cambia con los dos locks tomados)
+static mutex publishMutex;
+static EventPublisher eventPublisher = nullptr;
+static void* publisherContext = nullptr;
+static vector<ParkingUpdate> unpublished;
+static bool capacityDirty = false;
+
+static ParkingZone& zoneOf(int spotIndex)
+{
+	return *zones[(size_t)(spotIndex / zoneSize)];
+}
+
+// Hash de Fibonacci: placas consecutivas caen en franjas distintas
+static PlateStripe& stripeOf(unsigned int plateCode)
+{
+	return stripes[(plateCode * 2654435769u) >> (32 - PLATE_STRIPE_BITS)];
+}
+
+int parkingZoneCount()
+{
+	return (numSpots.load(memory_order_acquire) + zoneSize - 1) / zoneSize;
+}
+
+static void markDirty(ParkingZone& zone, int spotIndex)
+{
+	int local = spotIndex - zone.first;
+	zone.dirty[(size_t)local >> 6] |= 1ULL << (local & 63);
+}
+
+// Entradas que se reservan por franja: con las placas repartidas por el
+// hash, una franja casi nunca supera el doble de la media
+static int stripeEntries(int spots)
+{
+	return spots / PLATE_STRIPES * 2 + 8;
+}
+
+// Bloquea todas las zonas existentes (con growthMutex tomado, así que no
+// aparecen zonas nuevas mientras tanto)
+class AllZonesLock {
+public:
+	AllZonesLock() : count(parkingZoneCount())
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			zones[(size_t)i]->lock.lock();
+		}
+	}
+
+	~AllZonesLock()
+	{
+		for (int i = count - 1; i >= 0; --i)
+		{
+			zones[(size_t)i]->lock.unlock();
+		}
+	}
+
+	int size() const { return count; }
+
+private:
+	int count;
+};
+
+// ============================================================================
+// FUNCIÓN: initParkingState / freeParkingState
+// ============================================================================
+static void addZone(int first, int spots)
+{
+	ParkingZone* zone = new ParkingZone();
+	zone->parking = new ParkingManager(spots);
+	zone->first = first;
+	zone->dirty.assign(((size_t)spots + 63) / 64, 0);
+	allocationTotal += zone->parking->getAllocationCount();
+	zones[(size_t)(first / zoneSize)] = zone;
+}
+
+void initParkingState(int spots, int historySize, int zoneTotal)
+{
+	if (zoneTotal < 1)
+	{
+		zoneTotal = 1;
+	}
+	zoneSize = (spots + zoneTotal - 1) / zoneTotal;
+	if (zoneSize < MIN_ZONE_SPOTS)
+	{
+		zoneSize = MIN_ZONE_SPOTS;
+	}
+
+	int maxSpots = spots > MAX_SPOTS ? spots : MAX_SPOTS;
+	zones.assign((size_t)((maxSpots + zoneSize - 1) / zoneSize), nullptr);
+	occupiedTotal = 0;
+	allocationTotal = 0;
+	for (int first = 0; first < spots; first += zoneSize)
+	{
+		addZone(first, spots - first < zoneSize ? spots - first : zoneSize);
+	}
+
+	stripes = new PlateStripe[PLATE_STRIPES];
+	for (int i = 0; i < PLATE_STRIPES; ++i)
+	{
+		stripes[i].index.reserve(stripeEntries(spots));
+		allocationTotal += stripes[i].index.getAllocationCount();
+	}
+
+	numSpots = spots;
+	history.assign(historySize > 0 ? (size_t)historySize : 0, ParkingUpdate());
+	eventSequence = 0;
+	capacityDirty = false;
+}
+
+void freeParkingState()
+{
+	for (ParkingZone* zone : zones)
+	{
+		if (zone != nullptr)
+		{
+			delete zone->parking;
+			delete zone;
+		}
+	}
+	zones.clear();
+	delete[] stripes;
+	stripes = nullptr;
+	history.clear();
+	numSpots = 0;
+}
+
+// Numeración de eventos (definidas más abajo, con applyRequest)
+static ParkingUpdate& addUpdate(vector<ParkingUpdate>& updates, int spot);
+static void setUpdateLength(ParkingUpdate& update, int written);
+static void recordEvent(ParkingUpdate& update, unsigned int plateCode, unsigned long long origin);
+
+// ============================================================================
+// FUNCIÓN: growParkingState
+// ============================================================================
+bool growParkingState(int newSpots, vector<ParkingUpdate>& updates, unsigned long long origin)
+{
+	lock_guard<mutex> growth(growthMutex);
+
+	int current = numSpots.load(memory_order_relaxed);
+	if (newSpots <= current)
+	{
+		return false;
+	}
+
+	// Completar la última zona (la única que puede no estar llena)
+	ParkingZone& last = zoneOf(current - 1);
+	int lastSpots = newSpots - last.first < zoneSize ? newSpots - last.first : zoneSize;
+	if (lastSpots > last.parking->getTotalSpots())
+	{
+		lock_guard<mutex> lock(last.lock);
+		int before = last.parking->getAllocationCount();
+		last.parking->grow(lastSpots);
+		last.dirty.resize(((size_t)lastSpots + 63) / 64, 0);
+		allocationTotal += last.parking->getAllocationCount() - before;
+	}
+
+	// Zonas nuevas: nadie las ve hasta publicar numSpots
+	for (int first = last.first + zoneSize; first < newSpots; first += zoneSize)
+	{
+		addZone(first, newSpots - first < zoneSize ? newSpots - first : zoneSize);
+	}
+
+	// El índice de placas crece ahora, no en una entrada
+	for (int i = 0; i < PLATE_STRIPES; ++i)
+	{
+		lock_guard<mutex> lock(stripes[i].lock);
+		int before = stripes[i].index.getAllocationCount();
+		stripes[i].index.reserve(stripeEntries(newSpots));
+		allocationTotal += stripes[i].index.getAllocationCount() - before;
+	}
+
+	{
+		lock_guard<mutex> lock(historyMutex);
+		capacityDirty = true;
+	}
+
+	// El CAPACIDAD se numera antes de que nadie pueda validar una plaza
+	// nueva: en el WAL y en los EV la ampliación va antes que sus entradas
+	ParkingUpdate& update = addUpdate(updates, -1);
+	update.plateCode = (unsigned int)newSpots;
+	setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "CAPACIDAD:%d", newSpots));
+	recordEvent(update, PLATE_INVALID, origin);
+
+	// Publicar la nueva capacidad después de que las plazas ya existen
+	numSpots.store(newSpots, memory_order_release);
+	return true;
+}
+
+// ============================================================================
+// FUNCIÓN: parseRequest
+// ============================================================================
+static void resetRequest(ParkingRequest& request)
+{
+	request.type = REQUEST_PARKING;
+	request.spotIndex = -1;
+	memset(request.plate, 0, sizeof(request.plate));
+	request.plateCode = PLATE_INVALID;
+	request.timestamp[0] = '\0';
+	request.newSpots = 0;
+	request.resumeFrom = -1;
+	request.binaryOp = 0;
+	request.error = nullptr;
+}
+
+static void parseCapacity(int newSpots, ParkingRequest& request)
+{
+	request.type = REQUEST_CAPACITY;
+	if (newSpots < 1 || newSpots > MAX_SPOTS)
+	{
+		request.error = resultText(ERROR_CAPACITY);
+	}
+	else
+	{
+		request.newSpots = newSpots;
+	}
+}
+
+void parseRequest(char* buffer, ParkingRequest& request)
+{
+	resetRequest(request);
+
+	// MENSAJES DE ADMINISTRACIÓN
+	if (strcmp(buffer, "ESTADO") == 0)
+	{
+		request.type = REQUEST_STATUS;
+		return;
+	}
+	if (strcmp(buffer, "SUSCRIBIR") == 0 || strncmp(buffer, "SUSCRIBIR:", 10) == 0)
+	{
+		request.type = REQUEST_SUBSCRIBE;
+		if (buffer[9] == ':')
+		{
+			request.resumeFrom = atoll(buffer + 10);
+		}
+		return;
+	}
+	if (strncmp(buffer, "CAPACIDAD:", 10) == 0)
+	{
+		parseCapacity(atoi(buffer + 10), request);
+		return;
+	}
+
+	// PARSEAR MENSAJE (formato: "PLAZA:PLACA:TIMESTAMP")
+	char* separator1 = strchr(buffer, ':');
+	if (separator1 == nullptr)
+	{
+		request.error = resultText(ERROR_FORMAT);
+		return;
+	}
+
+	*separator1 = '\0';
+	char* rest = separator1 + 1;
+
+	// Buscar el segundo separador (:)
+	char* separator2 = strchr(rest, ':');
+	char* plate = rest;
+
+	if (separator2 != nullptr)
+	{
+		*separator2 = '\0';
+		strncpy(request.timestamp, separator2 + 1, sizeof(request.timestamp) - 1);
+		request.timestamp[sizeof(request.timestamp) - 1] = '\0';
+	}
+
+	request.spotIndex = atoi(buffer) - 1;
+
+	// La placa se valida después, junto con las del resto del lote
+	copyPlateRecord(plate, request.plate);
+}
+
+// ============================================================================
+// FUNCIÓN: parseBinaryRequest
+// ============================================================================
+void parseBinaryRequest(const char* message, ParkingRequest& request)
+{
+	resetRequest(request);
+
+	BinaryMessage binary;
+	decodeBinaryMessage(message, binary);
+	request.binaryOp = binary.op;
+
+	switch (binary.op)
+	{
+	case BIN_OP_HELLO:
+		request.type = REQUEST_HELLO;
+		if (binary.aux != BINARY_PROTOCOL_VERSION)
+		{
+			request.error = resultText(ERROR_VERSION);
+		}
+		return;
+	case BIN_OP_STATUS:
+		request.type = REQUEST_STATUS;
+		return;
+	case BIN_OP_CAPACITY:
+		parseCapacity(binary.spot > (uint32_t)MAX_SPOTS ? 0 : (int)binary.spot, request);
+		return;
+	case BIN_OP_PARK:
+		break;
+	default:
+		request.error = resultText(ERROR_FORMAT);
+		return;
+	}
+
+	// Un número fuera de rango queda en -1 y validateBatch lo rechaza
+	request.spotIndex = (binary.spot >= 1 && binary.spot <= (uint32_t)MAX_SPOTS) ? (int)binary.spot - 1 : -1;
+
+	// La placa pasa a texto para validarla con el resto del lote. Un
+	// código con bits de más deja el registro vacío (placa inválida), y
+	// una letra o un número fuera de rango no vuelven a codificarse
+	if ((binary.plate >> 25) == 0)
+	{
+		decodePlate(binary.plate, request.plate);
+	}
+
+	// Hasta el año 9999, el máximo de "YYYY-MM-DD HH:MM:SS"
+	if (binary.timestamp > 0 && binary.timestamp < 253402300800LL)
+	{
+		ParkingManager::formatTimestamp(binary.timestamp, request.timestamp);
+	}
+}
+
+// Entrada, salida o CAPACIDAD: lo que produce eventos y va al WAL
+static bool changesState(const ParkingRequest& request)
+{
+	return request.type == REQUEST_PARKING || request.type == REQUEST_CAPACITY;
+}
+
+// ============================================================================
+// FUNCIÓN: validateBatch
+// PROPÓSITO: Codifica las placas de todo el lote de una vez (SSE2/AVX2) y
+//            comprueba el rango de cada plaza, FUERA de la sección crítica
+// ============================================================================
+static void validateBatch(ParkingBatch& batch)
+{
+	size_t count = batch.requests.size();
+	batch.plateCodes.resize(count);
+	encodePlates(batch.requests[0].plate, sizeof(ParkingRequest), count, batch.plateCodes.data());
+
+	int total = numSpots.load(memory_order_acquire);
+	batch.validatedSpots = total;
+	bool storageFailed = walFailed();
+	for (size_t i = 0; i < count; ++i)
+	{
+		ParkingRequest& request = batch.requests[i];
+		if (request.error == nullptr && storageFailed && changesState(request))
+		{
+			// El WAL ya no guarda nada: no se aplica lo que no se podría
+			// confirmar (ver ERRORES en wal.h)
+			request.error = resultText(ERROR_STORAGE);
+		}
+		// "CAPACIDAD:60\n55:PLACA" en un mismo recv: la plaza 55 existirá
+		// cuando se aplique la entrada. applyRequest la vuelve a comprobar
+		if (request.error == nullptr && request.type == REQUEST_CAPACITY && request.newSpots > total)
+		{
+			total = request.newSpots;
+		}
+		if (request.error != nullptr || request.type != REQUEST_PARKING)
+		{
+			continue;
+		}
+		request.plateCode = batch.plateCodes[i];
+		if (request.plateCode == PLATE_INVALID)
+		{
+			request.error = resultText(ERROR_PLATE);
+		}
+		else if (request.spotIndex < 0 || request.spotIndex >= total)
+		{
+			request.error = resultText(ERROR_SPOT);
+		}
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: addUpdate
+// PROPÓSITO: Agrega una actualización de tamaño fijo (sin reservar memoria
+//            mientras el vector tenga capacidad)
+// ============================================================================
+static ParkingUpdate& addUpdate(vector<ParkingUpdate>& updates, int spot)
+{
+	updates.emplace_back();
+	updates.back().spot = spot;
+	updates.back().sequence = 0;
+	updates.back().origin = 0;
+	updates.back().plateCode = PLATE_INVALID;
+	updates.back().entryTime = 0;
+	return updates.back();
+}
+
+static void setUpdateLength(ParkingUpdate& update, int written)
+{
+	update.length = (written < 0) ? 0 : ((size_t)written >= MAX_UPDATE ? MAX_UPDATE - 1 : (size_t)written);
+}
+
+// Numera un evento ya aplicado y lo guarda en el historial y en el WAL.
+// Se llama con la zona del evento tomada (CAPACIDAD: con el lock de
+// crecimiento, antes de publicar numSpots), así un snapshot nunca ve la
+// plaza cambiada sin su número de secuencia (ni al revés). plateCode es la
+// placa que entra o sale (la actualización de una salida no la lleva)
+static void recordEvent(ParkingUpdate& update, unsigned int plateCode, unsigned long long origin)
+{
+	lock_guard<mutex> lock(historyMutex);
+	update.sequence = ++eventSequence;
+	update.origin = origin;
+	if (!history.empty())
+	{
+		history[update.sequence % history.size()] = update;
+	}
+	if (eventPublisher != nullptr)
+	{
+		unpublished.push_back(update);
+	}
+
+	WalRecord record;
+	record.sequence = update.sequence;
+	record.kind = (update.spot < 0) ? WAL_CAPACITY : (update.plateCode == PLATE_INVALID ? WAL_EXIT : WAL_ENTRY);
+	record.spot = (update.spot < 0) ? (int)update.plateCode : update.spot;
+	record.plateCode = plateCode;
+	record.entryTime = update.entryTime;
+	walAppend(record);
+}
+
+// ============================================================================
+// FUNCIÓN: applyRequest
+// PROPÓSITO: Aplica una solicitud válida (ENTRADA, SALIDA o administración)
+// DESCRIPCIÓN: Con la franja de la placa tomada, el índice global dice si
+//              el vehículo ya está estacionado: si lo está sale de su plaza
+//              (en la zona que sea), si no entra en la pedida. Otro mensaje
+//              con la misma placa espera a la franja, así que nunca se ve
+//              la placa a medio mover
+// ============================================================================
+static const char* applyRequest(const ParkingRequest& request, ParkingBatch& batch)
+{
+	// La respuesta a SUSCRIBIR la arma el motor (buildSubscription)
+	if (request.type == REQUEST_SUBSCRIBE)
+	{
+		return nullptr;
+	}
+
+	if (request.type == REQUEST_HELLO)
+	{
+		return resultText(RESULT_HELLO);
+	}
+
+	if (request.type == REQUEST_STATUS)
+	{
+		batch.statusValues[0] = (unsigned int)numSpots.load(memory_order_acquire);
+		batch.statusValues[1] = (unsigned int)occupiedTotal.load(memory_order_relaxed);
+		batch.statusValues[2] = (unsigned int)allocationTotal.load(memory_order_relaxed);
+		snprintf(batch.statusText, sizeof(batch.statusText),
+			"OK: Plazas %u | Ocupadas %u | Reservas de memoria %u",
+			batch.statusValues[0], batch.statusValues[1], batch.statusValues[2]);
+		return batch.statusText;
+	}
+
+	if (request.type == REQUEST_CAPACITY)
+	{
+		if (!growParkingState(request.newSpots, batch.updates, batch.origin))
+		{
+			return resultText(ERROR_SHRINK);
+		}
+		return resultText(RESULT_RESIZED);
+	}
+
+	// Plaza que validateBatch aceptó por un CAPACIDAD anterior del mismo
+	// lote: si esa ampliación no llegó a aplicarse, sigue fuera de rango
+	if (request.spotIndex >= batch.validatedSpots && request.spotIndex >= numSpots.load(memory_order_acquire))
+	{
+		return resultText(ERROR_SPOT);
+	}
+
+	const char* plate = request.plate;
+	const char* timestamp = request.timestamp[0] ? request.timestamp : nullptr;
+	int spotIndex = request.spotIndex;
+
+	PlateStripe& stripe = stripeOf(request.plateCode);
+	lock_guard<mutex> plateLock(stripe.lock);
+
+	// SALIDA: si la placa ya está estacionada (en cualquier plaza), liberarla
+	int existingSpot = stripe.index.find(request.plateCode);
+	if (existingSpot != -1)
+	{
+		ParkingZone& zone = zoneOf(existingSpot);
+		{
+			lock_guard<mutex> lock(zone.lock);
+			zone.parking->removeVehicle(plate);
+			occupiedTotal.fetch_sub(1, memory_order_relaxed);
+			markDirty(zone, existingSpot);
+
+			// Mensaje para broadcast a otros clientes
+			ParkingUpdate& update = addUpdate(batch.updates, existingSpot);
+			setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "%d:SALIDA", existingSpot + 1));
+			recordEvent(update, request.plateCode, batch.origin);
+			logExit(existingSpot, plate, timestamp, update.sequence);
+		}
+		stripe.index.erase(request.plateCode);
+		return resultText(RESULT_LEFT);
+	}
+
+	// ENTRADA: ocupar plaza
+	ParkingZone& zone = zoneOf(spotIndex);
+	{
+		lock_guard<mutex> lock(zone.lock);
+		int local = spotIndex - zone.first;
+		if (!zone.parking->addVehicle(local, plate, timestamp))
+		{
+			return resultText(ERROR_OCCUPIED);
+		}
+		occupiedTotal.fetch_add(1, memory_order_relaxed);
+		markDirty(zone, spotIndex);
+
+		// Mensaje para broadcast: "PLAZA:PLACA:TIMESTAMP"
+		ParkingUpdate& update = addUpdate(batch.updates, spotIndex);
+		update.plateCode = request.plateCode;
+		update.entryTime = zone.parking->getEntryTime(local);
+		if (timestamp)
+		{
+			setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "%d:%s:%s", spotIndex + 1, plate, timestamp));
+		}
+		else
+		{
+			setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "%d:%s", spotIndex + 1, plate));
+		}
+		recordEvent(update, request.plateCode, batch.origin);
+		logEntry(spotIndex, plate, timestamp, update.sequence);
+	}
+
+	// El índice solo crece si una franja supera lo reservado
+	int before = stripe.index.getAllocationCount();
+	stripe.index.insert(request.plateCode, spotIndex);
+	allocationTotal += stripe.index.getAllocationCount() - before;
+	return resultText(RESULT_PARKED);
+}
+
+// ============================================================================
+// FUNCIÓN: applyBatch
+// ============================================================================
+// El WAL falló antes de guardar los eventos del lote: ningún cambio se
+// confirma como hecho (en memoria sí quedó, ver ERRORES en wal.h)
+static void rejectUnsaved(ParkingBatch& batch)
+{
+	for (size_t i = 0; i < batch.requests.size(); ++i)
+	{
+		if (batch.requests[i].error == nullptr && changesState(batch.requests[i]))
+		{
+			batch.responses[i] = resultText(ERROR_STORAGE);
+		}
+	}
+}
+
+void applyBatch(ParkingBatch& batch)
+{
+	if (batch.requests.empty())
+	{
+		return;
+	}
+	validateBatch(batch);
+	batch.responses.resize(batch.requests.size());
+
+	bool anyValid = false;
+	for (size_t i = 0; i < batch.requests.size(); ++i)
+	{
+		batch.responses[i] = batch.requests[i].error;
+		anyValid = anyValid || batch.requests[i].error == nullptr;
+	}
+	if (!anyValid)
+	{
+		return;
+	}
+
+	// El hilo del estado publica él mismo, en el orden en que aplica
+	if (stateActorRunning())
+	{
+		runOnStateActor(batch);
+	}
+	else
+	{
+		applyValidatedBatch(batch);
+		if (!batch.updates.empty())
+		{
+			publishEvents();
+		}
+	}
+
+	// --durabilidad evento: no se responde hasta que el último evento del
+	// lote (y con él todos los anteriores) esté en disco
+	if (!batch.updates.empty() && !batch.deferDurable && !walWaitDurable(batch.updates.back().sequence))
+	{
+		rejectUnsaved(batch);
+	}
+}
+
+void applyValidatedBatch(ParkingBatch& batch)
+{
+	// Cada solicitud toma solo los locks que necesita (ver applyRequest)
+	for (size_t i = 0; i < batch.requests.size(); ++i)
+	{
+		if (batch.requests[i].error == nullptr)
+		{
+			batch.responses[i] = applyRequest(batch.requests[i], batch);
+		}
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: setEventPublisher / publishEvents
+// ============================================================================
+void setEventPublisher(EventPublisher publisher, void* context)
+{
+	lock_guard<mutex> publishing(publishMutex);
+	lock_guard<mutex> lock(historyMutex);
+	eventPublisher = publisher;
+	publisherContext = context;
+	unpublished.clear();
+}
+
+void publishEvents()
+{
+	// Solo con publishMutex: conserva su capacidad entre publicaciones
+	static vector<ParkingUpdate> ready;
+
+	while (publishMutex.try_lock())
+	{
+		// Tomar tandas hasta que no quede nada: lo que otro hilo numere
+		// mientras tanto sale en la siguiente, en orden
+		while (true)
+		{
+			{
+				lock_guard<mutex> lock(historyMutex);
+				ready.swap(unpublished);
+			}
+			if (ready.empty())
+			{
+				break;
+			}
+			eventPublisher(ready, publisherContext);
+			ready.clear();
+		}
+		publishMutex.unlock();
+
+		// Un hilo pudo numerar eventos y fallar el try_lock justo antes del
+		// unlock: si quedó algo, se vuelve a intentar
+		lock_guard<mutex> lock(historyMutex);
+		if (unpublished.empty())
+		{
+			return;
+		}
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: collectDelta
+// ============================================================================
+bool collectDelta(vector<ParkingUpdate>& updates)
+{
+	updates.clear();
+	lock_guard<mutex> growth(growthMutex);
+	AllZonesLock zonesLock;
+	lock_guard<mutex> lock(historyMutex);
+
+	if (capacityDirty)
+	{
+		int total = numSpots.load(memory_order_relaxed);
+		ParkingUpdate& update = addUpdate(updates, -1);
+		update.plateCode = (unsigned int)total;
+		setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "CAPACIDAD:%d", total));
+		capacityDirty = false;
+	}
+
+	for (int z = 0; z < zonesLock.size(); ++z)
+	{
+		ParkingZone& zone = *zones[(size_t)z];
+		const ParkingManager& parking = *zone.parking;
+
+		for (size_t word = 0; word < zone.dirty.size(); ++word)
+		{
+			unsigned long long bits = zone.dirty[word];
+			if (bits == 0)
+			{
+				continue;
+			}
+			zone.dirty[word] = 0;
+
+			for (int bit = 0; bits != 0; ++bit, bits >>= 1)
+			{
+				if ((bits & 1) == 0)
+				{
+					continue;
+				}
+
+				// Estado ACTUAL de la plaza, no el último evento recibido
+				int local = (int)(word * 64) + bit;
+				int spot = zone.first + local;
+				ParkingUpdate& update = addUpdate(updates, spot);
+				if (!parking.isSpotOccupied(local))
+				{
+					setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "%d:SALIDA", spot + 1));
+					continue;
+				}
+				update.plateCode = parking.getPlateCode(local);
+				update.entryTime = parking.getEntryTime(local);
+				const char* plate = parking.getPlate(local);
+				const char* timestamp = parking.getTimestamp(local);
+				if (timestamp[0] != '\0')
+				{
+					setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "%d:%s:%s", spot + 1, plate, timestamp));
+				}
+				else
+				{
+					setUpdateLength(update, snprintf(update.text, MAX_UPDATE, "%d:%s", spot + 1, plate));
+				}
+			}
+		}
+	}
+
+	// El delta lleva la secuencia del instante en que se tomó
+	for (ParkingUpdate& update : updates)
+	{
+		update.sequence = eventSequence;
+	}
+	return !updates.empty();
+}
+
+// ============================================================================
+// FUNCIÓN: encodeResponse / encodeBinaryUpdate
+// ============================================================================
+
+// Resultado de una respuesta de texto: todas salen de resultText() (o de
+// statusText), así que basta comparar punteros
+static ParkingResult resultOf(const char* response, const ParkingBatch& batch)
+{
+	if (response == batch.statusText)
+	{
+		return RESULT_STATUS;
+	}
+	static const ParkingResult results[] = {
+		RESULT_PARKED, RESULT_LEFT, RESULT_RESIZED, RESULT_HELLO,
+		ERROR_FORMAT, ERROR_PLATE, ERROR_SPOT, ERROR_OCCUPIED, ERROR_CAPACITY, ERROR_SHRINK, ERROR_VERSION,
+		ERROR_STORAGE
+	};
+	for (ParkingResult result : results)
+	{
+		if (response == resultText(result))
+		{
+			return result;
+		}
+	}
+	return ERROR_FORMAT;
+}
+
+static void appendBinary(const BinaryMessage& message, string& out)
+{
+	char bytes[BINARY_MESSAGE_SIZE];
+	encodeBinaryMessage(message, bytes);
+	out.append(bytes, sizeof(bytes));
+}
+
+void encodeResponse(FrameMode mode, const ParkingBatch& batch, size_t index, string& out)
+{
+	const char* response = batch.responses[index];
+	if (mode != FRAME_BINARY)
+	{
+		StreamFramer::encode(mode, response, strlen(response), out);
+		return;
+	}
+
+	const ParkingRequest& request = batch.requests[index];
+	BinaryMessage reply;
+	reply.op = (uint8_t)(request.binaryOp | BIN_OP_REPLY);
+	reply.result = (uint8_t)resultOf(response, batch);
+	reply.spot = (uint32_t)(request.spotIndex + 1);
+	reply.plate = request.plateCode;
+	reply.aux = 0;
+	reply.timestamp = 0;
+
+	if (reply.result == RESULT_STATUS)
+	{
+		reply.spot = batch.statusValues[0];
+		reply.plate = batch.statusValues[1];
+		reply.aux = batch.statusValues[2];
+	}
+	else if (request.type == REQUEST_CAPACITY)
+	{
+		reply.spot = (uint32_t)request.newSpots;
+	}
+	else if (request.type == REQUEST_HELLO)
+	{
+		reply.aux = BINARY_PROTOCOL_VERSION;
+	}
+	appendBinary(reply, out);
+}
+
+void encodeBinaryUpdate(const ParkingUpdate& update, string& out)
+{
+	BinaryMessage message;
+	message.result = RESULT_NONE;
+	message.spot = (uint32_t)(update.spot + 1);
+	message.plate = update.plateCode;
+	message.aux = 0;
+	message.timestamp = update.entryTime;
+
+	if (update.spot == -1)
+	{
+		message.op = BIN_OP_RESIZED;
+		message.spot = update.plateCode;
+		message.plate = PLATE_INVALID;
+	}
+	else if (update.plateCode == PLATE_INVALID)
+	{
+		message.op = BIN_OP_LEFT;
+	}
+	else
+	{
+		message.op = BIN_OP_ENTERED;
+	}
+	appendBinary(message, out);
+}
+
+// ============================================================================
+// FUNCIÓN: appendBase64
+// ============================================================================
+static void appendBase64(const unsigned char* data, size_t length, string& out)
+{
+	static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	size_t i = 0;
+	for (; i + 3 <= length; i += 3)
+	{
+		unsigned int v = ((unsigned int)data[i] << 16) | ((unsigned int)data[i + 1] << 8) | data[i + 2];
+		out += digits[(v >> 18) & 63];
+		out += digits[(v >> 12) & 63];
+		out += digits[(v >> 6) & 63];
+		out += digits[v & 63];
+	}
+	if (i < length)
+	{
+		unsigned int v = (unsigned int)data[i] << 16;
+		if (i + 1 < length)
+		{
+			v |= (unsigned int)data[i + 1] << 8;
+		}
+		out += digits[(v >> 18) & 63];
+		out += digits[(v >> 12) & 63];
+		out += (i + 1 < length) ? digits[(v >> 6) & 63] : '=';
+		out += '=';
+	}
+}
+
+static void putLittleEndian(unsigned char* out, unsigned long long value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		out[i] = (unsigned char)(value >> (8 * i));
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: collectParkedVehicles
+// ============================================================================
+unsigned long long collectParkedVehicles(vector<WalRecord>& records)
+{
+	records.clear();
+	lock_guard<mutex> growth(growthMutex);
+	AllZonesLock zonesLock;
+	lock_guard<mutex> lock(historyMutex);
+	unsigned long long current = eventSequence;
+
+	WalRecord record;
+	record.sequence = current;
+	record.kind = WAL_CAPACITY;
+	record.spot = numSpots.load(memory_order_relaxed);
+	record.plateCode = PLATE_INVALID;
+	record.entryTime = 0;
+	records.push_back(record);
+
+	for (int z = 0; z < zonesLock.size(); ++z)
+	{
+		const ParkingZone& zone = *zones[(size_t)z];
+		for (int spot = zone.parking->findNextOccupied(0); spot != -1; spot = zone.parking->findNextOccupied(spot + 1))
+		{
+			record.kind = WAL_ENTRY;
+			record.spot = zone.first + spot;
+			record.plateCode = zone.parking->getPlateCode(spot);
+			record.entryTime = zone.parking->getEntryTime(spot);
+			records.push_back(record);
+		}
+	}
+	return current;
+}
+
+// ============================================================================
+// FUNCIÓN: buildSubscription
+// ============================================================================
+unsigned long long buildSubscription(long long resumeFrom, FrameMode mode, string& out)
+{
+	// Las respuestas de varias líneas necesitan delimitador
+	if (mode == FRAME_RAW)
+	{
+		mode = FRAME_LINE;
+	}
+
+	char header[MAX_UPDATE + 64];
+	int length;
+
+	// REANUDAR: todos los eventos posteriores a resumeFrom siguen en el historial
+	if (resumeFrom >= 0)
+	{
+		lock_guard<mutex> lock(historyMutex);
+		unsigned long long current = eventSequence;
+		unsigned long long oldest = (current > history.size()) ? current - history.size() : 0;
+		if ((unsigned long long)resumeFrom >= oldest && (unsigned long long)resumeFrom <= current)
+		{
+			length = snprintf(header, sizeof(header), "REANUDADO:%lld:%llu", resumeFrom, current);
+			StreamFramer::encode(mode, header, (size_t)length, out);
+
+			for (unsigned long long s = (unsigned long long)resumeFrom + 1; s <= current; ++s)
+			{
+				const ParkingUpdate& update = history[s % history.size()];
+				length = snprintf(header, sizeof(header), "EV:%llu:%.*s", s, (int)update.length, update.text);
+				StreamFramer::encode(mode, header, (size_t)length, out);
+			}
+			return current;
+		}
+	}
+
+	// ESTADO COMPLETO
+	lock_guard<mutex> growth(growthMutex);
+	AllZonesLock zonesLock;
+	lock_guard<mutex> lock(historyMutex);
+	unsigned long long current = eventSequence;
+
+	int occupied = 0;
+	for (int z = 0; z < zonesLock.size(); ++z)
+	{
+		occupied += zones[(size_t)z]->parking->getOccupiedCount();
+	}
+	length = snprintf(header, sizeof(header), "SNAPSHOT:%llu:%d:%d", current,
+		numSpots.load(memory_order_relaxed), occupied);
+	StreamFramer::encode(mode, header, (size_t)length, out);
+
+	vector<unsigned char> records;
+	records.reserve(SNAPSHOT_CHUNK * 16);
+	string frame;
+	for (int z = 0; z < zonesLock.size(); ++z)
+	{
+		const ParkingZone& zone = *zones[(size_t)z];
+		for (int spot = zone.parking->findNextOccupied(0); spot != -1; spot = zone.parking->findNextOccupied(spot + 1))
+		{
+			unsigned char record[16];
+			putLittleEndian(record, (unsigned long long)(zone.first + spot), 4);
+			putLittleEndian(record + 4, zone.parking->getPlateCode(spot), 4);
+			putLittleEndian(record + 8, (unsigned long long)zone.parking->getEntryTime(spot), 8);
+			records.insert(records.end(), record, record + 16);
+
+			if (records.size() == SNAPSHOT_CHUNK * 16)
+			{
+				frame = "SNAPDATA:";
+				appendBase64(records.data(), records.size(), frame);
+				StreamFramer::encode(mode, frame.data(), frame.size(), out);
+				records.clear();
+			}
+		}
+	}
+	if (!records.empty())
+	{
+		frame = "SNAPDATA:";
+		appendBase64(records.data(), records.size(), frame);
+		StreamFramer::encode(mode, frame.data(), frame.size(), out);
+	}
+	return current;
+}
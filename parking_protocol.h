@@ -0,0 +1,275 @@
+// ============================================================================
+// ARCHIVO: parking_protocol.h
+// PROPÓSITO: Lógica compartida del protocolo "PLAZA:PLACA:TIMESTAMP"
+// DESCRIPCIÓN: Estado de las plazas y procesamiento de mensajes, común a
+//              todos los motores del servidor (hilos, epoll, ...). El estado
+//              vive en ParkingManager (parking_lib.h) repartidos por zonas,
+//              así que entradas y salidas no reservan memoria
+// ============================================================================
+
+#ifndef PARKING_PROTOCOL_H
+#define PARKING_PROTOCOL_H
+
+#include <string>
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include "plate_codec.h"
+#include "parking_lib.h"
+#include "framing.h"
+#include "binary_protocol.h"
+
+struct WalRecord;
+
+// Tamaño máximo de un mensaje del protocolo
+#define MAX_MESSAGE 1024
+
+// Límite de plazas que acepta CAPACIDAD:N
+#define MAX_SPOTS 100000
+
+// Longitud máxima de una actualización ("PLAZA:PLACA:TIMESTAMP")
+#define MAX_UPDATE 64
+
+// Eventos recientes que se guardan para reanudar suscripciones
+#define DEFAULT_HISTORY 4096
+
+// Zonas en que se reparte el parqueadero (ver ESTADO COMPARTIDO)
+#define DEFAULT_ZONES 8
+
+// Franjas del índice global de placas (potencia de dos)
+#define PLATE_STRIPE_BITS 6
+#define PLATE_STRIPES (1 << PLATE_STRIPE_BITS)
+
+// Vehículos por trama SNAPDATA (16 bytes cada uno antes de base64: la
+// trama queda en ~11 KB, por debajo de FRAMER_CAPACITY)
+#define SNAPSHOT_CHUNK 512
+
+// ============================================================================
+// ESTADO COMPARTIDO DEL PARQUEADERO
+// DESCRIPCIÓN: Las plazas se reparten en zonas de plazas consecutivas (como
+//   los pisos de un edificio), cada una con su ParkingManager y su propio
+//   mutex: dos lotes que tocan zonas distintas no se esperan. La regla "una
+//   placa que ya está estacionada sale, esté en la plaza que esté" cruza
+//   zonas, así que un índice global placa -> plaza, partido en
+//   PLATE_STRIPES franjas con su mutex, decide si un mensaje es entrada o
+//   salida. Toda la operación sobre una placa ocurre con su franja tomada
+//   (ver applyRequest en parking_protocol.cpp)
+// ORDEN DE LOCKS: crecimiento -> franja -> zonas (de menor a mayor) ->
+//   historial -> WAL. Snapshot y delta toman todas las zonas para leer un
+//   mismo instante. La publicación (publishEvents) va antes del historial
+//   y nunca se toma con una zona bloqueada
+// NOTA: numSpots es atómico porque se lee sin lock al validar. Solo crece,
+//       y las plazas nuevas existen antes de publicarlo
+// ============================================================================
+extern std::atomic<int> numSpots;
+
+// historySize: eventos que se conservan para SUSCRIBIR:N (0 = ninguno).
+// zones: número de zonas (menos si saldrían de menos de 64 plazas); las
+// que se añadan con CAPACIDAD:N tienen el mismo tamaño
+void initParkingState(int spots, int historySize = DEFAULT_HISTORY, int zones = DEFAULT_ZONES);
+void freeParkingState();
+
+// Zonas actuales (crecen con CAPACIDAD:N)
+int parkingZoneCount();
+
+// ============================================================================
+// ESTRUCTURA: ParkingRequest
+// PROPÓSITO: Un mensaje "PLAZA:PLACA:TIMESTAMP" ya parseado y validado, o
+//            uno de administración:
+//              - "CAPACIDAD:N": amplía el parqueadero a N plazas
+//              - "ESTADO": responde plazas, ocupadas y reservas de memoria
+//              - "SUSCRIBIR" / "SUSCRIBIR:N": pide el estado completo, o
+//                solo los eventos posteriores al número de secuencia N
+//                (ver buildSubscription)
+// NOTA: Placa y hora se copian: el buffer del framer se reutiliza mientras
+//       se extraen los siguientes mensajes del lote
+// ============================================================================
+enum RequestType {
+    REQUEST_PARKING,
+    REQUEST_CAPACITY,
+    REQUEST_STATUS,
+    REQUEST_SUBSCRIBE,
+    REQUEST_HELLO             // Solo protocolo binario (BIN_OP_HELLO)
+};
+
+struct ParkingRequest {
+    RequestType type;
+    int spotIndex;            // Plaza (0..numSpots-1)
+    char plate[PLATE_RECORD_SIZE];    // Registro de placa tal como llegó
+    unsigned int plateCode;   // Código de la placa (ver plate_codec.h)
+    char timestamp[32];       // Vacío si el mensaje no la trae
+    int newSpots;             // CAPACIDAD:N -> N
+    long long resumeFrom;     // SUSCRIBIR:N -> N (-1 = estado completo)
+    unsigned char binaryOp;   // Op del mensaje binario (0 = texto)
+    const char* error;        // Respuesta de error, nullptr si es válido
+};
+
+// ============================================================================
+// ESTRUCTURA: ParkingBatch
+// PROPÓSITO: Todos los mensajes extraídos de un mismo recv. Se reutiliza
+//            entre lecturas: los vectores conservan su capacidad y las
+//            actualizaciones son de tamaño fijo, así que un lote no
+//            reserva memoria una vez que el servidor está en marcha
+// ============================================================================
+struct ParkingUpdate {
+    int spot;                 // Plaza afectada (-1 = CAPACIDAD:N)
+    unsigned long long sequence;    // Número de secuencia del evento
+    unsigned long long origin;      // ParkingBatch::origin del lote que lo causó
+    unsigned int plateCode;   // Placa que entró (PLATE_INVALID = salida). CAPACIDAD: N
+    long long entryTime;      // Hora de entrada en segundos (0 = sin hora)
+    char text[MAX_UPDATE];
+    size_t length;
+};
+
+struct ParkingBatch {
+    std::vector<ParkingRequest> requests;
+    std::vector<const char*> responses;    // Una respuesta por mensaje
+    std::vector<unsigned int> plateCodes;  // Salida de encodePlates
+    std::vector<ParkingUpdate> updates;    // Actualizaciones para broadcast
+    char statusText[128];                  // Respuesta de ESTADO (la última del lote)
+    unsigned int statusValues[3];          // La misma en binario: plazas, ocupadas, reservas
+    unsigned long long origin = 0;         // Conexión que envió el lote (no recibe
+                                           // su propia difusión); 0 = ninguna
+    bool deferDurable = false;             // true: applyBatch no espera al WAL, el
+                                           // motor retiene las respuestas (walStatus)
+    int validatedSpots = 0;                // numSpots con el que validateBatch comprobó
+                                           // las plazas (las de más esperan a un
+                                           // CAPACIDAD anterior del lote)
+
+    void clear()
+    {
+        requests.clear();
+        responses.clear();
+        plateCodes.clear();
+        updates.clear();
+    }
+};
+
+// ============================================================================
+// FUNCIÓN: growParkingState
+// PROPÓSITO: Amplía el parqueadero en caliente conservando los vehículos:
+//            completa la última zona y añade las que falten
+// NOTA: Toma el lock de crecimiento y el de la última zona; los lotes que
+//       no tocan esa zona siguen sin esperar. El evento CAPACIDAD:N se
+//       numera (y va al WAL) antes de publicar numSpots, así que una
+//       entrada en una plaza nueva siempre lleva una secuencia mayor
+// PARÁMETROS:
+//   - updates: recibe la actualización CAPACIDAD:N para la difusión
+//   - origin: ParkingBatch::origin del lote que la pidió
+// RETORNA: false si newSpots no es mayor que la capacidad actual
+// ============================================================================
+bool growParkingState(int newSpots, std::vector<ParkingUpdate>& updates, unsigned long long origin);
+
+// ============================================================================
+// FUNCIÓN: parseRequest
+// PROPÓSITO: Parsea un mensaje SIN tomar ningún lock. La placa y la plaza
+//            se validan en applyBatch, para todo el lote a la vez
+// PARÁMETROS:
+//   - buffer: Mensaje terminado en '\0' (se modifica al parsear)
+// ============================================================================
+void parseRequest(char* buffer, ParkingRequest& request);
+
+// Lo mismo para un mensaje de BINARY_MESSAGE_SIZE bytes (FRAME_BINARY)
+void parseBinaryRequest(const char* message, ParkingRequest& request);
+
+// ============================================================================
+// FUNCIÓN: applyBatch
+// PROPÓSITO: Valida las placas del lote de una vez (encodePlates) y aplica
+//            las solicitudes en orden. Cada una toma solo la franja de su
+//            placa y la zona de su plaza. Dentro de los locks no se
+//            escribe en consola: los eventos van a async_log
+// RESULTADO: batch.responses y batch.updates quedan llenos. La respuesta
+//            de un SUSCRIBIR queda en nullptr: la arma el motor con
+//            buildSubscription, en orden con las demás respuestas
+// NOTA: Los eventos del lote se publican antes de retornar (ver
+//       publishEvents). Con el hilo del estado en marcha (--estado
+//       actor, ver state_actor.h) la validación se hace aquí y la
+//       aplicación allí.
+//       Con --durabilidad evento (ver wal.h) retorna cuando los eventos
+//       del lote están en disco, salvo con deferDurable. Si el WAL falló,
+//       sus entradas, salidas y CAPACIDAD responden ERROR_STORAGE
+// ============================================================================
+void applyBatch(ParkingBatch& batch);
+
+// Solo la segunda mitad de applyBatch: aplica las solicitudes sin error de
+// un lote ya validado (la usa el hilo del estado)
+void applyValidatedBatch(ParkingBatch& batch);
+
+// ============================================================================
+// PUBLICACIÓN EN ORDEN DE SECUENCIA
+// PROPÓSITO: Dos lotes aplicados a la vez en hilos distintos numeran sus
+//            eventos en un orden y podrían difundirlos en el otro; un
+//            suscriptor descarta un EV:n que llega después de EV:n+1. Por
+//            eso los eventos numerados esperan en una lista y se entregan
+//            al publicador del motor de a uno, en orden de secuencia
+// USO:
+//   - setEventPublisher: el motor registra su publicador al arrancar
+//                        (nullptr al detenerse, o en modo ticks: entonces
+//                        los eventos no se guardan)
+//   - publishEvents:     applyBatch la llama después de aplicar. Si otro
+//                        hilo está publicando, no espera: ese hilo se
+//                        lleva también estos eventos antes de terminar
+// NOTA: El publicador recibe los eventos en orden y se llama sin ningún
+//       lock del estado tomado; puede reordenar el vector a su gusto
+// ============================================================================
+typedef void (*EventPublisher)(std::vector<ParkingUpdate>& updates, void* context);
+
+void setEventPublisher(EventPublisher publisher, void* context);
+void publishEvents();
+
+// ============================================================================
+// FUNCIÓN: encodeResponse / encodeBinaryUpdate
+// PROPÓSITO: Añaden a out la respuesta a batch.requests[index] (no vale
+//            para SUSCRIBIR) o una actualización. En FRAME_BINARY la
+//            respuesta es un mensaje con su ParkingResult (ver
+//            binary_protocol.h); en los demás modos, el texto encuadrado
+// ============================================================================
+void encodeResponse(FrameMode mode, const ParkingBatch& batch, size_t index, std::string& out);
+void encodeBinaryUpdate(const ParkingUpdate& update, std::string& out);
+
+// ============================================================================
+// FUNCIÓN: buildSubscription
+// PROPÓSITO: Añade a out (con el encuadre mode) la respuesta a SUSCRIBIR.
+//            Cada evento aplicado recibe un número de secuencia creciente;
+//            a partir de aquí el motor envía a este cliente los eventos
+//            como "EV:<secuencia>:<mensaje>"
+// FORMATO:
+//   - Reanudación (N sigue en el historial):
+//       "REANUDADO:<N>:<actual>" y luego "EV:<s>:<mensaje>" para cada
+//       evento con N < s <= actual
+//   - Estado completo:
+//       "SNAPSHOT:<secuencia>:<plazas>:<ocupadas>" y luego tramas
+//       "SNAPDATA:<base64>" con hasta SNAPSHOT_CHUNK vehículos de 16 bytes
+//       (little-endian): plaza u32 (0..plazas-1), código de placa u32
+//       (plate_codec.h), hora de entrada i64 (segundos desde 1970, 0 = sin
+//       hora)
+//   - En modo ticks, un DELTA de varias tramas llega como
+//     "EVP:<s>:DELTA:..." y la última trama como "EV:<s>:DELTA:...": el
+//     cliente aplica las EVP pero solo avanza su secuencia con la EV
+// NOTA: Toma todas las zonas: el snapshot y su secuencia son de un mismo
+//       instante (la reanudación solo toma el historial). Un evento con secuencia <= la recibida puede llegar
+//       después (se publicó tarde): el cliente debe ignorarlo
+// RETORNA: La secuencia actual
+// ============================================================================
+unsigned long long buildSubscription(long long resumeFrom, FrameMode mode, std::string& out);
+
+// ============================================================================
+// FUNCIÓN: collectDelta
+// PROPÓSITO: Estado actual de cada plaza que cambió desde la llamada
+//            anterior ("N:PLACA[:TIMESTAMP]" o "N:SALIDA", más
+//            "CAPACIDAD:N" si se amplió), tomado con todas las zonas
+//            bloqueadas: todo el resultado corresponde a un mismo instante
+// RETORNA: false si no hubo cambios
+// ============================================================================
+bool collectDelta(std::vector<ParkingUpdate>& updates);
+
+// ============================================================================
+// FUNCIÓN: collectParkedVehicles
+// PROPÓSITO: El estado actual como registros del WAL (compactación, ver
+//            wal.h): un CAPACIDAD con las plazas y una entrada por
+//            vehículo estacionado, tomados con todas las zonas bloqueadas
+// RETORNA: La secuencia actual (la llevan todos los registros)
+// ============================================================================
+unsigned long long collectParkedVehicles(std::vector<WalRecord>& records);
+
+#endif
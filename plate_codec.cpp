@@ -0,0 +1,126 @@
+#include "plate_codec.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLATE_CODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+void copyPlateRecord(const char* plate, char* record) {
+    memset(record, 0, PLATE_RECORD_SIZE);
+    if (plate == nullptr) return;
+    for (int i = 0; i < PLATE_RECORD_SIZE - 1 && plate[i] != '\0'; ++i) {
+        record[i] = plate[i];
+    }
+}
+
+// Empaqueta los campos sin validarlos: letras en bits 24-10, número en 9-0
+static inline unsigned int packFields(const unsigned char* r) {
+    unsigned int l0 = (unsigned int)((r[0] | 0x20) - 'a') & 31;
+    unsigned int l1 = (unsigned int)((r[1] | 0x20) - 'a') & 31;
+    unsigned int l2 = (unsigned int)((r[2] | 0x20) - 'a') & 31;
+    unsigned int number = (unsigned int)(r[3] - '0') * 100 + (unsigned int)(r[4] - '0') * 10 +
+                          (unsigned int)(r[5] - '0');
+    return (l0 << 20) | (l1 << 15) | (l2 << 10) | (number & 0x3FF);
+}
+
+unsigned int encodePlateRecord(const char* record) {
+    const unsigned char* r = (const unsigned char*)record;
+
+    // Cada comparación da 0 o 1; se combinan con | sin saltos. El "| 0x20"
+    // pasa las mayúsculas a minúsculas y deja fuera de rango lo demás
+    unsigned int bad = ((unsigned int)((r[0] | 0x20) - 'a') > 25u) |
+                       ((unsigned int)((r[1] | 0x20) - 'a') > 25u) |
+                       ((unsigned int)((r[2] | 0x20) - 'a') > 25u) |
+                       ((unsigned int)(r[3] - '0') > 9u) |
+                       ((unsigned int)(r[4] - '0') > 9u) |
+                       ((unsigned int)(r[5] - '0') > 9u) |
+                       (r[6] != 0);
+
+    // bad = 1 -> 0xFFFFFFFF = PLATE_INVALID
+    return packFields(r) | (0u - bad);
+}
+
+unsigned int encodePlate(const char* plate) {
+    char record[PLATE_RECORD_SIZE];
+    copyPlateRecord(plate, record);
+    return encodePlateRecord(record);
+}
+
+void decodePlate(unsigned int code, char* text) {
+    unsigned int number = code & 0x3FF;
+    text[0] = (char)('A' + ((code >> 20) & 31));
+    text[1] = (char)('A' + ((code >> 15) & 31));
+    text[2] = (char)('A' + ((code >> 10) & 31));
+    text[3] = (char)('0' + number / 100);
+    text[4] = (char)('0' + number / 10 % 10);
+    text[5] = (char)('0' + number % 10);
+    text[6] = '\0';
+    text[7] = '\0';
+}
+
+#ifdef PLATE_CODEC_SSE2
+static inline long long loadRecord(const char* record) {
+    long long value;
+    memcpy(&value, record, sizeof(value));
+    return value;
+}
+
+// Constantes por byte de un registro, repetidas para cada registro del
+// vector: se resta el mínimo y se comprueba el rango con resta saturada
+// (x - min > rango  <=>  subs(x - min, rango) != 0)
+static const long long FOLD_BYTES  = 0x0000000000202020LL;  // Letras a minúscula
+static const long long MIN_BYTES   = 0x0000303030616161LL;  // 'a' 'a' 'a' '0' '0' '0' 0 x
+static const long long RANGE_BYTES = (long long)0xFF00090909191919ULL;  // 25 25 25 9 9 9 0 255
+
+// Máscara de 16 bits: byte a 1 si está en rango
+static inline int validMask(__m128i records) {
+    const __m128i fold = _mm_set1_epi64x(FOLD_BYTES);
+    const __m128i min = _mm_set1_epi64x(MIN_BYTES);
+    const __m128i range = _mm_set1_epi64x(RANGE_BYTES);
+    __m128i shifted = _mm_sub_epi8(_mm_or_si128(records, fold), min);
+    __m128i over = _mm_subs_epu8(shifted, range);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(over, _mm_setzero_si128()));
+}
+#endif
+
+void encodePlates(const char* records, size_t stride, size_t count, unsigned int* codes) {
+    size_t i = 0;
+
+#ifdef __AVX2__
+    const __m256i fold = _mm256_set1_epi64x(FOLD_BYTES);
+    const __m256i min = _mm256_set1_epi64x(MIN_BYTES);
+    const __m256i range = _mm256_set1_epi64x(RANGE_BYTES);
+    for (; i + 4 <= count; i += 4) {
+        const char* r = records + i * stride;
+        __m256i block = _mm256_set_epi64x(loadRecord(r + 3 * stride), loadRecord(r + 2 * stride),
+                                          loadRecord(r + stride), loadRecord(r));
+        __m256i shifted = _mm256_sub_epi8(_mm256_or_si256(block, fold), min);
+        __m256i over = _mm256_subs_epu8(shifted, range);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(over, _mm256_setzero_si256()));
+        for (int k = 0; k < 4; ++k) {
+            unsigned int bad = ((mask >> (8 * k)) & 0xFF) != 0xFF;
+            codes[i + k] = packFields((const unsigned char*)(r + k * stride)) | (0u - bad);
+        }
+    }
+#endif
+
+#ifdef PLATE_CODEC_SSE2
+    for (; i + 2 <= count; i += 2) {
+        const char* r = records + i * stride;
+        int mask = validMask(_mm_set_epi64x(loadRecord(r + stride), loadRecord(r)));
+        unsigned int bad0 = (mask & 0xFF) != 0xFF;
+        unsigned int bad1 = ((mask >> 8) & 0xFF) != 0xFF;
+        codes[i] = packFields((const unsigned char*)r) | (0u - bad0);
+        codes[i + 1] = packFields((const unsigned char*)(r + stride)) | (0u - bad1);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        codes[i] = encodePlateRecord(records + i * stride);
+    }
+}
@@ -0,0 +1,59 @@
+// ============================================================================
+// ARCHIVO: plate_codec.h
+// PROPÓSITO: Validar y codificar placas AAA000 en un entero de 32 bits
+// DESCRIPCIÓN: Compartido por todos los servidores y por ParkingManager.
+//              Una placa válida se guarda y se compara como un unsigned int:
+//              5 bits por letra (sin distinguir mayúsculas) y 10 bits para
+//              el número, 25 bits en total. La validación no usa el locale
+//              (isalpha/isdigit) ni saltos por carácter.
+//
+// REGISTRO DE PLACA: bloque de 8 bytes con la placa tal como llegó, rellena
+//   con '\0'. Es válido si los bytes 0-2 son letras, 3-5 dígitos y el byte 6
+//   es '\0' (el 7 se ignora). Los lotes se validan con SSE2/AVX2.
+// ============================================================================
+
+#ifndef PLATE_CODEC_H
+#define PLATE_CODEC_H
+
+#include <stddef.h>
+
+// Código de una placa inválida (y de una plaza vacía)
+#define PLATE_INVALID 0xFFFFFFFFu
+
+// Tamaño de un registro de placa y del texto de decodePlate
+#define PLATE_RECORD_SIZE 8
+
+// ============================================================================
+// FUNCIÓN: copyPlateRecord
+// PROPÓSITO: Copia una placa terminada en '\0' a un registro de 8 bytes.
+//            Lee como mucho 7 caracteres: una placa más larga deja el
+//            byte 6 distinto de '\0' y el registro resulta inválido
+// ============================================================================
+void copyPlateRecord(const char* plate, char* record);
+
+// Codifica un registro; PLATE_INVALID si no es AAA000
+unsigned int encodePlateRecord(const char* record);
+
+// Codifica una placa terminada en '\0'; PLATE_INVALID si no es AAA000
+unsigned int encodePlate(const char* plate);
+
+// Texto "AAA000" en mayúsculas. text debe tener PLATE_RECORD_SIZE bytes
+void decodePlate(unsigned int code, char* text);
+
+inline bool isValidPlate(const char* plate)
+{
+    return encodePlate(plate) != PLATE_INVALID;
+}
+
+// ============================================================================
+// FUNCIÓN: encodePlates
+// PROPÓSITO: Codifica "count" registros de una vez
+// PARÁMETROS:
+//   - records: Primer registro
+//   - stride: Distancia en bytes entre registros (permite leer el campo de
+//             placa de un arreglo de structs sin copiarlo)
+//   - codes: Salida, un código por registro (PLATE_INVALID si no es válido)
+// ============================================================================
+void encodePlates(const char* records, size_t stride, size_t count, unsigned int* codes);
+
+#endif
@@ -0,0 +1,32 @@
+// ============================================================================
+// ARCHIVO: server_config.h
+// PROPÓSITO: Opciones de arranque del servidor, compartidas por los motores
+// ============================================================================
+
+#ifndef SERVER_CONFIG_H
+#define SERVER_CONFIG_H
+
+#include <string>
+
+struct ServerConfig {
+    int port = 8080;              // Puerto TCP de escucha
+    int numSpots = 40;            // Número de plazas del parqueadero
+    int zones = 8;                // Zonas con lock propio (ver parking_protocol.h)
+    std::string stateMode = "zonas";  // "zonas" o "actor" (ver state_actor.h)
+    int backlog = 1024;           // Cola de conexiones pendientes de listen()
+    std::string engine;           // "hilos", "epoll", "uring" o "pool" (vacío = por defecto)
+    int workers = 0;              // Hilos del motor pool (0 = uno por núcleo)
+    int loops = 0;                // Bucles de epoll/uring, uno por socket de escucha (0 = uno por núcleo)
+    int statusIntervalMs = 1000;  // Tabla de estado en consola (0 = nunca)
+    std::string slowConsumers = "coalescer";  // Política para clientes lentos
+    int outboundBatches = 256;    // Lotes de difusión en cola por cliente
+    int broadcastTickMs = 0;      // Difusión agregada por ticks (0 = inmediata)
+    int historySize = 4096;       // Eventos guardados para reanudar (SUSCRIBIR:N)
+    std::string tracePath;        // Archivo de traza de mensajes (vacío = no grabar)
+    std::string walPath;          // Registro de escritura anticipada (vacío = sin WAL, ver wal.h)
+    std::string durability = "lotes";  // "ninguna", "lotes" o "evento"
+    int walIntervalMs = 10;       // Escritura (y fsync en lotes) cada N ms
+    int walBatchEvents = 256;     // ... o cada N eventos pendientes
+};
+
+#endif
@@ -1,381 +1,759 @@
-// ============================================================================
-// ARCHIVO: servidor_multicliente.cpp
-// PROPÓSITO: Servidor de parqueadero con soporte para MÚLTIPLES CLIENTES
-// DESCRIPCIÓN: Usa threads para manejar varios clientes simultáneamente
-//              Permite que cliente.exe Y visualizador se conecten al mismo tiempo
-// ============================================================================
-
-#include <iostream>
-#include <WinSock2.h>
-#include <WS2tcpip.h>
-#include <string>      // Para std::string y to_string
-#include <string.h>    // Para strchr, strcmp, strlen
-#include <cctype>
-#include <vector>
-#include <thread>
-#include <mutex>
-#include <algorithm>   // Para std::remove
-
-#pragma comment(lib, "ws2_32.lib")
-
-#define PORT 8080
-#define NUM_SPOTS 40
-
-using namespace std;
-
-// ============================================================================
-// VARIABLES GLOBALES COMPARTIDAS (protegidas por mutex)
-// ============================================================================
-
-// Arreglo de plazas compartido entre todos los threads
-char** parkingSpots = nullptr;
-
-// Mutex para sincronizar acceso al arreglo de plazas
-// Evita que dos threads modifiquen el arreglo simultáneamente
-mutex parkingMutex;
-
-// Vector con todos los sockets de clientes conectados
-vector<SOCKET> connectedClients;
-mutex clientsMutex;
-
-// ============================================================================
-// FUNCIÓN: printParkingStatus
-// ============================================================================
-void printParkingStatus(char** spots, int numSpots)
-{
-	cout << "\n---[ ESTADO DEL PARKING ]---\n";
-	for (int i = 0; i < numSpots; i++)
-	{
-		cout << " Plaza " << (i + 1) << ": ";
-		if (spots[i] == nullptr)
-		{
-			cout << "[ VACIO ]";
-		}
-		else
-		{
-			cout << "[ " << spots[i] << " ]";
-		}
-		cout << endl;
-	}
-	cout << "----------------------------------\n\n";
-}
-
-// ============================================================================
-// FUNCIÓN: isValidPlate
-// ============================================================================
-bool isValidPlate(const char* plate)
-{
-	if (strlen(plate) != 6)
-	{
-		return false;
-	}
-	for (int i = 0; i < 3; ++i)
-	{
-		if (!isalpha(plate[i]))
-		{
-			return false;
-		}
-	}
-	for (int i = 3; i < 6; ++i)
-	{
-		if (!isdigit(plate[i]))
-		{
-			return false;
-		}
-	}
-	return true;
-}
-
-// ============================================================================
-// FUNCIÓN: findPlate
-// ============================================================================
-int findPlate(const char* plate, char** spots, int numSpots)
-{
-	for (int i = 0; i < numSpots; ++i)
-	{
-		if (spots[i] != nullptr && strcmp(spots[i], plate) == 0)
-		{
-			return i;
-		}
-	}
-	return -1;
-}
-
-// ============================================================================
-// FUNCIÓN: broadcastMessage
-// PROPÓSITO: Envía un mensaje a TODOS los clientes conectados
-// ============================================================================
-void broadcastMessage(const string& message, SOCKET excludeSocket = INVALID_SOCKET)
-{
-	// BLOQUEAR ACCESO AL VECTOR DE CLIENTES
-	lock_guard<mutex> lock(clientsMutex);
-	
-	// ENVIAR A TODOS LOS CLIENTES (excepto al que envió el mensaje original)
-	for (auto it = connectedClients.begin(); it != connectedClients.end(); )
-	{
-		SOCKET clientSocket = *it;
-		
-		// No enviar al cliente que originó el mensaje
-		if (clientSocket != excludeSocket)
-		{
-			int result = send(clientSocket, message.c_str(), (int)message.length(), 0);
-			
-			// Si falla el envío, el cliente se desconectó
-			if (result == SOCKET_ERROR)
-			{
-				cout << "⚠ Cliente desconectado durante broadcast\n";
-				closesocket(clientSocket);
-				it = connectedClients.erase(it);
-				continue;
-			}
-		}
-		++it;
-	}
-}
-
-// ============================================================================
-// FUNCIÓN: handleClient (SE EJECUTA EN UN THREAD SEPARADO PARA CADA CLIENTE)
-// PROPÓSITO: Maneja la comunicación con un cliente específico
-// ============================================================================
-void handleClient(SOCKET clientSocket)
-{
-	char buffer[1024] = { 0 };
-	int valread;
-
-	cout << "[+] Nuevo cliente conectado (Socket: " << clientSocket << ")\n";
-
-	// BUCLE DE RECEPCIÓN DE MENSAJES
-	while ((valread = recv(clientSocket, buffer, 1024, 0)) > 0)
-	{
-		// Agregar terminador nulo
-		if (valread < 1024)
-		{
-			buffer[valread] = '\0';
-		}
-		else
-		{
-			buffer[1023] = '\0';
-		}
-
-		cout << ">> Cliente " << clientSocket << " envia: \"" << buffer << "\"\n";
-
-		// PARSEAR MENSAJE (formato: "PLAZA:PLACA:TIMESTAMP")
-		char* separator1 = strchr(buffer, ':');
-		const char* responseMessage = "mensaje no procesado";
-		string broadcastMsg = "";
-
-		if (separator1 == nullptr)
-		{
-			responseMessage = "ERROR: Formato invalido. Use PUESTO:PLACA:TIMESTAMP";
-		}
-		else
-		{
-			*separator1 = '\0';
-			char* rest = separator1 + 1;
-			
-			// Buscar el segundo separador (:)
-			char* separator2 = strchr(rest, ':');
-			char* plate = rest;
-			char* timestamp = nullptr;
-			
-			if (separator2 != nullptr)
-			{
-				*separator2 = '\0';
-				timestamp = separator2 + 1;
-			}
-			
-			int spotIndex = atoi(buffer) - 1;
-
-			// BLOQUEAR ACCESO AL ARREGLO DE PLAZAS (CRITICAL SECTION)
-			parkingMutex.lock();
-
-			if (!isValidPlate(plate))
-			{
-				responseMessage = "ERROR: Placa invalida. Formato: AAA000";
-			}
-			else if (spotIndex < 0 || spotIndex >= NUM_SPOTS)
-			{
-				responseMessage = "ERROR: Puesto invalido. Use 1, 2, 3 ... 40";
-			}
-			else
-			{
-				int existingSpot = findPlate(plate, parkingSpots, NUM_SPOTS);
-
-				if (existingSpot != -1)
-				{
-					// SALIDA: liberar plaza
-					cout << "[-] SALIDA:\n";
-					cout << "    Plaza: " << (existingSpot + 1) << "\n";
-					cout << "    Placa: " << plate << "\n";
-					if (timestamp) cout << "    Hora: " << timestamp << "\n";
-					
-					delete[] parkingSpots[existingSpot];
-					parkingSpots[existingSpot] = nullptr;
-					responseMessage = "OK: Vehiculo salio. Plaza liberada";
-					
-					// Mensaje para broadcast a otros clientes
-					broadcastMsg = to_string(existingSpot + 1) + ":SALIDA";
-				}
-				else
-				{
-					if (parkingSpots[spotIndex] == nullptr)
-					{
-						// ENTRADA: ocupar plaza
-						cout << "[+] ENTRADA:\n";
-						cout << "    Plaza: " << (spotIndex + 1) << "\n";
-						cout << "    Placa: " << plate << "\n";
-						if (timestamp) cout << "    Hora: " << timestamp << "\n";
-						
-						parkingSpots[spotIndex] = new char[strlen(plate) + 1];
-						strcpy_s(parkingSpots[spotIndex], strlen(plate) + 1, plate);
-						responseMessage = "OK: Vehiculo estacionado";
-						
-						// Mensaje para broadcast: "PLAZA:PLACA:TIMESTAMP"
-						broadcastMsg = string(buffer) + ":" + plate;
-						if (timestamp)
-						{
-							broadcastMsg += ":" + string(timestamp);
-						}
-					}
-					else
-					{
-						responseMessage = "ERROR: Plaza ya ocupada";
-					}
-				}
-			}
-
-			// Mostrar estado actualizado
-			printParkingStatus(parkingSpots, NUM_SPOTS);
-
-			// DESBLOQUEAR ACCESO AL ARREGLO
-			parkingMutex.unlock();
-		}
-
-		// ENVIAR RESPUESTA AL CLIENTE QUE HIZO LA SOLICITUD
-		send(clientSocket, responseMessage, (int)strlen(responseMessage), 0);
-
-		// ENVIAR ACTUALIZACIÓN A TODOS LOS DEMÁS CLIENTES
-		if (!broadcastMsg.empty())
-		{
-			broadcastMessage(broadcastMsg, clientSocket);
-		}
-	}
-
-	// CLIENTE DESCONECTADO
-	cout << "[-] Cliente " << clientSocket << " desconectado\n";
-	
-	// Remover de la lista de clientes conectados
-	clientsMutex.lock();
-	connectedClients.erase(
-		remove(connectedClients.begin(), connectedClients.end(), clientSocket),
-		connectedClients.end()
-	);
-	clientsMutex.unlock();
-	
-	closesocket(clientSocket);
-}
-
-// ============================================================================
-// FUNCIÓN PRINCIPAL
-// ============================================================================
-int main()
-{
-	WSADATA wsaData;
-	SOCKET servidor_fd;
-	struct sockaddr_in direccion;
-	int addrlen = sizeof(direccion);
-
-	// INICIALIZAR ARREGLO DE PLAZAS
-	parkingSpots = new char* [NUM_SPOTS];
-	for (int i = 0; i < NUM_SPOTS; ++i)
-	{
-		parkingSpots[i] = nullptr;
-	}
-
-	// INICIALIZAR WINSOCK
-	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
-	{
-		cerr << "✗ Error al inicializar Winsock\n";
-		return 1;
-	}
-
-	// CREAR SOCKET
-	servidor_fd = socket(AF_INET, SOCK_STREAM, 0);
-	if (servidor_fd == INVALID_SOCKET)
-	{
-		cerr << "✗ Error al crear socket\n";
-		WSACleanup();
-		return 1;
-	}
-
-	// CONFIGURAR DIRECCIÓN
-	direccion.sin_family = AF_INET;
-	direccion.sin_addr.s_addr = INADDR_ANY;
-	direccion.sin_port = htons(PORT);
-
-	// BIND
-	if (bind(servidor_fd, (struct sockaddr*)&direccion, sizeof(direccion)) == SOCKET_ERROR)
-	{
-		cerr << "✗ Error en bind\n";
-		closesocket(servidor_fd);
-		WSACleanup();
-		return 1;
-	}
-
-	// LISTEN
-	if (listen(servidor_fd, 10) == SOCKET_ERROR)  // Cola de hasta 10 conexiones
-	{
-		cerr << "✗ Error en listen\n";
-		closesocket(servidor_fd);
-		WSACleanup();
-		return 1;
-	}
-
-	cout << "\n";
-	cout << "========================================================\n";
-	cout << "  SERVIDOR MULTICLIENTE - PARQUEADERO\n";
-	cout << "========================================================\n";
-	cout << "[OK] Servidor iniciado en puerto " << PORT << "\n";
-	cout << "[*] Gestiona " << NUM_SPOTS << " plazas\n";
-	cout << "[*] Soporta MULTIPLES clientes simultaneamente\n";
-	cout << "[*] Esperando conexiones...\n";
-	cout << "========================================================\n\n";
-
-	// BUCLE PRINCIPAL: ACEPTAR CLIENTES
-	while (true)
-	{
-		SOCKET nuevo_socket = accept(servidor_fd, (struct sockaddr*)&direccion, &addrlen);
-		
-		if (nuevo_socket == INVALID_SOCKET)
-		{
-			cerr << "✗ Error en accept\n";
-			continue;
-		}
-
-		// AGREGAR A LA LISTA DE CLIENTES CONECTADOS
-		clientsMutex.lock();
-		connectedClients.push_back(nuevo_socket);
-		clientsMutex.unlock();
-
-		// CREAR UN NUEVO THREAD PARA ESTE CLIENTE
-		thread clientThread(handleClient, nuevo_socket);
-		
-		// Detach = el thread se ejecuta independientemente
-		clientThread.detach();
-	}
-
-	// LIMPIEZA (nunca se alcanza en este diseño)
-	closesocket(servidor_fd);
-	WSACleanup();
-
-	for (int i = 0; i < NUM_SPOTS; ++i)
-	{
-		if (parkingSpots[i] != nullptr)
-		{
-			delete[] parkingSpots[i];
-		}
-	}
-	delete[] parkingSpots;
-
-	return 0;
-}
+// ============================================================================
+// ARCHIVO: servidor_multicliente.cpp
+// PROPÓSITO: Servidor de parqueadero con soporte para MÚLTIPLES CLIENTES
+// DESCRIPCIÓN: Usa threads para manejar varios clientes simultáneamente
+//              Permite que cliente.exe Y visualizador se conecten al mismo tiempo
+//              En Linux usa por defecto un bucle epoll (ver epoll_engine.cpp)
+//              o, con --motor uring, uno io_uring (ver uring_engine.cpp)
+// USO: servidor_multicliente [--motor hilos|epoll|uring|pool] [--trabajadores N]
+//                             [--bucles N] [--puerto N] [--backlog N]
+//                             [--plazas N] [--intervalo-estado MS]
+//                             [--lentos descartar|coalescer|desconectar]
+//                             [--cola-difusion N] [--tick-difusion MS]
+//                             [--historial N] [--wal ARCHIVO]
+//                             [--durabilidad ninguna|lotes|evento]
+//                             [--wal-ms MS] [--wal-eventos N]
+// ============================================================================
+
+#include <iostream>
+#include <string>      // Para std::string y to_string
+#include <string.h>    // Para strlen, strcmp
+#include <stdlib.h>    // Para atoi
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <csignal>     // Para signal (parada ordenada del motor pool)
+
+#include "net_compat.h"
+#include "parking_protocol.h"
+#include "framing.h"
+#include "async_log.h"
+#include "trace_recorder.h"
+#include "wal.h"
+#include "state_actor.h"
+#include "broadcaster.h"
+#include "worker_pool.h"
+#include "server_config.h"
+#ifdef __linux__
+#include "epoll_engine.h"
+#include "uring_engine.h"
+#endif
+
+#define PORT 8080
+#define NUM_SPOTS 40
+
+using namespace std;
+
+// ============================================================================
+// ESTRUCTURA: ClientSession
+// PROPÓSITO: Un cliente de los motores de hilos y pool (el de epoll tiene
+//            su propia Connection)
+// ============================================================================
+struct ClientSession
+{
+	SOCKET socket;
+	SubscriberPtr subscriber;
+	StreamFramer framer;          // Un recv puede traer varios mensajes (o medio)
+	FrameMode knownMode = FRAME_RAW;
+};
+
+// ============================================================================
+// FUNCIÓN: processReceived
+// PROPÓSITO: Atiende los bytes que acaba de recibir la sesión
+// DESCRIPCIÓN: Todos los mensajes que llegan en un mismo recv forman un lote:
+//              se validan sin lock, se aplican tomando solo la zona de
+//              cada plaza y sus respuestas salen en un solo send. Las
+//              actualizaciones para los demás las escribe el hilo de
+//              difusión (ver broadcaster.h): quien llama nunca espera a
+//              otro cliente. batch y output se reutilizan entre llamadas
+// RETORNA: false si hay que cerrar la conexión (mensaje demasiado largo)
+// ============================================================================
+static bool processReceived(ClientSession& session, int received, ParkingBatch& batch, string& output)
+{
+	StreamFramer& framer = session.framer;
+	framer.commit((size_t)received);
+	long long receivedAt = traceClock();
+	if (framer.mode() != session.knownMode)
+	{
+		session.knownMode = framer.mode();
+		setSubscriberMode(session.subscriber, session.knownMode);
+	}
+	FrameMode knownMode = session.knownMode;
+
+	// PARSEAR Y VALIDAR TODOS LOS MENSAJES (sin lock)
+	batch.clear();
+	char* buffer;
+	size_t length;
+	while (framer.next(buffer, length))
+	{
+		traceMessage(session.socket, receivedAt, knownMode == FRAME_BINARY, buffer, length);
+		batch.requests.emplace_back();
+		if (knownMode == FRAME_BINARY)
+		{
+			parseBinaryRequest(buffer, batch.requests.back());
+		}
+		else
+		{
+			parseRequest(buffer, batch.requests.back());
+		}
+	}
+
+	if (!batch.requests.empty())
+	{
+		// APLICAR EL LOTE (y difundir sus cambios a los demás clientes)
+		batch.origin = subscriberId(session.subscriber);
+		applyBatch(batch);
+
+		// ENVIAR TODAS LAS RESPUESTAS EN UN SOLO SEND
+		output.clear();
+		for (size_t i = 0; i < batch.responses.size(); ++i)
+		{
+			if (batch.responses[i] == nullptr)
+			{
+				// SUSCRIBIR: lo anterior sale primero, en orden
+				if (!output.empty())
+				{
+					sendToSubscriber(session.subscriber, output.data(), output.size());
+					output.clear();
+				}
+				subscribeClient(session.subscriber, batch.requests[i].resumeFrom, knownMode);
+				continue;
+			}
+			encodeResponse(knownMode, batch, i, output);
+		}
+		if (!output.empty())
+		{
+			sendToSubscriber(session.subscriber, output.data(), output.size());
+		}
+	}
+
+	if (framer.hasError())
+	{
+		logWarning(session.socket, "envio un mensaje demasiado largo");
+		return false;
+	}
+	return true;
+}
+
+// CLIENTE DESCONECTADO: dejar de difundirle antes de liberar el socket
+static void closeSession(ClientSession& session)
+{
+	logClientDisconnected(session.socket);
+	traceDisconnected(session.socket);
+	removeSubscriber(session.subscriber);
+	closesocket(session.socket);
+}
+
+// ============================================================================
+// FUNCIÓN: handleClient (SE EJECUTA EN UN THREAD SEPARADO PARA CADA CLIENTE)
+// PROPÓSITO: Maneja la comunicación con un cliente específico
+// ============================================================================
+void handleClient(SOCKET clientSocket, SubscriberPtr subscriber)
+{
+	ClientSession session;
+	session.socket = clientSocket;
+	session.subscriber = subscriber;
+	ParkingBatch batch;
+	string output;
+	int valread;
+
+	logClientConnected(clientSocket);
+	traceConnected(clientSocket);
+
+	// BUCLE DE RECEPCIÓN DE MENSAJES
+	while ((valread = recvWait(clientSocket, session.framer.writePtr(), (int)session.framer.writable())) > 0)
+	{
+		if (!processReceived(session, valread, batch, output))
+		{
+			break;
+		}
+	}
+
+	closeSession(session);
+}
+
+// ============================================================================
+// FUNCIÓN: runThreadServer
+// PROPÓSITO: Motor clásico: un thread por cliente conectado
+// ============================================================================
+int runThreadServer(const ServerConfig& config)
+{
+	struct sockaddr_in direccion;
+	socklen_t addrlen = sizeof(direccion);
+
+	SOCKET servidor_fd = createListenSocket(config.port, config.backlog);
+	if (servidor_fd == INVALID_SOCKET)
+	{
+		cerr << "✗ Error al crear el socket de escucha (bind/listen)\n";
+		return 1;
+	}
+
+	cout << "[*] Motor: hilos (un thread por cliente + hilo de difusion)\n";
+	cout << "[*] Esperando conexiones...\n";
+	cout << "========================================================\n\n";
+
+	startBroadcaster();
+
+	// BUCLE PRINCIPAL: ACEPTAR CLIENTES
+	while (true)
+	{
+		SOCKET nuevo_socket = accept(servidor_fd, (struct sockaddr*)&direccion, &addrlen);
+
+		if (nuevo_socket == INVALID_SOCKET)
+		{
+			cerr << "✗ Error en accept\n";
+			continue;
+		}
+
+		setNoDelay(nuevo_socket);
+
+		// REGISTRAR AL CLIENTE EN LA DIFUSIÓN
+		SubscriberPtr subscriber = addSubscriber(nuevo_socket);
+
+		// CREAR UN NUEVO THREAD PARA ESTE CLIENTE
+		thread clientThread(handleClient, nuevo_socket, subscriber);
+
+		// Detach = el thread se ejecuta independientemente
+		clientThread.detach();
+	}
+
+	// LIMPIEZA (nunca se alcanza en este diseño)
+	stopBroadcaster();
+	closesocket(servidor_fd);
+	return 0;
+}
+
+// ============================================================================
+// MOTOR POOL: un grupo fijo de hilos (worker_pool.h) en lugar de un thread
+// por cliente. El hilo principal espera con pollSockets a que algún cliente
+// tenga datos y entrega esa sesión al grupo; mientras un hilo la atiende,
+// la sesión sale del poll, así que nunca la leen dos hilos a la vez. Al
+// terminar, el hilo la devuelve y despierta al poll con el socket de aviso
+// ============================================================================
+
+// Lecturas seguidas de una misma sesión antes de devolverla al poll (para
+// que un cliente muy activo no acapare un hilo)
+#define POOL_READS_PER_TASK 8
+
+// Cada cuánto revisa el poll si se pidió detener el servidor
+#define POOL_POLL_TIMEOUT_MS 200
+
+// SIGINT / SIGTERM: el motor pool deja de aceptar y se detiene en orden
+static atomic<bool> stopRequested(false);
+
+static void requestStop(int)
+{
+	stopRequested.store(true);
+}
+
+// Sesiones que los hilos del grupo ya atendieron y vuelven al poll
+static mutex returnedLock;
+static vector<ClientSession*> returnedSessions;
+static SOCKET wakeSocket = INVALID_SOCKET;
+static atomic<bool> wakePending(false);
+
+static void returnSession(ClientSession* session)
+{
+	{
+		lock_guard<mutex> guard(returnedLock);
+		returnedSessions.push_back(session);
+	}
+	// Un solo aviso hasta que el poll lo atienda
+	if (!wakePending.exchange(true))
+	{
+		send(wakeSocket, "x", 1, SEND_FLAGS);
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: serveSession (TAREA DEL GRUPO)
+// PROPÓSITO: Lee lo que tenga la sesión sin esperar y la devuelve al poll,
+//            o la cierra si el cliente se desconectó
+// ============================================================================
+static void serveSession(void* arg)
+{
+	ClientSession* session = (ClientSession*)arg;
+
+	// Reutilizados por cada hilo del grupo
+	static thread_local ParkingBatch batch;
+	static thread_local string output;
+
+	bool open = true;
+	for (int reads = 0; open && reads < POOL_READS_PER_TASK; ++reads)
+	{
+		int n = (int)recv(session->socket, session->framer.writePtr(), (int)session->framer.writable(), 0);
+		if (n == SOCKET_ERROR && socketWouldBlock())
+		{
+			break;
+		}
+		open = n > 0 && processReceived(*session, n, batch, output);
+	}
+
+	if (!open)
+	{
+		closeSession(*session);
+		delete session;
+		return;
+	}
+	returnSession(session);
+}
+
+// Acepta todas las conexiones pendientes (el socket de escucha no bloquea)
+static void acceptClients(SOCKET listenFd, vector<ClientSession*>& idle)
+{
+	while (true)
+	{
+		SOCKET fd = accept(listenFd, nullptr, nullptr);
+		if (fd == INVALID_SOCKET)
+		{
+			return;
+		}
+		setNoDelay(fd);
+		setNonBlocking(fd);
+
+		ClientSession* session = new ClientSession();
+		session->socket = fd;
+		session->subscriber = addSubscriber(fd);
+		logClientConnected(fd);
+		traceConnected(fd);
+		idle.push_back(session);
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: runPoolServer
+// PROPÓSITO: Motor pool: hilos fijos con robo de trabajo y parada ordenada
+// ============================================================================
+int runPoolServer(const ServerConfig& config)
+{
+	SOCKET listenFd = createListenSocket(config.port, config.backlog);
+	if (listenFd == INVALID_SOCKET)
+	{
+		cerr << "✗ Error al crear el socket de escucha (bind/listen)\n";
+		return 1;
+	}
+	wakeSocket = createWakeSocket();
+	if (wakeSocket == INVALID_SOCKET || !setNonBlocking(listenFd))
+	{
+		cerr << "✗ Error al crear el socket de aviso del poll\n";
+		closesocket(listenFd);
+		return 1;
+	}
+
+	WorkerPool pool(config.workers);
+	cout << "[*] Motor: pool (" << pool.size() << " hilos con robo de trabajo + hilo de difusion)\n";
+	cout << "[*] Esperando conexiones... (Ctrl+C detiene el servidor en orden)\n";
+	cout << "========================================================\n\n";
+
+	startBroadcaster();
+	signal(SIGINT, requestStop);
+	signal(SIGTERM, requestStop);
+
+	vector<ClientSession*> idle;      // Sesiones esperando datos
+	vector<PollEntry> entries;
+	while (!stopRequested.load())
+	{
+		// [0] escucha, [1] aviso, [2..] sesiones
+		entries.resize(idle.size() + 2);
+		entries[0].fd = listenFd;
+		entries[1].fd = wakeSocket;
+		for (size_t i = 0; i < idle.size(); ++i)
+		{
+			entries[i + 2].fd = idle[i]->socket;
+		}
+		for (PollEntry& entry : entries)
+		{
+			entry.events = POLLIN;
+			entry.revents = 0;
+		}
+		if (pollSockets(entries.data(), (unsigned long)entries.size(), POOL_POLL_TIMEOUT_MS) <= 0)
+		{
+			continue;
+		}
+
+		// SESIONES CON DATOS (o cerradas): al grupo
+		size_t kept = 0;
+		for (size_t i = 0; i < idle.size(); ++i)
+		{
+			if (entries[i + 2].revents != 0)
+			{
+				pool.submit({ serveSession, idle[i] });
+			}
+			else
+			{
+				idle[kept++] = idle[i];
+			}
+		}
+		idle.resize(kept);
+
+		// SESIONES DEVUELTAS POR EL GRUPO
+		if (entries[1].revents != 0)
+		{
+			wakePending.store(false);
+			char drain[64];
+			while (recv(wakeSocket, drain, sizeof(drain), 0) > 0)
+			{
+			}
+			lock_guard<mutex> guard(returnedLock);
+			idle.insert(idle.end(), returnedSessions.begin(), returnedSessions.end());
+			returnedSessions.clear();
+		}
+
+		// CLIENTES NUEVOS
+		if (entries[0].revents != 0)
+		{
+			acceptClients(listenFd, idle);
+		}
+	}
+
+	// PARADA ORDENADA: no aceptar más, terminar las tareas en curso (sus
+	// sesiones vuelven a returnedSessions) y cerrar todas las conexiones
+	cout << "\n[*] Deteniendo el servidor...\n";
+	closesocket(listenFd);
+	pool.shutdown();
+	idle.insert(idle.end(), returnedSessions.begin(), returnedSessions.end());
+	returnedSessions.clear();
+	for (ClientSession* session : idle)
+	{
+		closeSession(*session);
+		delete session;
+	}
+	stopBroadcaster();
+	closesocket(wakeSocket);
+	cout << "[*] Servidor detenido: " << pool.executedTasks() << " tareas atendidas ("
+		<< pool.stolenTasks() << " robadas entre hilos)\n";
+	return 0;
+}
+
+// ============================================================================
+// FUNCIÓN: parseArguments
+// PROPÓSITO: Lee las opciones de línea de comandos
+// RETORNA: false si hay una opción desconocida
+// ============================================================================
+bool parseArguments(int argc, char* argv[], ServerConfig& config)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+
+		if (arg == "--motor" && hasValue)
+		{
+			config.engine = argv[++i];
+		}
+		else if (arg == "--trabajadores" && hasValue)
+		{
+			config.workers = atoi(argv[++i]);
+			if (config.workers < 0)
+			{
+				cerr << "Numero de trabajadores invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--bucles" && hasValue)
+		{
+			config.loops = atoi(argv[++i]);
+			if (config.loops < 0)
+			{
+				cerr << "Numero de bucles invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--puerto" && hasValue)
+		{
+			config.port = atoi(argv[++i]);
+		}
+		else if (arg == "--backlog" && hasValue)
+		{
+			config.backlog = atoi(argv[++i]);
+			if (config.backlog < 1)
+			{
+				cerr << "Backlog invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--plazas" && hasValue)
+		{
+			config.numSpots = atoi(argv[++i]);
+			if (config.numSpots < 1 || config.numSpots > MAX_SPOTS)
+			{
+				cerr << "Numero de plazas invalido (1.." << MAX_SPOTS << ")\n";
+				return false;
+			}
+		}
+		else if (arg == "--zonas" && hasValue)
+		{
+			config.zones = atoi(argv[++i]);
+			if (config.zones < 1)
+			{
+				cerr << "Numero de zonas invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--estado" && hasValue)
+		{
+			config.stateMode = argv[++i];
+			if (config.stateMode != "zonas" && config.stateMode != "actor")
+			{
+				cerr << "Modo de estado invalido: " << config.stateMode << " (zonas o actor)\n";
+				return false;
+			}
+		}
+		else if (arg == "--intervalo-estado" && hasValue)
+		{
+			config.statusIntervalMs = atoi(argv[++i]);
+		}
+		else if (arg == "--lentos" && hasValue)
+		{
+			config.slowConsumers = argv[++i];
+			SlowConsumerPolicy policy;
+			if (!parseSlowConsumerPolicy(config.slowConsumers, policy))
+			{
+				cerr << "Politica invalida: " << config.slowConsumers << " (descartar, coalescer o desconectar)\n";
+				return false;
+			}
+		}
+		else if (arg == "--tick-difusion" && hasValue)
+		{
+			config.broadcastTickMs = atoi(argv[++i]);
+			if (config.broadcastTickMs < 0)
+			{
+				cerr << "Tick de difusion invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--cola-difusion" && hasValue)
+		{
+			config.outboundBatches = atoi(argv[++i]);
+			if (config.outboundBatches < 1)
+			{
+				cerr << "Tamano de cola de difusion invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--traza" && hasValue)
+		{
+			config.tracePath = argv[++i];
+		}
+		else if (arg == "--wal" && hasValue)
+		{
+			config.walPath = argv[++i];
+		}
+		else if (arg == "--durabilidad" && hasValue)
+		{
+			config.durability = argv[++i];
+			WalDurability level;
+			if (!parseWalDurability(config.durability, level))
+			{
+				cerr << "Durabilidad invalida: " << config.durability << " (ninguna, lotes o evento)\n";
+				return false;
+			}
+		}
+		else if (arg == "--wal-ms" && hasValue)
+		{
+			config.walIntervalMs = atoi(argv[++i]);
+			if (config.walIntervalMs < 1)
+			{
+				cerr << "Intervalo del WAL invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--wal-eventos" && hasValue)
+		{
+			config.walBatchEvents = atoi(argv[++i]);
+			if (config.walBatchEvents < 1)
+			{
+				cerr << "Numero de eventos del WAL invalido\n";
+				return false;
+			}
+		}
+		else if (arg == "--historial" && hasValue)
+		{
+			config.historySize = atoi(argv[++i]);
+			if (config.historySize < 0)
+			{
+				cerr << "Tamano de historial invalido\n";
+				return false;
+			}
+		}
+		else
+		{
+			cerr << "Opcion desconocida: " << arg << "\n";
+			cerr << "Uso: " << argv[0] << " [--motor hilos|epoll|uring|pool] [--trabajadores N] [--bucles N] [--puerto N] [--backlog N]"
+				<< " [--plazas N] [--zonas N] [--estado zonas|actor] [--intervalo-estado MS]"
+				<< " [--lentos descartar|coalescer|desconectar] [--cola-difusion N]"
+				<< " [--tick-difusion MS] [--historial N] [--traza ARCHIVO]"
+				<< " [--wal ARCHIVO] [--durabilidad ninguna|lotes|evento] [--wal-ms MS] [--wal-eventos N]\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+// ============================================================================
+// FUNCIÓN PRINCIPAL
+// ============================================================================
+int main(int argc, char* argv[])
+{
+	ServerConfig config;
+	config.port = PORT;
+	config.numSpots = NUM_SPOTS;
+
+	if (!parseArguments(argc, argv, config))
+	{
+		return 1;
+	}
+
+	// MOTOR POR DEFECTO: epoll en Linux, pool en el resto
+	if (config.engine.empty())
+	{
+#ifdef __linux__
+		config.engine = "epoll";
+#else
+		config.engine = "pool";
+#endif
+	}
+
+	// INICIALIZAR ARREGLO DE PLAZAS
+	initParkingState(config.numSpots, config.historySize, config.zones);
+
+	// INICIALIZAR WINSOCK
+	if (!initSockets())
+	{
+		cerr << "✗ Error al inicializar Winsock\n";
+		return 1;
+	}
+
+	cout << "\n";
+	cout << "========================================================\n";
+	cout << "  SERVIDOR MULTICLIENTE - PARQUEADERO\n";
+	cout << "========================================================\n";
+	cout << "[OK] Servidor iniciado en puerto " << config.port << " (backlog " << config.backlog << ")\n";
+	cout << "[*] Gestiona " << config.numSpots << " plazas en " << parkingZoneCount() << " zonas\n";
+
+	// WAL: primero se recupera el estado guardado, luego se compacta el
+	// archivo y se siguen añadiendo eventos (ver wal.h)
+	if (!config.walPath.empty())
+	{
+		string error;
+		long long recovered = recoverWal(config.walPath.c_str(), error);
+		WalDurability level = WAL_DURABILITY_BATCHED;
+		parseWalDurability(config.durability, level);
+		if (recovered < 0 || !startWal(config.walPath.c_str(), level, config.walIntervalMs, config.walBatchEvents))
+		{
+			cerr << "✗ No se pudo usar el WAL " << config.walPath;
+			if (!error.empty())
+			{
+				cerr << ": " << error;
+			}
+			cerr << "\n";
+			cleanupSockets();
+			freeParkingState();
+			return 1;
+		}
+		config.numSpots = numSpots.load();
+		if (recovered > 0)
+		{
+			ParkingBatch status;
+			status.requests.emplace_back();
+			char command[] = "ESTADO";
+			parseRequest(command, status.requests.back());
+			applyBatch(status);
+			cout << "[*] WAL: " << recovered << " eventos recuperados (" << status.statusValues[1]
+				<< " vehiculos en " << status.statusValues[0] << " plazas)\n";
+		}
+		cout << "[*] WAL en " << config.walPath << " (durabilidad " << walDurabilityName(level);
+		if (level == WAL_DURABILITY_EVENT)
+		{
+			cout << ": cada lote espera su fsync";
+		}
+		else if (level == WAL_DURABILITY_BATCHED)
+		{
+			cout << ": fsync cada " << config.walIntervalMs << " ms o " << config.walBatchEvents << " eventos";
+		}
+		else
+		{
+			cout << ": sin fsync";
+		}
+		cout << ")\n";
+	}
+	if (config.stateMode == "actor")
+	{
+		// Un solo hilo aplica todos los lotes (ver state_actor.h)
+		startStateActor();
+		cout << "[*] Estado: un solo hilo escritor (actor)\n";
+	}
+	cout << "[*] Soporta MULTIPLES clientes simultaneamente\n";
+	if (config.statusIntervalMs > 0)
+	{
+		cout << "[*] Tabla de estado cada " << config.statusIntervalMs << " ms (si hubo cambios)\n";
+	}
+
+	// El log escribe desde un hilo de fondo: nunca dentro del lock de una zona
+	startAsyncLog(config.statusIntervalMs);
+
+	// Colas de salida por cliente (ver broadcaster.h)
+	SlowConsumerPolicy policy = SLOW_COALESCE;
+	parseSlowConsumerPolicy(config.slowConsumers, policy);
+	configureBroadcast(policy, (size_t)config.outboundBatches, config.broadcastTickMs);
+	cout << "[*] Clientes lentos: " << slowConsumerPolicyName(policy)
+		<< " (cola de " << config.outboundBatches << " lotes)\n";
+	if (config.broadcastTickMs > 0)
+	{
+		cout << "[*] Difusion por ticks de " << config.broadcastTickMs << " ms (tramas DELTA)\n";
+	}
+
+	// Grabación de todos los mensajes recibidos (cliente --reproducir)
+	if (!config.tracePath.empty())
+	{
+		if (!startTraceRecorder(config.tracePath.c_str()))
+		{
+			cerr << "✗ No se pudo abrir el archivo de traza: " << config.tracePath << "\n";
+			stopAsyncLog();
+			cleanupSockets();
+			freeParkingState();
+			return 1;
+		}
+		cout << "[*] Grabando los mensajes recibidos en " << config.tracePath << "\n";
+	}
+
+	int exitCode;
+	if (config.engine == "hilos")
+	{
+		exitCode = runThreadServer(config);
+	}
+	else if (config.engine == "pool")
+	{
+		exitCode = runPoolServer(config);
+	}
+#ifdef __linux__
+	else if (config.engine == "epoll")
+	{
+		exitCode = runEpollServer(config);
+	}
+	else if (config.engine == "uring")
+	{
+		// Si el núcleo no lo admite, sigue con epoll
+		exitCode = runUringServer(config);
+	}
+#endif
+	else
+	{
+		cerr << "✗ Motor no disponible en esta plataforma: " << config.engine << "\n";
+		exitCode = 1;
+	}
+
+	stopStateActor();
+	stopWal();
+	if (!config.walPath.empty())
+	{
+		cout << "[*] WAL: " << walWrittenRecords() << " registros escritos con " << walSyncCount() << " fsync\n";
+	}
+	stopTraceRecorder();
+	stopAsyncLog();
+	cleanupSockets();
+	freeParkingState();
+
+	return exitCode;
+}
@@ -0,0 +1,138 @@
+#include "state_actor.h"
+#include "parking_protocol.h"
+#include "mpsc_queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Comprobaciones (cediendo el procesador) antes de dormir: el hilo del
+// estado mientras la cola está vacía, quien envía mientras espera respuesta
+static const int SPIN_CHECKS = 200;
+
+// Lotes que el hilo del estado aplica seguidos antes de publicar sus
+// eventos y responder
+static const int MAX_DRAIN = 64;
+
+// Slot de respuesta: done pasa a true con el lote ya aplicado
+struct CompletionSlot {
+    atomic<bool> done{false};
+    mutex lock;
+    condition_variable ready;
+};
+
+struct ActorCommand {
+    ParkingBatch* batch;
+    CompletionSlot* slot;
+};
+
+static MpscQueue<ActorCommand>* queue = nullptr;
+static atomic<bool> running(false);
+static thread actorThread;
+
+// El hilo del estado duerme aquí cuando no hay lotes
+static mutex idleLock;
+static condition_variable idleWake;
+static atomic<bool> idle(false);
+
+static thread_local CompletionSlot completionSlot;
+
+// Siempre con el lock del slot: quien espera lo toma antes de volver, así
+// que el slot no desaparece (p. ej. al terminar su hilo) mientras aún se usa
+static void complete(CompletionSlot* slot) {
+    lock_guard<mutex> guard(slot->lock);
+    slot->done.store(true, memory_order_release);
+    slot->ready.notify_one();
+}
+
+// ============================================================================
+// HILO DEL ESTADO: aplica los lotes en el orden de la cola, publica sus
+// eventos (en ese mismo orden, ver publishEvents) y luego responde
+// ============================================================================
+static void actorLoop() {
+    ActorCommand drained[MAX_DRAIN];
+    int emptyChecks = 0;
+
+    while (true) {
+        int count = 0;
+        while (count < MAX_DRAIN && queue->pop(drained[count])) {
+            applyValidatedBatch(*drained[count].batch);
+            count++;
+        }
+        if (count > 0) {
+            publishEvents();
+            for (int i = 0; i < count; ++i) {
+                complete(drained[i].slot);
+            }
+            emptyChecks = 0;
+            continue;
+        }
+        if (!running.load(memory_order_acquire)) break;
+        if (++emptyChecks < SPIN_CHECKS) {
+            this_thread::yield();
+            continue;
+        }
+
+        // Dormir hasta el próximo lote. Quien encola mira "idle" después
+        // de su push y aquí se mira la cola después de marcar "idle": al
+        // menos uno de los dos ve al otro, así que no hace falta plazo
+        unique_lock<mutex> guard(idleLock);
+        idle.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (queue->empty() && running.load(memory_order_acquire)) {
+            idleWake.wait(guard);
+        }
+        idle.store(false, memory_order_relaxed);
+        emptyChecks = 0;
+    }
+}
+
+void startStateActor() {
+    if (running.load()) return;
+    if (queue == nullptr) {
+        queue = new MpscQueue<ActorCommand>(ACTOR_QUEUE_CAPACITY);
+    }
+    running.store(true, memory_order_release);
+    actorThread = thread(actorLoop);
+}
+
+void stopStateActor() {
+    if (!running.exchange(false)) return;
+    {
+        lock_guard<mutex> guard(idleLock);
+        idleWake.notify_one();
+    }
+    actorThread.join();
+}
+
+bool stateActorRunning() {
+    return running.load(memory_order_acquire);
+}
+
+// ============================================================================
+// FUNCIÓN: runOnStateActor
+// ============================================================================
+void runOnStateActor(ParkingBatch& batch) {
+    CompletionSlot& slot = completionSlot;
+    slot.done.store(false, memory_order_relaxed);
+
+    ActorCommand command = { &batch, &slot };
+    while (!queue->push(command)) {
+        this_thread::yield();
+    }
+
+    // Despertar al hilo del estado si se durmió (ver actorLoop)
+    atomic_thread_fence(memory_order_seq_cst);
+    if (idle.load(memory_order_relaxed)) {
+        lock_guard<mutex> guard(idleLock);
+        idleWake.notify_one();
+    }
+
+    for (int i = 0; i < SPIN_CHECKS && !slot.done.load(memory_order_acquire); ++i) {
+        this_thread::yield();
+    }
+    unique_lock<mutex> guard(slot.lock);
+    slot.ready.wait(guard, [&slot] { return slot.done.load(memory_order_acquire); });
+}
@@ -0,0 +1,45 @@
+// ============================================================================
+// ARCHIVO: state_actor.h
+// PROPÓSITO: Modo "--estado actor": un único hilo escribe el estado del
+//            parqueadero y los demás le envían sus lotes
+// DESCRIPCIÓN: Con muchos clientes escribiendo a la vez, los hilos se
+//              encolan en los locks de las zonas (un convoy: cada uno que
+//              suelta el lock despierta al siguiente). En este modo cada
+//              hilo valida su lote sin locks, lo deja en una cola sin locks
+//              (mpsc_queue.h) y espera en su propio slot de respuesta; el
+//              hilo del estado saca todos los lotes pendientes, los aplica
+//              seguidos y publica sus eventos antes de responder. Solo un
+//              hilo modifica las plazas y publica, así que el orden de los
+//              eventos (del log y de la difusión) es el orden de la cola.
+//
+// SLOT DE RESPUESTA: Uno por hilo que envía (thread_local). En el motor de
+//   hilos es uno por conexión; en los motores epoll y uring, uno por bucle
+//   (--bucles).
+// ============================================================================
+
+#ifndef STATE_ACTOR_H
+#define STATE_ACTOR_H
+
+struct ParkingBatch;
+
+// Lotes que pueden esperar en la cola (si se llena, quien envía cede el
+// procesador y reintenta)
+#define ACTOR_QUEUE_CAPACITY 1024
+
+// Arranca el hilo del estado. Desde ese momento applyBatch (ver
+// parking_protocol.h) pasa por él
+void startStateActor();
+
+// Aplica lo pendiente y detiene el hilo
+void stopStateActor();
+
+bool stateActorRunning();
+
+// ============================================================================
+// FUNCIÓN: runOnStateActor
+// PROPÓSITO: Encola un lote ya validado y espera a que el hilo del estado
+//            lo aplique (con applyValidatedBatch) y publique sus eventos
+// ============================================================================
+void runOnStateActor(ParkingBatch& batch);
+
+#endif
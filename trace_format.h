@@ -0,0 +1,101 @@
+// ============================================================================
+// ARCHIVO: trace_format.h
+// PROPÓSITO: Formato del archivo de traza (grabación de los mensajes que
+//            recibe el servidor)
+// DESCRIPCIÓN: Lo escribe el servidor con --traza (trace_recorder.h) y lo
+//              lee cliente --reproducir (trace_replay.h). Guarda cada
+//              mensaje tal como lo entregó StreamFramer, sin delimitador,
+//              con la hora de recepción en nanosegundos, además de las
+//              conexiones y desconexiones de cada cliente.
+//
+// FORMATO (little-endian):
+//   Cabecera (16 bytes): "PKTRACE1" + hora de inicio (i64, segundos desde
+//                        1970, solo informativa)
+//   Registro (16 bytes + payload):
+//     bytes 0-7    time        ns desde el inicio de la grabación
+//     bytes 8-11   connection  Identificador de la conexión (su socket)
+//     byte  12     kind        TraceKind
+//     byte  13     length      Bytes de payload (0..TRACE_MAX_PAYLOAD)
+//     bytes 14-15  reservado   0
+//     bytes 16-    payload     El mensaje
+//
+// Un mensaje de texto de más de TRACE_MAX_PAYLOAD bytes no es válido en el
+// protocolo: se guarda recortado (el servidor también lo rechaza).
+// ============================================================================
+
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TRACE_MAGIC "PKTRACE1"
+#define TRACE_HEADER_SIZE 16
+#define TRACE_RECORD_HEADER_SIZE 16
+#define TRACE_MAX_PAYLOAD 48
+
+enum TraceKind {
+    TRACE_CONNECT = 1,
+    TRACE_DISCONNECT = 2,
+    TRACE_TEXT = 3,        // Se reproduce como una línea terminada en '\n'
+    TRACE_BINARY = 4       // Mensaje de binary_protocol.h (incluido el HELLO)
+};
+
+struct TraceRecord {
+    int64_t time;
+    uint32_t connection;
+    uint8_t kind;
+    uint8_t length;
+    char payload[TRACE_MAX_PAYLOAD];
+};
+
+inline void writeTraceInt(char* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out[i] = (char)(value >> (8 * i));
+}
+
+inline uint64_t readTraceInt(const char* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint64_t)(unsigned char)in[i] << (8 * i);
+    return value;
+}
+
+inline void encodeTraceHeader(int64_t startSeconds, char* out) {
+    memcpy(out, TRACE_MAGIC, 8);
+    writeTraceInt(out + 8, (uint64_t)startSeconds, 8);
+}
+
+inline bool decodeTraceHeader(const char* in, int64_t& startSeconds) {
+    if (memcmp(in, TRACE_MAGIC, 8) != 0) return false;
+    startSeconds = (int64_t)readTraceInt(in + 8, 8);
+    return true;
+}
+
+// Retorna los bytes escritos en out (al menos TRACE_RECORD_HEADER_SIZE +
+// TRACE_MAX_PAYLOAD de espacio)
+inline size_t encodeTraceRecord(const TraceRecord& record, char* out) {
+    writeTraceInt(out, (uint64_t)record.time, 8);
+    writeTraceInt(out + 8, record.connection, 4);
+    out[12] = (char)record.kind;
+    out[13] = (char)record.length;
+    out[14] = 0;
+    out[15] = 0;
+    memcpy(out + TRACE_RECORD_HEADER_SIZE, record.payload, record.length);
+    return TRACE_RECORD_HEADER_SIZE + record.length;
+}
+
+// Retorna los bytes consumidos, o 0 si "available" no alcanza para un
+// registro completo o el registro no es válido
+inline size_t decodeTraceRecord(const char* in, size_t available, TraceRecord& record) {
+    if (available < TRACE_RECORD_HEADER_SIZE) return 0;
+    record.time = (int64_t)readTraceInt(in, 8);
+    record.connection = (uint32_t)readTraceInt(in + 8, 4);
+    record.kind = (uint8_t)in[12];
+    record.length = (uint8_t)in[13];
+    if (record.length > TRACE_MAX_PAYLOAD || record.kind < TRACE_CONNECT || record.kind > TRACE_BINARY) return 0;
+    if (available < (size_t)TRACE_RECORD_HEADER_SIZE + record.length) return 0;
+    memcpy(record.payload, in + TRACE_RECORD_HEADER_SIZE, record.length);
+    return TRACE_RECORD_HEADER_SIZE + record.length;
+}
+
+#endif
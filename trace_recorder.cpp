@@ -0,0 +1,122 @@
+#include "trace_recorder.h"
+#include "trace_format.h"
+#include "mpsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <stdio.h>
+
+using namespace std;
+
+// Bloque que el hilo de fondo acumula antes de cada fwrite
+static const size_t WRITE_CHUNK = 256 * 1024;
+
+static MpscQueue<TraceRecord>* queue = nullptr;
+static atomic<bool> running(false);
+static atomic<unsigned long long> dropped(0);
+static thread writerThread;
+static FILE* file = nullptr;
+static chrono::steady_clock::time_point startTime;
+
+long long traceClock() {
+    if (!running.load(memory_order_relaxed)) return 0;
+    return (long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count();
+}
+
+static void enqueue(long long connection, long long time, uint8_t kind, const char* data, size_t length) {
+    if (!running.load(memory_order_relaxed)) return;
+    TraceRecord record;
+    record.time = time;
+    record.connection = (uint32_t)connection;
+    record.kind = kind;
+    record.length = (uint8_t)(length < TRACE_MAX_PAYLOAD ? length : TRACE_MAX_PAYLOAD);
+    memcpy(record.payload, data, record.length);
+    if (!queue->push(record)) {
+        dropped.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+void traceConnected(long long connection) {
+    enqueue(connection, traceClock(), TRACE_CONNECT, nullptr, 0);
+}
+
+void traceDisconnected(long long connection) {
+    enqueue(connection, traceClock(), TRACE_DISCONNECT, nullptr, 0);
+}
+
+void traceMessage(long long connection, long long receivedAt, bool binary, const char* data, size_t length) {
+    enqueue(connection, receivedAt, binary ? TRACE_BINARY : TRACE_TEXT, data, length);
+}
+
+unsigned long long droppedTraceRecords() {
+    return dropped.load(memory_order_relaxed);
+}
+
+// ============================================================================
+// HILO DE FONDO: codifica los registros y los escribe por bloques
+// ============================================================================
+static void writerLoop() {
+    string out;
+    out.reserve(WRITE_CHUNK + TRACE_RECORD_HEADER_SIZE + TRACE_MAX_PAYLOAD);
+    char encoded[TRACE_RECORD_HEADER_SIZE + TRACE_MAX_PAYLOAD];
+    TraceRecord record;
+
+    while (true) {
+        bool stopping = !running.load(memory_order_acquire);
+
+        bool wrote = false;
+        while (queue->pop(record)) {
+            out.append(encoded, encodeTraceRecord(record, encoded));
+            if (out.size() >= WRITE_CHUNK) {
+                fwrite(out.data(), 1, out.size(), file);
+                out.clear();
+                wrote = true;
+            }
+        }
+        if (!out.empty()) {
+            fwrite(out.data(), 1, out.size(), file);
+            out.clear();
+            wrote = true;
+        }
+
+        // Con la cola vacía todo lo recibido queda en el archivo: si el
+        // servidor se cierra de golpe solo se pierden los últimos ms
+        if (wrote) fflush(file);
+
+        if (stopping) break;
+        this_thread::sleep_for(chrono::milliseconds(2));
+    }
+}
+
+bool startTraceRecorder(const char* path) {
+    if (running.load()) return true;
+    file = fopen(path, "wb");
+    if (file == nullptr) return false;
+
+    char header[TRACE_HEADER_SIZE];
+    encodeTraceHeader((int64_t)time(nullptr), header);
+    fwrite(header, 1, sizeof(header), file);
+
+    if (queue == nullptr) {
+        queue = new MpscQueue<TraceRecord>(TRACE_QUEUE_CAPACITY);
+    }
+    startTime = chrono::steady_clock::now();
+    running.store(true, memory_order_release);
+    writerThread = thread(writerLoop);
+    return true;
+}
+
+void stopTraceRecorder() {
+    if (!running.exchange(false)) return;
+    writerThread.join();
+    fclose(file);
+    file = nullptr;
+
+    unsigned long long lost = dropped.load();
+    if (lost > 0) {
+        cerr << "⚠ Traza incompleta: " << lost << " mensajes descartados\n";
+    }
+}
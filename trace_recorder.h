@@ -0,0 +1,44 @@
+// ============================================================================
+// ARCHIVO: trace_recorder.h
+// PROPÓSITO: Grabar en un archivo todos los mensajes que recibe el servidor
+// DESCRIPCIÓN: Con --traza ARCHIVO, cada mensaje que entrega StreamFramer
+//              se guarda con la hora de recepción (reloj monotónico, en ns)
+//              para reproducirlo después con cliente --reproducir. Igual que
+//              async_log.h, los hilos del servidor solo copian un registro
+//              de tamaño fijo a una cola sin locks; un hilo de fondo los
+//              codifica (trace_format.h) y los escribe por bloques.
+//              Sin --traza, cada llamada es una sola lectura atómica.
+// ============================================================================
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <stddef.h>
+
+// Capacidad de la cola de registros (si se llena, los registros se
+// descartan y se cuentan; el servidor nunca espera al disco)
+#define TRACE_QUEUE_CAPACITY 65536
+
+// Abre (y trunca) el archivo y arranca el hilo de fondo.
+// RETORNA: false si no se pudo abrir el archivo
+bool startTraceRecorder(const char* path);
+
+// Escribe lo pendiente y cierra el archivo
+void stopTraceRecorder();
+
+// ============================================================================
+// FUNCIONES DEL CAMINO CRÍTICO: no bloquean ni reservan memoria
+// ============================================================================
+
+// ns desde el inicio de la grabación (0 si no se está grabando). Se toma
+// una vez por recv y se pasa a traceMessage para todos sus mensajes
+long long traceClock();
+
+void traceConnected(long long connection);
+void traceDisconnected(long long connection);
+void traceMessage(long long connection, long long receivedAt, bool binary, const char* data, size_t length);
+
+// Registros descartados porque la cola estaba llena
+unsigned long long droppedTraceRecords();
+
+#endif
@@ -0,0 +1,361 @@
+#include "trace_replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <string.h>
+
+#include "latency_histogram.h"
+#include "load_generator.h"
+#include "net_compat.h"
+#include "trace_format.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Tiempo máximo para recibir las respuestas pendientes al terminar
+static const std::chrono::seconds DRAIN_TIMEOUT(2);
+
+// Espera máxima de poll: así se revisan también las conexiones que
+// esperan respuestas a velocidad máxima
+static const int MAX_POLL_MS = 100;
+
+namespace {
+
+struct ReplayStats {
+    LatencyHistogram latency;
+    uint64_t sent = 0;
+    uint64_t replies = 0;
+    uint64_t errors = 0;
+    uint64_t broadcasts = 0;
+    uint64_t unanswered = 0;
+    uint64_t failedConnections = 0;
+};
+
+// Una conexión grabada: desde su TRACE_CONNECT hasta su TRACE_DISCONNECT
+struct Session {
+    std::vector<TraceRecord> events;
+    size_t cursor = 0;
+    SOCKET fd = INVALID_SOCKET;
+    bool binary = false;
+    std::deque<Clock::time_point> pending;   // Instante previsto de cada solicitud
+    ReplyReader replies;
+    std::string out;
+};
+
+// SUSCRIBIR no tiene respuesta OK/ERROR (responde con el snapshot)
+bool expectsReply(const TraceRecord& record) {
+    if (record.kind == TRACE_BINARY) return true;
+    return !(record.length >= 9 && memcmp(record.payload, "SUSCRIBIR", 9) == 0);
+}
+
+// Lee la traza y agrupa los registros por conexión
+bool loadTrace(const std::string& path, std::vector<std::unique_ptr<Session> >& sessions,
+               int64_t& duration, uint64_t& messages) {
+    std::ifstream input(path.c_str(), std::ios::binary);
+    if (!input) {
+        std::cerr << "No se pudo abrir la traza: " << path << "\n";
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    int64_t startSeconds;
+    if (data.size() < TRACE_HEADER_SIZE || !decodeTraceHeader(data.data(), startSeconds)) {
+        std::cerr << "El archivo no es una traza del servidor: " << path << "\n";
+        return false;
+    }
+
+    std::unordered_map<uint32_t, Session*> open;
+    size_t offset = TRACE_HEADER_SIZE;
+    duration = 0;
+    messages = 0;
+    while (offset < data.size()) {
+        TraceRecord record;
+        size_t used = decodeTraceRecord(data.data() + offset, data.size() - offset, record);
+        if (used == 0) {
+            // Lo normal es un último registro a medio escribir
+            std::cerr << "Traza truncada en el byte " << offset << ": se reproduce lo anterior\n";
+            break;
+        }
+        offset += used;
+        if (record.time > duration) duration = record.time;
+
+        auto found = open.find(record.connection);
+        Session* session = found == open.end() ? nullptr : found->second;
+        if (record.kind == TRACE_DISCONNECT) {
+            if (session == nullptr) continue;
+            session->events.push_back(record);
+            open.erase(found);
+            continue;
+        }
+
+        // Una conexión abierta antes de empezar a grabar se abre con su
+        // primer mensaje
+        if (record.kind == TRACE_CONNECT || session == nullptr) {
+            sessions.emplace_back(new Session());
+            session = sessions.back().get();
+            open[record.connection] = session;
+            TraceRecord connect = record;
+            connect.kind = TRACE_CONNECT;
+            connect.length = 0;
+            session->events.push_back(connect);
+            if (record.kind == TRACE_CONNECT) continue;
+        }
+        session->events.push_back(record);
+        if (record.kind == TRACE_BINARY) session->binary = true;
+        messages++;
+    }
+
+    for (std::unique_ptr<Session>& session : sessions) {
+        session->replies.setBinary(session->binary);
+    }
+    return true;
+}
+
+class ReplayWorker {
+public:
+    ReplayWorker(const ReplayConfig& config, std::vector<Session*> sessions, ReplayStats& stats)
+        : config(config), sessions(sessions), stats(stats) {}
+
+    void run(Clock::time_point start) {
+        std::this_thread::sleep_until(start);
+        bool dispatched = false;
+        Clock::time_point drainLimit = Clock::time_point::max();
+        std::vector<PollEntry> entries;
+        std::vector<Session*> polled;
+
+        while (true) {
+            Clock::time_point now = Clock::now();
+            Clock::time_point wakeUp = now + std::chrono::milliseconds(MAX_POLL_MS);
+            bool remaining = false;
+            bool waiting = false;
+
+            // ENVIAR lo que ya debió salir en cada conexión
+            for (Session* session : sessions) {
+                dispatch(*session, start, now, wakeUp);
+                if (session->cursor < session->events.size()) remaining = true;
+                if (session->fd != INVALID_SOCKET && !session->pending.empty()) waiting = true;
+            }
+
+            if (!remaining && !dispatched) {
+                dispatched = true;
+                drainLimit = now + DRAIN_TIMEOUT;
+            }
+            if (!remaining && (!waiting || now >= drainLimit)) break;
+
+            // ESPERAR respuestas (y difusiones) hasta el próximo envío
+            entries.clear();
+            polled.clear();
+            for (Session* session : sessions) {
+                if (session->fd == INVALID_SOCKET) continue;
+                PollEntry entry;
+                entry.fd = session->fd;
+                entry.events = POLLIN;
+                entry.revents = 0;
+                entries.push_back(entry);
+                polled.push_back(session);
+            }
+            int timeoutMs = 0;
+            if (wakeUp > now) {
+                long long waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeUp - now).count();
+                timeoutMs = (int)((waitNs + 999999) / 1000000);
+            }
+            if (entries.empty()) {
+                std::this_thread::sleep_until(wakeUp);
+                continue;
+            }
+            if (pollSockets(entries.data(), (unsigned long)entries.size(), timeoutMs) <= 0) continue;
+
+            char buffer[16384];
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (entries[i].revents == 0) continue;
+                Session& session = *polled[i];
+                int received = (int)recv(session.fd, buffer, sizeof(buffer), 0);
+                if (received <= 0) {
+                    closeSession(session);
+                    continue;
+                }
+                consume(session, buffer, received);
+            }
+        }
+
+        for (Session* session : sessions) closeSession(*session);
+    }
+
+private:
+    const ReplayConfig& config;
+    std::vector<Session*> sessions;
+    ReplayStats& stats;
+
+    void dispatch(Session& session, Clock::time_point start, Clock::time_point now, Clock::time_point& wakeUp) {
+        while (session.cursor < session.events.size()) {
+            const TraceRecord& record = session.events[session.cursor];
+            Clock::time_point due = now;
+            if (config.speed > 0) {
+                due = start + std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::nanoseconds((long long)(record.time / config.speed)));
+                if (due > now) {
+                    if (due < wakeUp) wakeUp = due;
+                    break;
+                }
+            } else if (record.kind >= TRACE_TEXT && (int)session.pending.size() >= config.depth) {
+                break;
+            }
+            // El cliente original cerró después de recibir sus respuestas:
+            // se esperan (como mucho DRAIN_TIMEOUT) antes de cerrar
+            if (record.kind == TRACE_DISCONNECT && session.fd != INVALID_SOCKET && !session.pending.empty()
+                && now - session.pending.back() < DRAIN_TIMEOUT) {
+                break;
+            }
+            session.cursor++;
+
+            if (record.kind == TRACE_CONNECT) {
+                session.fd = connectSocket(config.host.c_str(), config.port);
+                if (session.fd == INVALID_SOCKET) {
+                    stats.failedConnections++;
+                    session.cursor = session.events.size();
+                }
+                continue;
+            }
+            if (session.fd == INVALID_SOCKET) continue;
+            if (record.kind == TRACE_DISCONNECT) {
+                flush(session);
+                closeSession(session);
+                continue;
+            }
+
+            session.out.append(record.payload, record.length);
+            if (record.kind == TRACE_TEXT) session.out += '\n';
+            stats.sent++;
+            if (expectsReply(record)) session.pending.push_back(due);
+        }
+        flush(session);
+    }
+
+    void flush(Session& session) {
+        size_t offset = 0;
+        while (session.fd != INVALID_SOCKET && offset < session.out.size()) {
+            int n = (int)send(session.fd, session.out.data() + offset, (int)(session.out.size() - offset), SEND_FLAGS);
+            if (n == SOCKET_ERROR) {
+                if (socketWouldBlock()) continue;
+                closeSession(session);
+                break;
+            }
+            offset += (size_t)n;
+        }
+        session.out.clear();
+    }
+
+    void consume(Session& session, const char* data, int length) {
+        session.replies.append(data, (size_t)length);
+        bool reply, error;
+        while (session.replies.next(reply, error)) {
+            if (!reply) {
+                stats.broadcasts++;
+                continue;
+            }
+            if (session.pending.empty()) continue;
+            Clock::time_point intended = session.pending.front();
+            session.pending.pop_front();
+            stats.latency.record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - intended).count());
+            stats.replies++;
+            if (error) stats.errors++;
+        }
+    }
+
+    void closeSession(Session& session) {
+        if (session.fd == INVALID_SOCKET) return;
+        closesocket(session.fd);
+        session.fd = INVALID_SOCKET;
+        stats.unanswered += session.pending.size();
+        session.pending.clear();
+    }
+};
+
+} // namespace
+
+int runTraceReplay(const ReplayConfig& config) {
+    if (config.speed < 0 || config.depth < 1 || config.threads < 0) {
+        std::cerr << "Parametros de reproduccion invalidos\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Session> > sessions;
+    int64_t duration = 0;
+    uint64_t messages = 0;
+    if (!loadTrace(config.path, sessions, duration, messages)) return 1;
+    if (sessions.empty()) {
+        std::cerr << "La traza no tiene mensajes\n";
+        return 1;
+    }
+
+    // Cada hilo atiende las conexiones i, i + hilos, i + 2 * hilos...
+    int threadCount = config.threads > 0 ? config.threads : (int)std::min<size_t>(sessions.size(), 8);
+    std::vector<ReplayStats> stats((size_t)threadCount);
+    std::vector<std::unique_ptr<ReplayWorker> > workers;
+    for (int t = 0; t < threadCount; t++) {
+        std::vector<Session*> mine;
+        for (size_t i = (size_t)t; i < sessions.size(); i += (size_t)threadCount) {
+            mine.push_back(sessions[i].get());
+        }
+        workers.emplace_back(new ReplayWorker(config, mine, stats[(size_t)t]));
+    }
+
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(50);
+    for (std::unique_ptr<ReplayWorker>& worker : workers) {
+        ReplayWorker* replay = worker.get();
+        threads.emplace_back([replay, start]() { replay->run(start); });
+    }
+    for (std::thread& thread : threads) thread.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    ReplayStats total;
+    for (const ReplayStats& s : stats) {
+        total.latency.merge(s.latency);
+        total.sent += s.sent;
+        total.replies += s.replies;
+        total.errors += s.errors;
+        total.broadcasts += s.broadcasts;
+        total.unanswered += s.unanswered;
+        total.failedConnections += s.failedConnections;
+    }
+
+    double recorded = duration / 1e9;
+    std::cout << "\n================================================\n";
+    std::cout << "  REPRODUCCION DE TRAZA\n";
+    std::cout << "================================================\n";
+    std::cout << "  Archivo: " << config.path << "\n";
+    std::cout << "  Conexiones: " << sessions.size() << " | Mensajes: " << messages
+              << " | Duracion grabada: " << std::fixed << std::setprecision(2) << recorded << " s\n";
+    std::cout << "  Velocidad: ";
+    if (config.speed > 0) {
+        std::cout << std::defaultfloat << config.speed << "x" << std::fixed;
+    } else {
+        std::cout << "maxima (profundidad " << config.depth << ")";
+    }
+    std::cout << " | Hilos: " << threadCount << "\n\n";
+    std::cout << "  Enviados:     " << total.sent << "\n";
+    std::cout << "  Respuestas:   " << total.replies << " (" << total.errors << " errores)\n";
+    std::cout << "  Sin respuesta: " << total.unanswered << "\n";
+    std::cout << "  Difusiones:   " << total.broadcasts << "\n";
+    if (total.failedConnections > 0) {
+        std::cout << "  Conexiones fallidas: " << total.failedConnections << "\n";
+    }
+    std::cout << "  Duracion:     " << std::setprecision(2) << elapsed << " s";
+    if (elapsed > 0 && recorded > 0) {
+        std::cout << " (" << std::setprecision(1) << recorded / elapsed << "x la grabacion)";
+    }
+    std::cout << "\n  Throughput:   " << std::setprecision(1) << (elapsed > 0 ? total.replies / elapsed : 0.0)
+              << " respuestas/s\n\n";
+    std::cout << "  Latencia desde el envio previsto:\n";
+    printLatencyReport(total.latency);
+    std::cout << "\n";
+    return total.failedConnections > 0 ? 1 : 0;
+}
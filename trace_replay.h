@@ -0,0 +1,38 @@
+// ============================================================================
+// ARCHIVO: trace_replay.h
+// PROPÓSITO: Reproducir contra el servidor una traza grabada con --traza
+//            (modo --reproducir de cliente.cpp)
+// DESCRIPCIÓN: Cada conexión grabada se reproduce en su propia conexión:
+//              se abre y se cierra cuando lo hizo la original y sus
+//              mensajes salen en el mismo orden, a la hora de recepción
+//              grabada dividida por la velocidad. Los mensajes de texto se
+//              envían como líneas (aunque el cliente original usara prefijo
+//              de longitud) y los binarios tal cual, HELLO incluido.
+//              Las conexiones se reparten entre varios hilos; cada hilo
+//              atiende las suyas con pollSockets().
+//
+// MEDICIÓN: Como en load_generator.h, la latencia de cada solicitud se mide
+//   desde el instante en que debía salir según la traza. Con velocidad
+//   máxima (0) no hay calendario: se envía en cuanto hay hueco (hasta
+//   "depth" solicitudes sin respuesta por conexión) y la latencia se mide
+//   desde el envío real.
+// ============================================================================
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <string>
+
+struct ReplayConfig {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    std::string path;     // Archivo de traza
+    double speed = 1.0;   // 1 = tiempo real, N = N veces más rápido, 0 = máxima
+    int threads = 0;      // Hilos de envío (0 = uno por conexión, hasta 8)
+    int depth = 64;       // Solicitudes en vuelo por conexión a velocidad máxima
+};
+
+// Reproduce la traza e imprime el informe. Retorna el código de salida
+int runTraceReplay(const ReplayConfig& config);
+
+#endif
@@ -0,0 +1,1217 @@
+// ============================================================================
+// ARCHIVO: uring_engine.cpp
+// PROPÓSITO: Bucle io_uring para el servidor de parqueadero
+// DESCRIPCIÓN: accept y recv multishot, buffers de lectura elegidos por el
+//              núcleo y un send agrupado por conexión. Habla el mismo
+//              protocolo "PLAZA:PLACA:TIMESTAMP" que handleClient (ver
+//              parking_protocol.cpp) y el motor epoll. Con --bucles N hay
+//              N bucles, cada uno con su anillo, su hilo y su socket de
+//              escucha (ver loop_inbox.h)
+// ============================================================================
+
+#include "uring_engine.h"
+#include "epoll_engine.h"
+#include "parking_protocol.h"
+#include "framing.h"
+#include "async_log.h"
+#include "trace_recorder.h"
+#include "broadcaster.h"
+#include "loop_inbox.h"
+#include "net_compat.h"
+#include "wal.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <stddef.h>    // Para offsetof
+#include <string.h>    // Para memset, memcpy, strerror
+#include <vector>
+#include <unordered_map>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+using namespace std;
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#define __NR_io_uring_enter 426
+#define __NR_io_uring_register 427
+#endif
+
+// Entradas de la cola de envío; la de terminación es mayor porque cada
+// recv multishot puede dejar varios resultados por vuelta
+#define URING_ENTRIES 1024
+#define URING_CQ_ENTRIES 16384
+
+// Anillo de buffers de lectura (la cantidad debe ser potencia de 2)
+#define URING_BUFFER_GROUP 0
+#define URING_BUFFER_COUNT 1024
+#define URING_BUFFER_SIZE 4096
+
+// El núcleo lee la entrada i en el byte 16*i y tail en el byte 14 (ver
+// recycleBuffer)
+static_assert(sizeof(io_uring_buf) == 16, "io_uring_buf debe medir 16 bytes");
+static_assert(offsetof(io_uring_buf_ring, tail) == 14, "tail debe estar en el byte 14");
+
+// Máximo de bytes pendientes agrupados en un send
+#define URING_SEND_CHUNK (64 * 1024)
+
+// Con más salida pendiente que esto se deja de leer a la conexión (ver
+// pauseRecv); se vuelve a leer cuando baja a la mitad
+#define URING_PAUSE_OUTPUT (MAX_PENDING_OUTPUT / 4)
+
+// Tipo de operación en los 3 bits bajos de user_data (el resto es el
+// puntero a la conexión, alineado a 8)
+enum UringOp {
+	OP_ACCEPT = 1,
+	OP_RECV = 2,
+	OP_SEND = 3,
+	OP_TICK = 4,
+	OP_CANCEL = 5,
+	OP_PROBE = 6,
+	OP_INBOX = 7
+};
+#define OP_MASK 7ull
+
+// ============================================================================
+// ESTRUCTURA: UringConnection
+// PROPÓSITO: Estado de un cliente del bucle io_uring
+// ============================================================================
+struct alignas(8) UringConnection {
+	SOCKET fd;
+	unsigned long long id;      // Origen de sus lotes (newConnectionId)
+	StreamFramer framer;        // Buffer de lectura y separación de mensajes
+	OutboundQueue outbound;     // Respuestas y difusiones pendientes de enviar
+	string held;                // Respuestas que esperan su fsync (--durabilidad evento)
+	unsigned long long heldSequence;    // Evento que debe estar en disco (0 = nada retenido)
+	string sending;             // Bytes del send en curso (fijos hasta su resultado)
+	size_t sent;                // Bytes de sending ya enviados
+	string stalled;             // Recibido mientras la lectura está en pausa
+	bool recvArmed;             // Hay un recv multishot activo
+	bool recvPaused;            // No se lee hasta que baje la salida pendiente
+	bool sendInFlight;          // Hay un send sin resultado
+	bool sendScheduled;         // Ya está en la lista de envíos de esta vuelta
+	bool closed;                // Cerrado, se libera al terminar sus operaciones
+};
+
+static int ringSetup(unsigned entries, io_uring_params* params)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int ringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static int ringRegister(int fd, unsigned opcode, void* arg, unsigned count)
+{
+	return (int)syscall(__NR_io_uring_register, fd, opcode, arg, count);
+}
+
+// ============================================================================
+// CLASE: UringLoop
+// PROPÓSITO: Un anillo io_uring con su anillo de buffers y sus conexiones
+// ============================================================================
+class UringLoop {
+private:
+	int ringFd;
+	SOCKET listenFd;
+
+	// Colas compartidas con el núcleo (mmap)
+	void* ringMemory;
+	size_t ringSize;
+	io_uring_sqe* sqes;
+	size_t sqesSize;
+	unsigned* sqHead;
+	unsigned* sqTail;
+	unsigned sqMask;
+	unsigned sqEntries;
+	unsigned sqLocalTail;       // SQE preparadas, publicadas al llamar al núcleo
+	unsigned* cqHead;
+	unsigned* cqTail;
+	unsigned cqMask;
+	io_uring_cqe* cqes;
+
+	// Anillo de buffers de lectura (IORING_REGISTER_PBUF_RING)
+	io_uring_buf_ring* bufferRing;
+	size_t bufferRingSize;
+	char* buffers;
+	unsigned short bufferTail;
+	bool bufferRingRegistered;
+
+	unordered_map<SOCKET, UringConnection*> connections;
+	vector<UringConnection*> toSend;
+	vector<UringConnection*> toDelete;
+
+	// Reutilizados entre lecturas (el bucle es de un solo hilo)
+	ParkingBatch batch;
+	string output;
+	vector<UringConnection*> targets;
+
+	// Conexiones con respuestas retenidas hasta su fsync
+	vector<UringConnection*> holding;
+
+	int tickMs;
+	struct __kernel_timespec nextTick;
+
+	// Difusiones publicadas por cualquier bucle, incluido este (el bucle 0
+	// además lleva los ticks)
+	size_t index;
+	const vector<LoopInbox*>* inboxes;
+	LoopInbox inbox;
+	vector<PayloadPtr> received;
+	uint64_t inboxCount;
+
+	// SIGUIENTE SQE LIBRE. Si la cola está llena se envía lo preparado
+	io_uring_sqe* getSqe(unsigned long long userData)
+	{
+		while (sqLocalTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+		{
+			submit(0);
+		}
+		io_uring_sqe* sqe = &sqes[sqLocalTail & sqMask];
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->user_data = userData;
+		sqLocalTail++;
+		return sqe;
+	}
+
+	// Publica las SQE preparadas y espera al menos minComplete resultados
+	// RETORNA: false si io_uring_enter falla
+	bool submit(unsigned minComplete)
+	{
+		__atomic_store_n(sqTail, sqLocalTail, __ATOMIC_RELEASE);
+		unsigned pending = sqLocalTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+		unsigned flags = (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0;
+		while (ringEnter(ringFd, pending, minComplete, flags) < 0)
+		{
+			// EBUSY: la CQ está llena, hay que vaciarla antes de seguir
+			if (errno == EBUSY && minComplete > 0)
+			{
+				return true;
+			}
+			if (errno != EINTR && errno != EAGAIN)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Devuelve un buffer al anillo para que el núcleo lo vuelva a usar.
+	// Las entradas empiezan en el byte 0 del anillo (tail ocupa los bytes
+	// 14-15 de la primera): no se usa bufferRing->bufs, que en C++ con
+	// __DECLARE_FLEX_ARRAY de algunas cabeceras queda en el byte 8
+	void recycleBuffer(unsigned short bid)
+	{
+		io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(bufferRing) + (bufferTail & (URING_BUFFER_COUNT - 1));
+		buf->addr = (unsigned long long)(buffers + (size_t)bid * URING_BUFFER_SIZE);
+		buf->len = URING_BUFFER_SIZE;
+		buf->bid = bid;
+		bufferTail++;
+		__atomic_store_n(&bufferRing->tail, bufferTail, __ATOMIC_RELEASE);
+	}
+
+	void armAccept()
+	{
+		io_uring_sqe* sqe = getSqe(OP_ACCEPT);
+		sqe->opcode = IORING_OP_ACCEPT;
+		sqe->fd = listenFd;
+		sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+		sqe->accept_flags = SOCK_CLOEXEC;
+	}
+
+	// recv multishot: sin buffer propio, el núcleo toma uno del grupo
+	void armRecv(SOCKET fd, unsigned long long userData)
+	{
+		io_uring_sqe* sqe = getSqe(userData);
+		sqe->opcode = IORING_OP_RECV;
+		sqe->fd = fd;
+		sqe->ioprio = IORING_RECV_MULTISHOT;
+		sqe->flags = IOSQE_BUFFER_SELECT;
+		sqe->buf_group = URING_BUFFER_GROUP;
+	}
+
+	// El eventfd del buzón es bloqueante: el read queda pendiente en el
+	// núcleo hasta que otro bucle deja algo
+	void armInbox()
+	{
+		io_uring_sqe* sqe = getSqe(OP_INBOX);
+		sqe->opcode = IORING_OP_READ;
+		sqe->fd = inbox.fd();
+		sqe->addr = (unsigned long long)&inboxCount;
+		sqe->len = sizeof(inboxCount);
+	}
+
+	void armTick()
+	{
+		io_uring_sqe* sqe = getSqe(OP_TICK);
+		sqe->opcode = IORING_OP_TIMEOUT;
+		sqe->addr = (unsigned long long)&nextTick;
+		sqe->len = 1;
+		sqe->timeout_flags = IORING_TIMEOUT_ABS;
+	}
+
+	void sendPending(UringConnection* conn)
+	{
+		io_uring_sqe* sqe = getSqe((unsigned long long)conn | OP_SEND);
+		sqe->opcode = IORING_OP_SEND;
+		sqe->fd = conn->fd;
+		sqe->addr = (unsigned long long)(conn->sending.data() + conn->sent);
+		sqe->len = (unsigned)(conn->sending.size() - conn->sent);
+
+		// MSG_WAITALL: el núcleo reintenta los envíos parciales
+		sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+		conn->sendInFlight = true;
+	}
+
+	// Los envíos se agrupan: se preparan al final de la vuelta
+	void scheduleSend(UringConnection* conn)
+	{
+		if (!conn->sendScheduled && !conn->closed)
+		{
+			conn->sendScheduled = true;
+			toSend.push_back(conn);
+		}
+	}
+
+	// JUNTAR LO PENDIENTE EN UN SOLO SEND (si no hay otro en curso)
+	void startSend(UringConnection* conn)
+	{
+		if (conn->closed || conn->sendInFlight)
+		{
+			return;
+		}
+		conn->sending.clear();
+		conn->sent = 0;
+		const char* data;
+		size_t length;
+		while (conn->sending.size() < URING_SEND_CHUNK && conn->outbound.peek(data, length))
+		{
+			size_t n = min(length, URING_SEND_CHUNK - conn->sending.size());
+			conn->sending.append(data, n);
+			conn->outbound.consume(n);
+		}
+		if (!conn->sending.empty())
+		{
+			sendPending(conn);
+		}
+	}
+
+	void closeConnection(UringConnection* conn)
+	{
+		if (conn->closed)
+		{
+			return;
+		}
+		logClientDisconnected(conn->fd);
+		traceDisconnected(conn->fd);
+		connections.erase(conn->fd);
+		if (conn->heldSequence != 0)
+		{
+			holding.erase(find(holding.begin(), holding.end(), conn));
+		}
+		conn->closed = true;
+
+		// shutdown termina el recv multishot y el send en curso; la
+		// conexión se libera cuando llegan sus últimos resultados
+		if (conn->recvArmed)
+		{
+			io_uring_sqe* sqe = getSqe(OP_CANCEL);
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->addr = (unsigned long long)conn | OP_RECV;
+		}
+		shutdown(conn->fd, SHUT_RDWR);
+		closesocket(conn->fd);
+	}
+
+	// Se libera al final de la vuelta: puede quedar algún resultado del
+	// lote actual que apunte a esta conexión
+	void releaseIfDone(UringConnection* conn)
+	{
+		if (conn->closed && !conn->recvArmed && !conn->sendInFlight)
+		{
+			toDelete.push_back(conn);
+		}
+	}
+
+	// bounded = false para un snapshot, que puede superar MAX_PENDING_OUTPUT
+	void queueSend(UringConnection* conn, const char* data, size_t len, bool bounded = true)
+	{
+		if (conn->closed)
+		{
+			return;
+		}
+		if (!conn->outbound.pushOwn(data, len, bounded))
+		{
+			logWarning(conn->fd, "no consume sus mensajes, se desconecta");
+			closeConnection(conn);
+			return;
+		}
+		scheduleSend(conn);
+	}
+
+	// ENCOLAR UN LOTE PARA TODOS EXCEPTO EL ORIGEN
+	// El lote se codifica una vez y todas las colas comparten el mismo payload
+	void broadcast(const PayloadPtr& payload)
+	{
+		targets.clear();
+		for (auto& entry : connections)
+		{
+			if (entry.second->id != payload->origin)
+			{
+				targets.push_back(entry.second);
+			}
+		}
+		for (UringConnection* conn : targets)
+		{
+			if (conn->closed)
+			{
+				continue;
+			}
+			conn->outbound.setMode(conn->framer.mode());
+			if (!conn->outbound.pushUpdates(payload))
+			{
+				logWarning(conn->fd, "no consume sus mensajes, se desconecta");
+				closeConnection(conn);
+				continue;
+			}
+			scheduleSend(conn);
+		}
+	}
+
+	void handleAccept(const io_uring_cqe& cqe)
+	{
+		// Sin IORING_CQE_F_MORE el accept multishot terminó: se rearma
+		if (!(cqe.flags & IORING_CQE_F_MORE))
+		{
+			armAccept();
+		}
+		if (cqe.res < 0)
+		{
+			cerr << "✗ Error en accept\n";
+			return;
+		}
+
+		SOCKET fd = cqe.res;
+		setNoDelay(fd);
+
+		UringConnection* conn = new UringConnection();
+		conn->fd = fd;
+		conn->id = newConnectionId();
+		conn->heldSequence = 0;
+		conn->sent = 0;
+		conn->recvArmed = true;
+		conn->recvPaused = false;
+		conn->sendInFlight = false;
+		conn->sendScheduled = false;
+		conn->closed = false;
+		armRecv(fd, (unsigned long long)conn | OP_RECV);
+
+		connections[fd] = conn;
+		logClientConnected(fd);
+		traceConnected(fd);
+	}
+
+	// Copia al framer lo recibido en un buffer del anillo y procesa los
+	// mensajes completos
+	// Un recv multishot entrega en una vuelta todo lo que el cliente tenga
+	// en el socket, y las respuestas salen al final de la vuelta: sin esta
+	// pausa un cliente que encadena solicitudes sin leer acumula más de
+	// MAX_PENDING_OUTPUT y se le desconecta. En pausa el recv se cancela y
+	// lo demás queda en el socket (el cliente nota la contrapresión de TCP)
+	void pauseRecv(UringConnection* conn)
+	{
+		conn->recvPaused = true;
+		if (conn->recvArmed)
+		{
+			io_uring_sqe* sqe = getSqe(OP_CANCEL);
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->addr = (unsigned long long)conn | OP_RECV;
+		}
+	}
+
+	// Tras un send: si ya bajó la salida, se procesa lo que llegó durante
+	// la pausa y se vuelve a leer
+	void resumeRecv(UringConnection* conn)
+	{
+		if (conn->outbound.pendingBytes() > URING_PAUSE_OUTPUT / 2)
+		{
+			return;
+		}
+		conn->recvPaused = false;
+		string pending;
+		pending.swap(conn->stalled);
+		handleReceived(conn, pending.data(), pending.size());
+		if (!conn->recvArmed && !conn->recvPaused && !conn->closed)
+		{
+			armRecv(conn->fd, (unsigned long long)conn | OP_RECV);
+			conn->recvArmed = true;
+		}
+	}
+
+	void handleReceived(UringConnection* conn, const char* data, size_t length)
+	{
+		while (length > 0 && !conn->closed)
+		{
+			if (conn->recvPaused)
+			{
+				conn->stalled.append(data, length);
+				return;
+			}
+			size_t room = conn->framer.writable();
+			if (room == 0)
+			{
+				logWarning(conn->fd, "envio un mensaje demasiado largo");
+				closeConnection(conn);
+				return;
+			}
+			size_t n = min(room, length);
+			memcpy(conn->framer.writePtr(), data, n);
+			conn->framer.commit(n);
+			data += n;
+			length -= n;
+			processMessages(conn);
+			if (!conn->recvPaused && conn->outbound.pendingBytes() > URING_PAUSE_OUTPUT)
+			{
+				pauseRecv(conn);
+			}
+		}
+	}
+
+	void processMessages(UringConnection* conn)
+	{
+		long long receivedAt = traceClock();
+
+		// Un recv puede traer varios mensajes: se validan todos, se aplican
+		// con un solo lock y las respuestas salen en un solo send
+		batch.clear();
+		char* buffer;
+		size_t length;
+		while (conn->framer.next(buffer, length))
+		{
+			traceMessage(conn->fd, receivedAt, conn->framer.mode() == FRAME_BINARY, buffer, length);
+			batch.requests.emplace_back();
+			if (conn->framer.mode() == FRAME_BINARY)
+			{
+				parseBinaryRequest(buffer, batch.requests.back());
+			}
+			else
+			{
+				parseRequest(buffer, batch.requests.back());
+			}
+		}
+
+		if (!batch.requests.empty())
+		{
+			// Los cambios del lote se publican al aplicarlo (ver loop_inbox.h)
+			batch.origin = conn->id;
+			applyBatch(batch);
+
+			output.clear();
+			bool subscribed = false;
+			for (size_t i = 0; i < batch.responses.size(); ++i)
+			{
+				if (batch.responses[i] == nullptr)
+				{
+					// SUSCRIBIR: el snapshot cubre todo evento hasta su
+					// secuencia. Lo publicado después, también por otros
+					// bucles, se difunde desde el buzón (deliverInbox, más
+					// abajo) ya con "EV:" y en orden; un EV anterior que
+					// llegue después, el cliente lo ignora
+					buildSubscription(batch.requests[i].resumeFrom, conn->framer.mode(), output);
+					conn->outbound.setSequenced(true);
+					subscribed = true;
+					continue;
+				}
+				encodeResponse(conn->framer.mode(), batch, i, output);
+			}
+			sendWhenDurable(conn, subscribed);
+
+			// Lo que este hilo publicó quedó en su buzón sin aviso
+			deliverInbox();
+		}
+
+		if (!conn->closed && conn->framer.hasError())
+		{
+			logWarning(conn->fd, "envio un mensaje demasiado largo");
+			closeConnection(conn);
+		}
+	}
+
+	void handleRecv(UringConnection* conn, const io_uring_cqe& cqe)
+	{
+		if (!(cqe.flags & IORING_CQE_F_MORE))
+		{
+			conn->recvArmed = false;
+		}
+		if (cqe.flags & IORING_CQE_F_BUFFER)
+		{
+			unsigned short bid = (unsigned short)(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+			if (cqe.res > 0 && !conn->closed)
+			{
+				handleReceived(conn, buffers + (size_t)bid * URING_BUFFER_SIZE, (size_t)cqe.res);
+			}
+			recycleBuffer(bid);
+		}
+
+		// 0 = el cliente cerró; ENOBUFS = no quedaban buffers en el anillo
+		// (los datos siguen en el socket y basta con rearmar); ECANCELED =
+		// pauseRecv
+		if (cqe.res == 0 || (cqe.res < 0 && cqe.res != -ENOBUFS && cqe.res != -ECANCELED))
+		{
+			closeConnection(conn);
+		}
+		if (!conn->recvArmed && !conn->recvPaused && !conn->closed)
+		{
+			armRecv(conn->fd, (unsigned long long)conn | OP_RECV);
+			conn->recvArmed = true;
+		}
+		releaseIfDone(conn);
+	}
+
+	void handleSend(UringConnection* conn, const io_uring_cqe& cqe)
+	{
+		conn->sendInFlight = false;
+		if (cqe.res <= 0)
+		{
+			closeConnection(conn);
+		}
+		else if (!conn->closed)
+		{
+			conn->sent += (size_t)cqe.res;
+			if (conn->sent < conn->sending.size())
+			{
+				sendPending(conn);
+			}
+			else
+			{
+				scheduleSend(conn);
+			}
+			if (conn->recvPaused)
+			{
+				resumeRecv(conn);
+			}
+		}
+		releaseIfDone(conn);
+	}
+
+	// TICK: una sola trama con el estado final de lo que cambió
+	void handleTick()
+	{
+		PayloadPtr delta = collectDeltaPayload();
+		if (delta)
+		{
+			broadcast(delta);
+			postToOtherLoops(*inboxes, index, delta);
+		}
+
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		advanceTick();
+		if (nextTick.tv_sec < now.tv_sec || (nextTick.tv_sec == now.tv_sec && nextTick.tv_nsec < now.tv_nsec))
+		{
+			nextTick.tv_sec = now.tv_sec;
+			nextTick.tv_nsec = now.tv_nsec;
+			advanceTick();
+		}
+		armTick();
+	}
+
+	void advanceTick()
+	{
+		long long nsec = nextTick.tv_nsec + (long long)tickMs * 1000000LL;
+		nextTick.tv_sec += nsec / 1000000000LL;
+		nextTick.tv_nsec = nsec % 1000000000LL;
+	}
+
+	// --durabilidad evento: las respuestas del lote (output) salen cuando
+	// sus eventos están en disco. Mientras tanto el bucle sigue con otras
+	// conexiones; las respuestas siguientes de esta se retienen detrás, en
+	// orden. Un snapshot sí espera aquí: los EV que el buzón le encole
+	// después no pueden adelantarlo
+	void sendWhenDurable(UringConnection* conn, bool subscribed)
+	{
+		unsigned long long needed = batch.updates.empty() ? 0 : batch.updates.back().sequence;
+		needed = max(needed, conn->heldSequence);
+		WalStatus status = (needed == 0) ? WAL_SAVED : walStatus(needed);
+		if (status == WAL_PENDING && subscribed)
+		{
+			status = walWaitDurable(needed) ? WAL_SAVED : WAL_LOST;
+		}
+
+		if (status == WAL_PENDING)
+		{
+			if (conn->heldSequence == 0)
+			{
+				holding.push_back(conn);
+			}
+			conn->held += output;
+			conn->heldSequence = needed;
+			return;
+		}
+		if (conn->heldSequence != 0)
+		{
+			releaseHeld(conn, status);
+		}
+		if (status == WAL_SAVED)
+		{
+			queueSend(conn, output.data(), output.size(), !subscribed);
+		}
+		else
+		{
+			rejectLost(conn);
+		}
+	}
+
+	// Respuestas que el WAL no guardó: no se confirman (ver ERRORES en wal.h)
+	void rejectLost(UringConnection* conn)
+	{
+		if (conn->closed)
+		{
+			return;
+		}
+		logWarning(conn->fd, "sus cambios no llegaron al WAL, se desconecta");
+		closeConnection(conn);
+	}
+
+	// Envía (o descarta, si se perdieron) las respuestas retenidas
+	void releaseHeld(UringConnection* conn, WalStatus status)
+	{
+		holding.erase(find(holding.begin(), holding.end(), conn));
+		conn->heldSequence = 0;
+		if (status == WAL_SAVED)
+		{
+			queueSend(conn, conn->held.data(), conn->held.size());
+		}
+		else
+		{
+			rejectLost(conn);
+		}
+		conn->held.clear();
+	}
+
+	// Aviso del WAL: sale lo que ya está en disco
+	void releaseDurable()
+	{
+		for (size_t i = 0; i < holding.size();)
+		{
+			UringConnection* conn = holding[i];
+			WalStatus status = walStatus(conn->heldSequence);
+			if (status == WAL_PENDING)
+			{
+				++i;
+				continue;
+			}
+			releaseHeld(conn, status);
+		}
+	}
+
+	// DIFUNDIR A LOS CLIENTES DE ESTE BUCLE LO PUBLICADO, EN ORDEN
+	void deliverInbox()
+	{
+		inbox.take(received);
+		for (const PayloadPtr& payload : received)
+		{
+			broadcast(payload);
+		}
+		received.clear();
+	}
+
+	// Aviso del eventfd: otro hilo dejó algo en el buzón
+	void handleInbox(const io_uring_cqe& cqe)
+	{
+		if (cqe.res < 0)
+		{
+			cerr << "✗ Error al leer el buzon del bucle " << index << "\n";
+			return;
+		}
+		deliverInbox();
+		releaseDurable();
+		armInbox();
+	}
+
+	void handleCompletion(const io_uring_cqe& cqe)
+	{
+		unsigned op = (unsigned)(cqe.user_data & OP_MASK);
+		UringConnection* conn = (UringConnection*)(uintptr_t)(cqe.user_data & ~OP_MASK);
+		switch (op)
+		{
+		case OP_ACCEPT:
+			handleAccept(cqe);
+			break;
+		case OP_RECV:
+			handleRecv(conn, cqe);
+			break;
+		case OP_SEND:
+			handleSend(conn, cqe);
+			break;
+		case OP_TICK:
+			handleTick();
+			break;
+		case OP_INBOX:
+			handleInbox(cqe);
+			break;
+		default:
+			break;      // OP_CANCEL: nada que hacer
+		}
+	}
+
+	// ============================================================================
+	// PRUEBA: recv multishot (Linux 6.0+). En núcleos anteriores la solicitud
+	// falla al prepararse con EINVAL, sin esperar datos. error queda con el
+	// errno del fallo (0 si no hubo resultado)
+	// ============================================================================
+	bool probeMultishotRecv(int& error)
+	{
+		error = 0;
+		int pair[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) != 0)
+		{
+			error = errno;
+			return false;
+		}
+		armRecv(pair[0], OP_PROBE);
+		bool supported = false;
+		bool armed = true;
+		bool wrote = false;
+		if (submit(0) && write(pair[1], "x", 1) == 1)
+		{
+			wrote = true;
+		}
+		while (wrote && armed && submit(1))
+		{
+			unsigned head = *cqHead;
+			while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+			{
+				io_uring_cqe cqe = cqes[head & cqMask];
+				head++;
+				if (cqe.flags & IORING_CQE_F_BUFFER)
+				{
+					recycleBuffer((unsigned short)(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+				}
+				if (cqe.res < 0 && !supported)
+				{
+					error = -cqe.res;
+				}
+				if (cqe.res == 1 && (cqe.flags & IORING_CQE_F_MORE))
+				{
+					// Funciona: se termina la solicitud cerrando el socket
+					supported = true;
+					shutdown(pair[0], SHUT_RDWR);
+				}
+				if (!(cqe.flags & IORING_CQE_F_MORE))
+				{
+					armed = false;
+				}
+			}
+			__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+		}
+		close(pair[0]);
+		close(pair[1]);
+		return supported && !armed;
+	}
+
+	// Comprueba que el núcleo conoce las operaciones que se usan
+	bool probeOperations()
+	{
+		vector<unsigned char> memory(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+		io_uring_probe* probe = (io_uring_probe*)memory.data();
+		if (ringRegister(ringFd, IORING_REGISTER_PROBE, probe, 256) < 0)
+		{
+			return false;
+		}
+		const unsigned char needed[] = { IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND,
+			IORING_OP_TIMEOUT, IORING_OP_ASYNC_CANCEL, IORING_OP_READ };
+		for (unsigned char op : needed)
+		{
+			if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	UringLoop(size_t loopIndex, const vector<LoopInbox*>* allInboxes)
+		: ringFd(-1), listenFd(INVALID_SOCKET), ringMemory(MAP_FAILED), ringSize(0), sqes((io_uring_sqe*)MAP_FAILED),
+		  sqesSize(0), sqLocalTail(0), bufferRing((io_uring_buf_ring*)MAP_FAILED), bufferRingSize(0),
+		  buffers(nullptr), bufferTail(0), bufferRingRegistered(false), tickMs(0),
+		  index(loopIndex), inboxes(allInboxes), inboxCount(0)
+	{
+		batch.deferDurable = true;
+	}
+
+	~UringLoop()
+	{
+		for (auto& entry : connections)
+		{
+			closesocket(entry.first);
+			delete entry.second;
+		}
+		if (bufferRingRegistered)
+		{
+			io_uring_buf_reg reg;
+			memset(&reg, 0, sizeof(reg));
+			reg.bgid = URING_BUFFER_GROUP;
+			ringRegister(ringFd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+		}
+		if (bufferRing != MAP_FAILED)
+		{
+			munmap(bufferRing, bufferRingSize);
+		}
+		delete[] buffers;
+		if (sqes != MAP_FAILED)
+		{
+			munmap(sqes, sqesSize);
+		}
+		if (ringMemory != MAP_FAILED)
+		{
+			munmap(ringMemory, ringSize);
+		}
+		if (ringFd != -1)
+		{
+			close(ringFd);
+		}
+	}
+
+	LoopInbox& mailbox()
+	{
+		return inbox;
+	}
+
+	// Desde el hilo que va a llamar a run(): el anillo se crea con
+	// IORING_SETUP_SINGLE_ISSUER y solo ese hilo puede usarlo
+	// RETORNA: false (con el motivo) si este núcleo no sirve para el motor
+	bool init(string& reason)
+	{
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN
+			| IORING_SETUP_SINGLE_ISSUER;
+		params.cq_entries = URING_CQ_ENTRIES;
+		ringFd = ringSetup(URING_ENTRIES, &params);
+		if (ringFd < 0)
+		{
+			reason = string("io_uring_setup: ") + strerror(errno);
+			return false;
+		}
+		if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP))
+		{
+			reason = "nucleo demasiado antiguo";
+			return false;
+		}
+
+		// SQ y CQ comparten un solo mapeo; las SQE van aparte
+		size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		ringSize = max(sqSize, cqSize);
+		ringMemory = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+			IORING_OFF_SQ_RING);
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		sqes = (io_uring_sqe*)mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+			IORING_OFF_SQES);
+		if (ringMemory == MAP_FAILED || sqes == MAP_FAILED)
+		{
+			reason = string("mmap: ") + strerror(errno);
+			return false;
+		}
+
+		char* base = (char*)ringMemory;
+		sqHead = (unsigned*)(base + params.sq_off.head);
+		sqTail = (unsigned*)(base + params.sq_off.tail);
+		sqMask = *(unsigned*)(base + params.sq_off.ring_mask);
+		sqEntries = params.sq_entries;
+		sqLocalTail = *sqTail;
+		unsigned* sqArray = (unsigned*)(base + params.sq_off.array);
+		for (unsigned i = 0; i < sqEntries; ++i)
+		{
+			sqArray[i] = i;
+		}
+		cqHead = (unsigned*)(base + params.cq_off.head);
+		cqTail = (unsigned*)(base + params.cq_off.tail);
+		cqMask = *(unsigned*)(base + params.cq_off.ring_mask);
+		cqes = (io_uring_cqe*)(base + params.cq_off.cqes);
+
+		if (!probeOperations())
+		{
+			reason = "faltan operaciones (accept/recv/send/timeout)";
+			return false;
+		}
+
+		// ANILLO DE BUFFERS: memoria alineada a página que lee el núcleo
+		bufferRingSize = URING_BUFFER_COUNT * sizeof(io_uring_buf);
+		bufferRing = (io_uring_buf_ring*)mmap(nullptr, bufferRingSize, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (bufferRing == MAP_FAILED)
+		{
+			reason = string("mmap: ") + strerror(errno);
+			return false;
+		}
+		buffers = new char[(size_t)URING_BUFFER_COUNT * URING_BUFFER_SIZE];
+
+		io_uring_buf_reg reg;
+		memset(&reg, 0, sizeof(reg));
+		reg.ring_addr = (unsigned long long)bufferRing;
+		reg.ring_entries = URING_BUFFER_COUNT;
+		reg.bgid = URING_BUFFER_GROUP;
+		if (ringRegister(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+		{
+			reason = string("anillo de buffers: ") + strerror(errno);
+			return false;
+		}
+		bufferRingRegistered = true;
+		for (unsigned i = 0; i < URING_BUFFER_COUNT; ++i)
+		{
+			recycleBuffer((unsigned short)i);
+		}
+
+		int error;
+		if (!probeMultishotRecv(error))
+		{
+			reason = "sin recv multishot";
+			if (error != 0)
+			{
+				reason += string(": ") + strerror(error);
+			}
+			if (error == EINVAL)
+			{
+				reason += " (requiere Linux 6.0)";
+			}
+			return false;
+		}
+		return true;
+	}
+
+	void run(SOCKET listenSocket)
+	{
+		listenFd = listenSocket;
+		inbox.bindToCurrentThread();
+		armAccept();
+		armInbox();
+
+		// Solo el bucle 0 recoge los ticks y los pasa a los demás
+		tickMs = (index == 0) ? broadcastTickMs() : 0;
+		if (tickMs > 0)
+		{
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			nextTick.tv_sec = now.tv_sec;
+			nextTick.tv_nsec = now.tv_nsec;
+			advanceTick();
+			armTick();
+		}
+
+		while (true)
+		{
+			// Una sola llamada: envía lo preparado y espera resultados
+			if (!submit(1))
+			{
+				cerr << "✗ Error en io_uring_enter\n";
+				inbox.close();
+				return;
+			}
+
+			unsigned head = *cqHead;
+			while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+			{
+				io_uring_cqe cqe = cqes[head & cqMask];
+				head++;
+				if ((cqe.user_data & OP_MASK) == OP_ACCEPT && cqe.res == -EINVAL)
+				{
+					cerr << "✗ El nucleo no admite accept multishot\n";
+					inbox.close();
+					return;
+				}
+				handleCompletion(cqe);
+			}
+			__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+			for (UringConnection* conn : toSend)
+			{
+				conn->sendScheduled = false;
+				startSend(conn);
+			}
+			toSend.clear();
+
+			for (UringConnection* conn : toDelete)
+			{
+				delete conn;
+			}
+			toDelete.clear();
+		}
+	}
+};
+
+// ============================================================================
+// ESTRUCTURA: UringStartup
+// PROPÓSITO: Los bucles 1..N-1 se preparan en sus hilos y esperan aquí a
+//            que el principal diga si el servidor arranca. Si uno falla no
+//            arranca ninguno: un bucle que no corre nunca vaciaría su buzón
+// ============================================================================
+struct UringStartup {
+	mutex lock;
+	condition_variable changed;
+	int reported = 0;           // Bucles que ya terminaron de prepararse
+	bool failed = false;
+	bool go = false;
+};
+
+// ============================================================================
+// FUNCIÓN: runUringLoop
+// PROPÓSITO: Hilo de los bucles 1..N-1: su anillo y su socket de escucha
+//            (SO_REUSEPORT) se crean aquí
+// ============================================================================
+static void runUringLoop(UringLoop* loop, const ServerConfig* config, UringStartup* startup)
+{
+	string reason;
+	SOCKET servidor_fd = INVALID_SOCKET;
+	bool ok = loop->init(reason);
+	if (!ok)
+	{
+		cerr << "✗ Error al crear un bucle io_uring: " << reason << "\n";
+	}
+	else
+	{
+		servidor_fd = createListenSocket(config->port, config->backlog, true);
+		if (servidor_fd == INVALID_SOCKET)
+		{
+			cerr << "✗ Error al crear el socket de escucha en el puerto " << config->port << "\n";
+			ok = false;
+		}
+	}
+
+	{
+		unique_lock<mutex> guard(startup->lock);
+		startup->reported++;
+		startup->failed = startup->failed || !ok;
+		startup->changed.notify_all();
+		startup->changed.wait(guard, [startup] { return startup->go || startup->failed; });
+		ok = ok && startup->go;
+	}
+
+	if (ok)
+	{
+		loop->run(servidor_fd);
+	}
+	if (servidor_fd != INVALID_SOCKET)
+	{
+		closesocket(servidor_fd);
+	}
+}
+
+// ============================================================================
+// FUNCIÓN: runUringServer
+// ============================================================================
+int runUringServer(const ServerConfig& config)
+{
+	int loopCount = eventLoopCount(config.loops);
+	vector<LoopInbox*> inboxes;
+	vector<UringLoop*> loops;
+
+	// Los buzones existen antes de que arranque cualquier bucle
+	bool ok = true;
+	for (int i = 0; i < loopCount; ++i)
+	{
+		loops.push_back(new UringLoop((size_t)i, &inboxes));
+		inboxes.push_back(&loops.back()->mailbox());
+		ok = ok && loops.back()->mailbox().init();
+	}
+
+	// El bucle 0 (en este hilo) decide si io_uring sirve
+	string reason = "eventfd";
+	SOCKET servidor_fd = INVALID_SOCKET;
+	if (ok && loops[0]->init(reason))
+	{
+		servidor_fd = createListenSocket(config.port, config.backlog, loopCount > 1);
+		if (servidor_fd == INVALID_SOCKET)
+		{
+			cerr << "✗ Error al crear el socket de escucha en el puerto " << config.port << "\n";
+			for (UringLoop* loop : loops)
+			{
+				delete loop;
+			}
+			return 1;
+		}
+
+		// Los demás bucles se preparan en sus hilos; si alguno falla, el
+		// servidor no arranca
+		UringStartup startup;
+		vector<thread> threads;
+		for (size_t i = 1; i < loops.size(); ++i)
+		{
+			threads.emplace_back(runUringLoop, loops[i], &config, &startup);
+		}
+		bool started;
+		{
+			unique_lock<mutex> guard(startup.lock);
+			startup.changed.wait(guard, [&] { return startup.reported == loopCount - 1 || startup.failed; });
+			started = !startup.failed;
+			startup.go = started;
+			startup.changed.notify_all();
+		}
+		if (!started)
+		{
+			cerr << "✗ No arrancaron todos los bucles io_uring (--bucles " << loopCount << ")\n";
+			for (thread& worker : threads)
+			{
+				worker.join();
+			}
+			closesocket(servidor_fd);
+			for (UringLoop* loop : loops)
+			{
+				delete loop;
+			}
+			return 1;
+		}
+
+		if (loopCount == 1)
+		{
+			cout << "[*] Motor: io_uring (un hilo, accept y recv multishot)\n";
+		}
+		else
+		{
+			cout << "[*] Motor: io_uring (" << loopCount << " bucles, cada uno con su socket de escucha)\n";
+		}
+		cout << "[*] Esperando conexiones...\n";
+		cout << "========================================================\n\n";
+
+		// Sin ticks, cada lote aplicado se publica en todos los buzones
+		if (broadcastTickMs() == 0)
+		{
+			setEventPublisher(publishToLoops, &inboxes);
+		}
+		setWalListener(wakeLoops, &inboxes);
+
+		loops[0]->run(servidor_fd);
+		for (thread& worker : threads)
+		{
+			worker.join();
+		}
+		setEventPublisher(nullptr, nullptr);
+		setWalListener(nullptr, nullptr);
+		closesocket(servidor_fd);
+	}
+
+	for (UringLoop* loop : loops)
+	{
+		delete loop;
+	}
+	if (servidor_fd != INVALID_SOCKET)
+	{
+		return 1;
+	}
+
+	// RESPALDO: mismo protocolo y mismas opciones con el motor epoll
+	cerr << "⚠ io_uring no disponible (" << reason << "): se usa epoll\n";
+	return runEpollServer(config);
+}
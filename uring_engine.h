@@ -0,0 +1,33 @@
+// ============================================================================
+// ARCHIVO: uring_engine.h
+// PROPÓSITO: Motor del servidor basado en io_uring (solo Linux)
+// DESCRIPCIÓN: Como en el motor epoll, cada bucle atiende sus sockets en un
+//              solo hilo, pero sin una llamada al sistema por cada
+//              accept/recv/send: las operaciones se dejan en la cola de
+//              envío (SQ) compartida con el núcleo y los resultados llegan
+//              por la cola de terminación (CQ). Cada vuelta del bucle hace
+//              UNA sola llamada (io_uring_enter) que envía lo preparado y
+//              espera resultados.
+//
+// OPERACIONES:
+//   - accept multishot: una sola solicitud por bucle acepta todas sus
+//     conexiones
+//   - recv multishot con un anillo de buffers: una solicitud por conexión
+//     mientras viva; el núcleo elige el buffer al llegar los datos y este
+//     vuelve al anillo en cuanto se procesa
+//   - send: uno en curso por conexión, con todo lo pendiente agrupado
+//
+// RESPALDO: Si el núcleo no tiene io_uring (o no admite recv multishot,
+//   Linux 6.0+) o está deshabilitado, se avisa y se usa el motor epoll.
+//   Se usan las llamadas al sistema directamente: no depende de liburing.
+// ============================================================================
+
+#ifndef URING_ENGINE_H
+#define URING_ENGINE_H
+
+#include "server_config.h"
+
+// Retorna el código de salida del proceso (0 = ok)
+int runUringServer(const ServerConfig& config);
+
+#endif
@@ -0,0 +1,369 @@
+#include "wal.h"
+#include "parking_protocol.h"
+#include "plate_codec.h"
+#include "parking_lib.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>        // Para _commit, _fileno
+#else
+#include <fcntl.h>
+#include <unistd.h>    // Para fsync, fdatasync
+#endif
+
+using namespace std;
+
+static atomic<bool> running(false);
+static thread flusherThread;
+static FILE* file = nullptr;
+static WalDurability durability = WAL_DURABILITY_BATCHED;
+static int flushIntervalMs = DEFAULT_WAL_INTERVAL_MS;
+static size_t flushBatchRecords = DEFAULT_WAL_BATCH_EVENTS;
+
+// Registros codificados que aún no se escribieron. walAppend añade aquí y
+// el hilo de fondo se lleva el buffer entero (lo cambia por uno vacío)
+static mutex walMutex;
+static condition_variable flushWake;     // Despierta al hilo de fondo
+static condition_variable durableWake;   // Despierta a walWaitDurable
+static string pending;
+static size_t pendingRecords = 0;
+static unsigned long long appendedSequence = 0;   // Último evento en pending
+static unsigned long long durableSequence = 0;    // Último evento en disco
+static bool stopping = false;
+
+// Tras un error de escritura o de fsync ya no se sabe qué quedó en disco:
+// durableSequence no avanza más y walAppend descarta todo lo que llegue
+static atomic<bool> failed(false);
+
+// Avisa a los bucles que retienen respuestas (ver setWalListener)
+static WalListener durableListener = nullptr;
+static void* listenerContext = nullptr;
+
+static atomic<unsigned long long> writtenRecords(0);
+static atomic<unsigned long long> syncCount(0);
+
+bool parseWalDurability(const string& name, WalDurability& level) {
+    if (name == "ninguna") level = WAL_DURABILITY_NONE;
+    else if (name == "lotes") level = WAL_DURABILITY_BATCHED;
+    else if (name == "evento") level = WAL_DURABILITY_EVENT;
+    else return false;
+    return true;
+}
+
+const char* walDurabilityName(WalDurability level) {
+    switch (level) {
+        case WAL_DURABILITY_NONE: return "ninguna";
+        case WAL_DURABILITY_EVENT: return "evento";
+        default: return "lotes";
+    }
+}
+
+// ============================================================================
+// CODIFICACIÓN (ver FORMATO en wal.h)
+// ============================================================================
+static void writeInt(char* out, unsigned long long value, int bytes) {
+    for (int i = 0; i < bytes; i++) out[i] = (char)(value >> (8 * i));
+}
+
+static unsigned long long readInt(const char* in, int bytes) {
+    unsigned long long value = 0;
+    for (int i = 0; i < bytes; i++) value |= (unsigned long long)(unsigned char)in[i] << (8 * i);
+    return value;
+}
+
+static unsigned int checksum(const char* data, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void encodeRecord(const WalRecord& record, char* out) {
+    writeInt(out, record.sequence, 8);
+    out[8] = (char)record.kind;
+    out[9] = out[10] = out[11] = 0;
+    writeInt(out + 12, (unsigned int)record.spot, 4);
+    writeInt(out + 16, record.plateCode, 4);
+    writeInt(out + 20, (unsigned long long)record.entryTime, 8);
+    writeInt(out + 28, checksum(out, 28), 4);
+}
+
+static bool decodeRecord(const char* in, WalRecord& record) {
+    if (checksum(in, 28) != (unsigned int)readInt(in + 28, 4)) return false;
+    record.sequence = readInt(in, 8);
+    record.kind = (unsigned char)in[8];
+    record.spot = (int)(unsigned int)readInt(in + 12, 4);
+    record.plateCode = (unsigned int)readInt(in + 16, 4);
+    record.entryTime = (long long)readInt(in + 20, 8);
+    return record.kind >= WAL_ENTRY && record.kind <= WAL_CAPACITY;
+}
+
+// ============================================================================
+// DISCO: fdatasync basta en Linux (el tamaño del archivo sí se sincroniza)
+// ============================================================================
+static bool writeAll(const string& data) {
+    if (fwrite(data.data(), 1, data.size(), file) != data.size()) return false;
+    return fflush(file) == 0;
+}
+
+static bool syncFile(FILE* target) {
+#if defined(_WIN32)
+    return _commit(_fileno(target)) == 0;
+#elif defined(__linux__)
+    return fdatasync(fileno(target)) == 0;
+#else
+    return fsync(fileno(target)) == 0;
+#endif
+}
+
+// Reemplaza path por tmpPath. En POSIX rename es atómico; el directorio se
+// sincroniza para que el reemplazo también sobreviva a una caída
+static bool replaceFile(const string& tmpPath, const string& path) {
+#ifdef _WIN32
+    return MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) return false;
+    size_t slash = path.rfind('/');
+    string directory = (slash == string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+#endif
+}
+
+// ============================================================================
+// RECUPERACIÓN: cada registro vuelve a entrar como el mensaje de texto que
+// lo produjo, así pasa por la misma validación que cualquier otro
+// ============================================================================
+long long recoverWal(const char* path, string& error) {
+    FILE* input = fopen(path, "rb");
+    if (input == nullptr) return 0;
+
+    char header[WAL_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), input) != sizeof(header) || memcmp(header, WAL_MAGIC, 8) != 0) {
+        fclose(input);
+        error = "no es un archivo WAL";
+        return -1;
+    }
+
+    ParkingBatch batch;
+    char message[MAX_MESSAGE];
+    char plate[PLATE_RECORD_SIZE];
+    char timestamp[32];
+    char encoded[WAL_RECORD_SIZE];
+    WalRecord record;
+    long long applied = 0;
+    long long rejected = 0;
+    size_t length;
+
+    while ((length = fread(encoded, 1, sizeof(encoded), input)) == sizeof(encoded)) {
+        if (!decodeRecord(encoded, record)) break;
+
+        if (record.kind == WAL_CAPACITY) {
+            snprintf(message, sizeof(message), "CAPACIDAD:%d", record.spot);
+        } else {
+            decodePlate(record.plateCode, plate);
+            if (record.kind == WAL_ENTRY && record.entryTime != 0) {
+                ParkingManager::formatTimestamp(record.entryTime, timestamp);
+                snprintf(message, sizeof(message), "%d:%s:%s", record.spot + 1, plate, timestamp);
+            } else {
+                snprintf(message, sizeof(message), "%d:%s", record.spot + 1, plate);
+            }
+        }
+
+        batch.clear();
+        batch.requests.emplace_back();
+        parseRequest(message, batch.requests.back());
+        applyBatch(batch);
+
+        // Una CAPACIDAD que no amplía (el servidor arrancó con más plazas)
+        // no es un error; una entrada o salida que no cambia nada, sí
+        if (batch.updates.empty() && record.kind != WAL_CAPACITY) {
+            rejected++;
+        }
+        applied++;
+    }
+    fclose(input);
+
+    if (length != 0) {
+        cerr << "⚠ WAL: registro incompleto o dañado al final de " << path
+             << " (se descarta desde ahí)\n";
+    }
+    if (rejected > 0) {
+        cerr << "⚠ WAL: " << rejected << " eventos no coinciden con el estado y se ignoraron\n";
+    }
+    return applied;
+}
+
+// ============================================================================
+// HILO DE FONDO: commit en grupo
+// ============================================================================
+static void flusherLoop() {
+    string writing;
+
+    while (true) {
+        unique_lock<mutex> lock(walMutex);
+        if (durability == WAL_DURABILITY_EVENT) {
+            flushWake.wait(lock, [] { return !pending.empty() || stopping; });
+        } else {
+            flushWake.wait_for(lock, chrono::milliseconds(flushIntervalMs),
+                               [] { return pendingRecords >= flushBatchRecords || stopping; });
+        }
+        writing.swap(pending);
+        size_t records = pendingRecords;
+        pendingRecords = 0;
+        unsigned long long upTo = appendedSequence;
+        bool last = stopping;
+        lock.unlock();
+
+        // Escritura y fsync fuera del lock: los eventos que lleguen mientras
+        // tanto se juntan en pending para la vuelta siguiente
+        bool ok = true;
+        if (!writing.empty() && !failed.load(memory_order_relaxed)) {
+            ok = writeAll(writing);
+            if (ok && (durability != WAL_DURABILITY_NONE || last)) {
+                ok = syncFile(file);
+                syncCount.fetch_add(1, memory_order_relaxed);
+            }
+            if (ok) {
+                writtenRecords.fetch_add(records, memory_order_relaxed);
+            } else {
+                cerr << "✗ Error al escribir el WAL: se rechazan los cambios desde ahora\n";
+            }
+        }
+        writing.clear();
+
+        // Si falló, quien espera se despierta sin que su evento esté en
+        // disco (walWaitDurable retorna false)
+        lock.lock();
+        if (ok) {
+            durableSequence = upTo;
+        } else {
+            failed.store(true, memory_order_relaxed);
+        }
+        if (durableListener != nullptr) durableListener(listenerContext);
+        lock.unlock();
+        durableWake.notify_all();
+
+        if (last) break;
+    }
+}
+
+bool startWal(const char* path, WalDurability level, int intervalMs, int batchEvents) {
+    if (running.load()) return true;
+
+    // COMPACTACIÓN: el estado recuperado, en un archivo nuevo
+    vector<WalRecord> records;
+    unsigned long long current = collectParkedVehicles(records);
+
+    string tmpPath = string(path) + ".tmp";
+    FILE* output = fopen(tmpPath.c_str(), "wb");
+    if (output == nullptr) return false;
+
+    string data(WAL_HEADER_SIZE + records.size() * WAL_RECORD_SIZE, '\0');
+    memcpy(&data[0], WAL_MAGIC, 8);
+    writeInt(&data[8], (unsigned long long)time(nullptr), 8);
+    for (size_t i = 0; i < records.size(); i++) {
+        encodeRecord(records[i], &data[WAL_HEADER_SIZE + i * WAL_RECORD_SIZE]);
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), output) == data.size()
+              && fflush(output) == 0 && syncFile(output);
+    fclose(output);
+    if (!ok || !replaceFile(tmpPath, path)) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+    file = fopen(path, "ab");
+    if (file == nullptr) return false;
+
+    durability = level;
+    flushIntervalMs = intervalMs > 0 ? intervalMs : DEFAULT_WAL_INTERVAL_MS;
+    flushBatchRecords = batchEvents > 0 ? (size_t)batchEvents : DEFAULT_WAL_BATCH_EVENTS;
+    pending.reserve(flushBatchRecords * 2 * WAL_RECORD_SIZE);
+    appendedSequence = current;
+    durableSequence = current;
+    stopping = false;
+    failed.store(false, memory_order_relaxed);
+    running.store(true, memory_order_release);
+    flusherThread = thread(flusherLoop);
+    return true;
+}
+
+void stopWal() {
+    if (!running.exchange(false)) return;
+    {
+        lock_guard<mutex> lock(walMutex);
+        stopping = true;
+    }
+    flushWake.notify_one();
+    flusherThread.join();
+    fclose(file);
+    file = nullptr;
+}
+
+void walAppend(const WalRecord& record) {
+    if (!running.load(memory_order_relaxed) || failed.load(memory_order_relaxed)) return;
+    char encoded[WAL_RECORD_SIZE];
+    encodeRecord(record, encoded);
+
+    bool wake;
+    {
+        lock_guard<mutex> lock(walMutex);
+        pending.append(encoded, sizeof(encoded));
+        pendingRecords++;
+        appendedSequence = record.sequence;
+        wake = (durability == WAL_DURABILITY_EVENT && pendingRecords == 1)
+               || pendingRecords == flushBatchRecords;
+    }
+    if (wake) flushWake.notify_one();
+}
+
+bool walWaitDurable(unsigned long long sequence) {
+    if (!running.load(memory_order_acquire) || durability != WAL_DURABILITY_EVENT) return true;
+    unique_lock<mutex> lock(walMutex);
+    durableWake.wait(lock, [sequence] {
+        return durableSequence >= sequence || failed.load(memory_order_relaxed) || stopping;
+    });
+    return durableSequence >= sequence || !failed.load(memory_order_relaxed);
+}
+
+bool walFailed() {
+    return failed.load(memory_order_relaxed);
+}
+
+WalStatus walStatus(unsigned long long sequence) {
+    if (!running.load(memory_order_acquire) || durability != WAL_DURABILITY_EVENT) return WAL_SAVED;
+    lock_guard<mutex> lock(walMutex);
+    if (durableSequence >= sequence) return WAL_SAVED;
+    if (failed.load(memory_order_relaxed)) return WAL_LOST;
+    return stopping ? WAL_SAVED : WAL_PENDING;
+}
+
+void setWalListener(WalListener listener, void* context) {
+    lock_guard<mutex> lock(walMutex);
+    durableListener = listener;
+    listenerContext = context;
+}
+
+unsigned long long walWrittenRecords() {
+    return writtenRecords.load(memory_order_relaxed);
+}
+
+unsigned long long walSyncCount() {
+    return syncCount.load(memory_order_relaxed);
+}
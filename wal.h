@@ -0,0 +1,150 @@
+// ============================================================================
+// ARCHIVO: wal.h
+// PROPÓSITO: Registro de escritura anticipada (WAL) del estado del
+//            parqueadero: sobrevive a caídas y reinicios del servidor
+// DESCRIPCIÓN: Con --wal ARCHIVO cada evento aplicado (entrada, salida o
+//              CAPACIDAD:N) se añade al final del archivo en un registro
+//              binario de tamaño fijo, en orden de secuencia. Al arrancar
+//              se vuelven a aplicar los registros del archivo y se reescribe
+//              compactado (un registro por vehículo estacionado).
+//
+// COMMIT EN GRUPO: Los hilos del servidor solo copian su registro a un
+//   buffer en memoria; un hilo de fondo escribe todo lo acumulado con un
+//   solo write y un solo fsync. Según --durabilidad:
+//     - ninguna: se escribe cada --wal-ms sin fsync (una caída del proceso
+//                no pierde nada ya escrito; una del sistema, sí)
+//     - lotes:   fsync cada --wal-ms o cada --wal-eventos registros, lo que
+//                llegue antes. Se responde sin esperar al disco: una caída
+//                puede perder los últimos ms
+//     - evento:  cada lote responde solo cuando sus eventos están en disco.
+//                Los lotes que llegan mientras el disco trabaja se juntan
+//                en el fsync siguiente, así que no hay un fsync por evento.
+//                Los hilos de hilos y pool esperan (walWaitDurable); los
+//                bucles de epoll y uring no: retienen la respuesta y siguen
+//                (walStatus), y el hilo de fondo los despierta tras cada
+//                fsync (setWalListener)
+//
+// ERRORES: Si falla un write o un fsync, lo que quedó en el archivo es
+//   incierto. Desde ahí no se confirma nada más: los lotes que esperaban
+//   ese fsync y toda entrada, salida o CAPACIDAD posterior responden
+//   ERROR_STORAGE (en epoll y uring, donde la respuesta retenida ya está
+//   codificada, se cierra la conexión), y no se escribe nada más en el
+//   archivo (al reiniciar se recupera hasta el último registro íntegro)
+//
+// FORMATO (little-endian):
+//   Cabecera (16 bytes): "PKWAL001" + hora de creación (i64, segundos
+//                        desde 1970, solo informativa)
+//   Registro (32 bytes):
+//     bytes 0-7    sequence   Número de secuencia del evento (ver
+//                             buildSubscription; la compactación escribe
+//                             la secuencia del momento en que se hizo)
+//     byte  8      kind       WalRecordKind
+//     bytes 9-11   reservado  0
+//     bytes 12-15  spot       Plaza (0..plazas-1). CAPACIDAD: N
+//     bytes 16-19  plateCode  Placa que entra o sale (plate_codec.h)
+//     bytes 20-27  entryTime  Hora de entrada en segundos (0 = sin hora)
+//     bytes 28-31  checksum   FNV-1a de los bytes 0-27
+//   Un registro incompleto o con checksum incorrecto (escritura cortada
+//   por una caída) termina la recuperación: se descarta junto con lo que
+//   le siga.
+// ============================================================================
+
+#ifndef WAL_H
+#define WAL_H
+
+#include <string>
+
+#define WAL_MAGIC "PKWAL001"
+#define WAL_HEADER_SIZE 16
+#define WAL_RECORD_SIZE 32
+
+#define DEFAULT_WAL_INTERVAL_MS 10
+#define DEFAULT_WAL_BATCH_EVENTS 256
+
+enum WalDurability {
+    WAL_DURABILITY_NONE,
+    WAL_DURABILITY_BATCHED,
+    WAL_DURABILITY_EVENT
+};
+
+enum WalStatus {
+    WAL_SAVED,                // En disco, o la durabilidad no espera al disco
+    WAL_PENDING,              // Falta su fsync
+    WAL_LOST                  // El WAL falló antes de guardarlo (ver ERRORES)
+};
+
+enum WalRecordKind {
+    WAL_ENTRY = 1,
+    WAL_EXIT = 2,
+    WAL_CAPACITY = 3
+};
+
+struct WalRecord {
+    unsigned long long sequence;
+    int kind;                 // WalRecordKind
+    int spot;                 // CAPACIDAD: N
+    unsigned int plateCode;
+    long long entryTime;
+};
+
+// "ninguna", "lotes" o "evento"
+bool parseWalDurability(const std::string& name, WalDurability& level);
+const char* walDurabilityName(WalDurability level);
+
+// ============================================================================
+// FUNCIÓN: recoverWal
+// PROPÓSITO: Vuelve a aplicar (con applyBatch) los eventos del archivo
+//            sobre un estado recién creado con initParkingState. Va antes
+//            de startWal y de arrancar los motores
+// RETORNA: Registros aplicados (0 si el archivo no existe), o -1 si el
+//          archivo no es un WAL (error queda con el motivo)
+// ============================================================================
+long long recoverWal(const char* path, std::string& error);
+
+// ============================================================================
+// FUNCIÓN: startWal
+// PROPÓSITO: Reescribe el archivo con el estado actual (a un temporal que
+//            luego lo reemplaza) y arranca el hilo de fondo
+// PARÁMETROS:
+//   - intervalMs: cada cuánto se escribe lo pendiente (ninguna y lotes)
+//   - batchEvents: registros pendientes que adelantan el fsync (lotes)
+// RETORNA: false si no se pudo escribir el archivo
+// ============================================================================
+bool startWal(const char* path, WalDurability level, int intervalMs, int batchEvents);
+
+// Escribe lo pendiente (con fsync, sea cual sea la durabilidad) y cierra
+void stopWal();
+
+// ============================================================================
+// FUNCIONES DEL CAMINO CRÍTICO
+// ============================================================================
+
+// Añade un evento ya numerado. Se llama con el lock del historial tomado,
+// así los registros quedan en orden de secuencia. Sin --wal es una sola
+// lectura atómica
+void walAppend(const WalRecord& record);
+
+// Con durabilidad evento, espera a que el evento sequence (y todos los
+// anteriores) esté en disco. Con las demás retorna enseguida. Se llama sin
+// ningún lock del estado tomado. RETORNA: false si el WAL falló antes de
+// guardarlo
+bool walWaitDurable(unsigned long long sequence);
+
+// true desde el primer error de escritura (ver ERRORES): applyBatch
+// rechaza entonces los cambios sin aplicarlos
+bool walFailed();
+
+// Lo mismo que walWaitDurable, sin esperar
+WalStatus walStatus(unsigned long long sequence);
+
+// listener se llama desde el hilo de fondo tras cada fsync y tras un
+// error, con el lock del WAL tomado: debe ser breve y no llamar al WAL.
+// nullptr lo quita; al retornar ya no se llama al anterior
+typedef void (*WalListener)(void* context);
+void setWalListener(WalListener listener, void* context);
+
+// Registros escritos y fsync hechos desde startWal
+unsigned long long walWrittenRecords();
+unsigned long long walSyncCount();
+
+#endif
@@ -0,0 +1,110 @@
+#include "worker_pool.h"
+
+using namespace std;
+
+// Grupo y cola del hilo actual (nullptr / -1 fuera del grupo)
+static thread_local WorkerPool* currentPool = nullptr;
+static thread_local int currentIndex = -1;
+
+WorkerPool::WorkerPool(int threadCount)
+    : nextQueue(0), pending(0), stopping(false), executed(0), stolen(0) {
+    if (threadCount < 1) {
+        threadCount = (int)thread::hardware_concurrency();
+        if (threadCount < 1) threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        queues.emplace_back(new WorkerQueue());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&WorkerPool::run, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    shutdown();
+}
+
+void WorkerPool::submit(const PoolTask& task) {
+    size_t index = (currentPool == this) ? (size_t)currentIndex
+                                         : nextQueue.fetch_add(1, memory_order_relaxed) % queues.size();
+    {
+        lock_guard<mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(task);
+    }
+    {
+        lock_guard<mutex> guard(idleLock);
+        pending.fetch_add(1, memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+// La propia cola por detrás; si está vacía, robar por delante a los demás
+// empezando por el siguiente (así los ladrones no caen todos sobre el mismo)
+bool WorkerPool::take(int index, PoolTask& task) {
+    {
+        WorkerQueue& own = *queues[(size_t)index];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    int count = (int)queues.size();
+    for (int offset = 1; offset < count; ++offset) {
+        WorkerQueue& victim = *queues[(size_t)((index + offset) % count)];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            stolen.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkerPool::run(int index) {
+    currentPool = this;
+    currentIndex = index;
+
+    PoolTask task;
+    while (true) {
+        if (take(index, task)) {
+            pending.fetch_sub(1, memory_order_relaxed);
+            task.run(task.arg);
+            executed.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+
+        // Sin trabajo: dormir hasta que se encole algo o se pida parar.
+        // Al parar se sale solo con todas las colas vacías
+        unique_lock<mutex> guard(idleLock);
+        wake.wait(guard, [this] { return pending.load(memory_order_relaxed) > 0 || stopping; });
+        if (stopping && pending.load(memory_order_relaxed) == 0) break;
+    }
+}
+
+void WorkerPool::shutdown() {
+    {
+        lock_guard<mutex> guard(idleLock);
+        if (stopping) return;
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : threads) {
+        worker.join();
+    }
+}
+
+int WorkerPool::size() const {
+    return (int)queues.size();
+}
+
+unsigned long long WorkerPool::executedTasks() const {
+    return executed.load(memory_order_relaxed);
+}
+
+unsigned long long WorkerPool::stolenTasks() const {
+    return stolen.load(memory_order_relaxed);
+}
@@ -0,0 +1,75 @@
+// ============================================================================
+// ARCHIVO: worker_pool.h
+// PROPÓSITO: Grupo fijo de hilos con robo de trabajo (work stealing)
+// DESCRIPCIÓN: Cada hilo tiene su propia cola doble de tareas. Saca las
+//              suyas por detrás (la última que encoló sigue caliente en su
+//              caché) y, cuando se queda sin trabajo, roba por delante de
+//              la cola de otro hilo. Las tareas que llegan de fuera del
+//              grupo se reparten por turnos, así que ningún hilo se queda
+//              con todas. Cada cola tiene su propio mutex: se disputa solo
+//              cuando alguien roba.
+//
+// TAREAS: Un puntero a función y su argumento, sin std::function: encolar
+//   no reserva memoria (salvo cuando una cola crece).
+// ============================================================================
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct PoolTask {
+    void (*run)(void* arg);
+    void* arg;
+};
+
+class WorkerPool {
+private:
+    // Alineada a 64 bytes: los mutex de hilos vecinos no comparten línea
+    struct alignas(64) WorkerQueue {
+        std::mutex lock;
+        std::deque<PoolTask> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> nextQueue;
+
+    // Tareas encoladas y aún no tomadas. Sube con idleLock tomado, así un
+    // hilo que se va a dormir no pierde el aviso
+    std::atomic<int> pending;
+    std::mutex idleLock;
+    std::condition_variable wake;
+    bool stopping;
+
+    std::atomic<unsigned long long> executed;
+    std::atomic<unsigned long long> stolen;
+
+    bool take(int index, PoolTask& task);
+    void run(int index);
+
+public:
+    // threads = 0: un hilo por núcleo
+    explicit WorkerPool(int threads = 0);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Desde un hilo del grupo, la tarea va a su propia cola
+    void submit(const PoolTask& task);
+
+    // Ejecuta las tareas pendientes y espera a que terminen los hilos
+    void shutdown();
+
+    int size() const;
+    unsigned long long executedTasks() const;
+    unsigned long long stolenTasks() const;
+};
+
+#endif
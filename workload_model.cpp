@@ -0,0 +1,189 @@
+#include "workload_model.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "plate_codec.h"
+
+// Llegadas por hora relativas (00:00 ... 23:00): casi nada de madrugada,
+// pico al entrar a trabajar, meseta a mediodía y pico al salir. Entre dos
+// horas se interpola linealmente
+static const double HOURLY_ARRIVALS[24] = {
+    0.10, 0.05, 0.05, 0.05, 0.10, 0.30, 0.80, 1.80, 2.40, 1.80, 1.30, 1.20,
+    1.40, 1.30, 1.20, 1.30, 1.60, 1.90, 1.60, 1.00, 0.60, 0.40, 0.30, 0.20
+};
+
+// Placas posibles (AAA000) y salto entre placas consecutivas de la flota:
+// primo con PLATE_SPACE y cercano a PLATE_SPACE / phi, así las placas
+// quedan repartidas por todo el espacio
+static const uint64_t PLATE_SPACE = 26ull * 26 * 26 * 1000;
+static const uint64_t PLATE_STRIDE = 10862567;
+
+// Dispersión del logaritmo de la estancia (lognormal)
+static const double DWELL_SIGMA = 0.8;
+
+// Estancia mínima: nadie entra y sale en el mismo minuto
+static const double MIN_DWELL_SECONDS = 60.0;
+
+static double curveMean() {
+    double sum = 0.0;
+    for (double weight : HOURLY_ARRIVALS) sum += weight;
+    return sum / 24.0;
+}
+
+static double curvePeak() {
+    double peak = 0.0;
+    for (double weight : HOURLY_ARRIVALS) {
+        if (weight > peak) peak = weight;
+    }
+    return peak / curveMean();
+}
+
+// Vehículos dentro, hora por hora, si llega en promedio uno por segundo
+// según la curva y cada uno se queda dwellSeconds en promedio: se integra
+// d(ocupados)/dt = llegadas(t) - ocupados / estancia minuto a minuto
+// durante dos días (el primero solo sirve para olvidar el arranque vacío)
+static void expectedLoad(double dwellSeconds, double* hourly) {
+    double load = 0.0;
+    for (int minute = 0; minute < 2 * 24 * 60; minute++) {
+        double hour = minute / 60.0;
+        load += 60.0 * (WorkloadModel::dayCurve(hour) - load / dwellSeconds);
+        if (load < 0) load = 0;
+        if (minute >= 24 * 60 && minute % 60 == 0) hourly[minute / 60 - 24] = load;
+    }
+}
+
+// Placa número "index" de la flota: índices distintos dan placas distintas
+static uint32_t fleetPlate(uint64_t index, unsigned long long seed) {
+    uint64_t n = (index * PLATE_STRIDE + seed * 2654435761ull) % PLATE_SPACE;
+    uint64_t letters = n / 1000;
+    char text[PLATE_RECORD_SIZE];
+    snprintf(text, sizeof(text), "%c%c%c%03u",
+             (char)('A' + letters / 676), (char)('A' + letters / 26 % 26),
+             (char)('A' + letters % 26), (unsigned)(n % 1000));
+    return encodePlate(text);
+}
+
+void formatCivilTime(long long seconds, char* text) {
+    time_t value = (time_t)seconds;
+    struct tm info;
+#ifdef _WIN32
+    gmtime_s(&info, &value);
+#else
+    gmtime_r(&value, &info);
+#endif
+    strftime(text, 20, "%Y-%m-%d %H:%M:%S", &info);
+}
+
+double WorkloadModel::dayCurve(double hourOfDay) {
+    double hour = fmod(hourOfDay, 24.0);
+    if (hour < 0) hour += 24.0;
+    int current = (int)hour;
+    double fraction = hour - current;
+    double weight = HOURLY_ARRIVALS[current] * (1.0 - fraction) +
+                    HOURLY_ARRIVALS[(current + 1) % 24] * fraction;
+    return weight / curveMean();
+}
+
+template <class T> T WorkloadModel::takeRandom(std::vector<T>& pool) {
+    std::uniform_int_distribution<size_t> pick(0, pool.size() - 1);
+    size_t index = pick(random);
+    T value = pool[index];
+    pool[index] = pool.back();
+    pool.pop_back();
+    return value;
+}
+
+WorkloadModel::WorkloadModel(const WorkloadConfig& config, const std::vector<int>& spots,
+                             unsigned long long seed, int fleetOffset)
+    : config(config), random(seed), freeSpots(spots), nextArrival(0.0),
+      spotCount((int)spots.size()), rejected(0) {
+    int fleet = config.fleetSize > 0 ? config.fleetSize : 2 * spotCount;
+    outside.reserve((size_t)fleet);
+    for (int i = 0; i < fleet; i++) {
+        outside.push_back(fleetPlate((uint64_t)fleetOffset + (uint64_t)i, seed));
+    }
+
+    // La tasa se escala para que el máximo de ocupación esperado del día
+    // sea la ocupación pedida
+    double hourly[24];
+    expectedLoad(config.meanDwellMinutes * 60.0, hourly);
+    double busiest = 0.0;
+    for (double load : hourly) {
+        if (load > busiest) busiest = load;
+    }
+    baseRate = config.occupancy * spotCount / busiest;
+    peakRate = baseRate * curvePeak();
+
+    // Ocupación inicial la esperada a la hora de inicio: cada vehículo
+    // lleva una fracción de su estancia
+    int parked = (int)(baseRate * hourly[config.startHour % 24] + 0.5);
+    if (parked > spotCount) parked = spotCount;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (int i = 0; i < parked && !outside.empty(); i++) {
+        int spot = takeRandom(freeSpots);
+        uint32_t plate = takeRandom(outside);
+        double dwell = sampleDwell();
+        double elapsed = uniform(random) * dwell;
+        departures.push({dwell - elapsed, spot, plate});
+        initial.push_back({-elapsed, spot, plate, true, config.startDate + config.startHour * 3600 - (long long)elapsed});
+    }
+
+    nextArrival = scheduleArrival(0.0);
+}
+
+double WorkloadModel::sampleDwell() {
+    double mean = config.meanDwellMinutes * 60.0;
+    double dwell = mean;
+    if (config.dwell == DWELL_LOGNORMAL) {
+        // Media de la lognormal = exp(mu + sigma^2 / 2)
+        std::lognormal_distribution<double> lognormal(log(mean) - DWELL_SIGMA * DWELL_SIGMA / 2, DWELL_SIGMA);
+        dwell = lognormal(random);
+    } else if (config.dwell == DWELL_EXPONENTIAL) {
+        std::exponential_distribution<double> exponential(1.0 / mean);
+        dwell = exponential(random);
+    }
+    return dwell < MIN_DWELL_SECONDS ? MIN_DWELL_SECONDS : dwell;
+}
+
+// Próxima llegada después de "after": candidatas a la tasa pico, aceptadas
+// con probabilidad curva(hora) / pico
+double WorkloadModel::scheduleArrival(double after) {
+    if (peakRate <= 0) return INFINITY;
+    std::exponential_distribution<double> gap(peakRate);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double peak = curvePeak();
+    double time = after;
+    while (true) {
+        time += gap(random);
+        double hour = config.startHour + time / 3600.0;
+        if (uniform(random) * peak <= dayCurve(hour)) return time;
+    }
+}
+
+WorkloadEvent WorkloadModel::next() {
+    while (true) {
+        // SALIDA: el vehículo cuya estancia termina primero
+        if (!departures.empty() && departures.top().time <= nextArrival) {
+            Departure departure = departures.top();
+            departures.pop();
+            freeSpots.push_back(departure.spot);
+            outside.push_back(departure.plate);
+            return {departure.time, departure.spot, departure.plate, false,
+                    config.startDate + config.startHour * 3600 + (long long)departure.time};
+        }
+
+        // ENTRADA: solo si hay plaza y algún vehículo fuera
+        double time = nextArrival;
+        nextArrival = scheduleArrival(time);
+        if (freeSpots.empty() || outside.empty()) {
+            rejected++;
+            continue;
+        }
+        int spot = takeRandom(freeSpots);
+        uint32_t plate = takeRandom(outside);
+        departures.push({time + sampleDwell(), spot, plate});
+        return {time, spot, plate, true, config.startDate + config.startHour * 3600 + (long long)time};
+    }
+}
@@ -0,0 +1,107 @@
+// ============================================================================
+// ARCHIVO: workload_model.h
+// PROPÓSITO: Modelo de tráfico realista y reproducible para cliente.cpp
+// DESCRIPCIÓN: Simula un parqueadero en tiempo simulado: una flota fija de
+//              placas, llegadas según una curva horaria (picos de mañana y
+//              tarde) y, por cada vehículo que entra, una estancia tomada de
+//              una distribución configurable. Las SALIDAS son de vehículos
+//              realmente estacionados, en el momento en que termina su
+//              estancia. Con la misma semilla produce siempre la misma
+//              secuencia de eventos (y las mismas horas).
+//
+// LLEGADAS: Poisson no homogéneo (método de aceptación/rechazo) con tasa
+//   base * curva(hora). La tasa base se escala para que la ocupación
+//   esperada (ley de Little integrada a lo largo del día) llegue a la pedida
+//   en la hora más llena; de noche el parqueadero se vacía. Si no hay plaza
+//   libre o toda la flota está dentro, la llegada se pierde (se cuenta en
+//   getRejected()).
+//
+// ARRANQUE: El parqueadero empieza con la ocupación que corresponde a la
+//   hora de inicio. initialEntries() devuelve esas entradas (con horas
+//   anteriores al inicio) para enviarlas antes de empezar a medir.
+// ============================================================================
+
+#ifndef WORKLOAD_MODEL_H
+#define WORKLOAD_MODEL_H
+
+#include <stdint.h>
+#include <queue>
+#include <random>
+#include <vector>
+
+enum DwellDistribution {
+    DWELL_LOGNORMAL,      // Muchas estancias cortas y algunas muy largas
+    DWELL_EXPONENTIAL,
+    DWELL_FIXED
+};
+
+struct WorkloadConfig {
+    double occupancy = 0.8;              // Ocupación en la hora pico (0-1)
+    double meanDwellMinutes = 120;       // Estancia media
+    DwellDistribution dwell = DWELL_LOGNORMAL;
+    int fleetSize = 0;                   // Placas de la flota (0 = 2 por plaza)
+    int startHour = 7;                   // Hora del día en el instante 0
+    long long startDate = 1704067200;    // Día simulado (2024-01-01, segundos desde 1970)
+};
+
+struct WorkloadEvent {
+    double time;          // Segundos simulados desde el inicio
+    int spot;             // Plaza 1..N
+    uint32_t plate;       // Código de plate_codec.h
+    bool entry;           // false = SALIDA
+    long long timestamp;  // Hora simulada (segundos desde 1970, hora civil)
+};
+
+class WorkloadModel {
+private:
+    struct Departure {
+        double time;
+        int spot;
+        uint32_t plate;
+        bool operator>(const Departure& other) const { return time > other.time; }
+    };
+
+    WorkloadConfig config;
+    std::mt19937_64 random;
+    std::vector<int> freeSpots;
+    std::vector<uint32_t> outside;       // Placas de la flota fuera del parqueadero
+    std::priority_queue<Departure, std::vector<Departure>, std::greater<Departure> > departures;
+    std::vector<WorkloadEvent> initial;
+    double baseRate;                     // Llegadas por segundo simulado (media del día)
+    double peakRate;                     // Llegadas por segundo en la hora pico
+    double nextArrival;
+    int spotCount;
+    uint64_t rejected;
+
+    double sampleDwell();
+    double scheduleArrival(double after);
+    template <class T> T takeRandom(std::vector<T>& pool);
+
+public:
+    // spots: plazas que maneja este modelo. fleetOffset separa las placas
+    // de varios modelos (una flota distinta por conexión)
+    WorkloadModel(const WorkloadConfig& config, const std::vector<int>& spots,
+                  unsigned long long seed, int fleetOffset);
+
+    // Entradas que dejan el parqueadero en la ocupación inicial (time <= 0)
+    const std::vector<WorkloadEvent>& initialEntries() const { return initial; }
+
+    // Siguiente evento en orden de tiempo
+    WorkloadEvent next();
+
+    // Eventos por segundo simulado en promedio (entradas + salidas)
+    double meanEventRate() const { return 2.0 * baseRate; }
+
+    int getOccupied() const { return spotCount - (int)freeSpots.size(); }
+    int getSpotCount() const { return spotCount; }
+    uint64_t getRejected() const { return rejected; }
+
+    // Multiplicador de la tasa de llegadas a esa hora del día (media 1)
+    static double dayCurve(double hourOfDay);
+};
+
+// "YYYY-MM-DD HH:MM:SS" de una hora civil en segundos desde 1970
+// (text: al menos 20 bytes)
+void formatCivilTime(long long seconds, char* text);
+
+#endif